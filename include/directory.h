@@ -1,76 +0,0 @@
-/**
- *  @file	directory.h
- *  @brief	Manages the directory (or dictionnary) containing linked lists of pointers to \ref ei_widgetclass_t type.
- *
- */
-
-#ifndef _DIRECTORY_H_
-#define _DIRECTORY_H_
-
-#include <stdint.h>
-
-#include "ei_widget.h"
-#include "ei_widgetclass.h"
-
-/*
-    Structure de données représentant un annuaire.
-    Son contenu est détaillé dans directory.c.
-*/
-struct dir {
-	uint32_t array_len;
-	uint32_t contact_number;
-	struct cellule **array;
-};
-
-/*
-    Crée un nouvel annuaire contenant _len_ listes vides.
-*/
-extern struct dir *dir_create(uint32_t len);
-
-/*
-    Insère un nouveau contact dans l'annuaire _dir_, construit à partir des nom et
-    numéro passés en paramètre. Si il existait déjà un contact du même nom, son
-    numéro est remplacé et la fonction retourne une copie de l'ancien numéro.
-    Sinon, la fonction retourne NULL.
-*/
-extern ei_widgetclass_t *dir_insert(struct dir *dir, const char *name, ei_widgetclass_t *wclass_ptr);
-
-/*
-    Retourne le numéro associé au nom _name_ dans l'annuaire _dir_.
-    Si aucun contact ne correspond, retourne NULL.
-*/
-extern ei_widgetclass_t *dir_lookup_num(struct dir *dir, const char *name);
-
-/*
-    Supprime le contact de nom _name_ de l'annuaire _dir_. Si aucun contact ne
-    correspond, ne fait rien.
-*/
-extern void dir_delete(struct dir *dir, const char *name);
-
-/*
-    Libère la mémoire associée à l'annuaire _dir_.
-*/
-extern void dir_free(struct dir *dir);
-
-/*
-    Affiche sur la sortie standard le contenu de l'annuaire _dir_.
-*/
-extern void dir_print(struct dir *dir);
-
-/*
-    Double la taille de l'annuaire _dir_.
-*/
-extern void dir_resize_double(struct dir *dir);
-
-/*
-    Divise la taille de l'annuaire _dir_ en deux.
-*/
-extern void dir_resize_divise(struct dir *dir);
-
-/*
-    Re-remplit l'annuaire _dir_ selon sa nouvelle taille
-    étant donné son ancienne taille _old_len_
-*/
-void dir_resize(struct dir *dir, uint32_t old_len);
-
-#endif /* _DIRECTORY_H_ */
@@ -27,6 +27,11 @@
  *			<li> creates the root widget to access the root window. </li>
  *		</ul>
  *
+ *		The events can be recorded to a file, or replayed from such a file, by setting the
+ *		environment variable EI_RECORD or EI_REPLAY to the name of the file (see \ref ei_record.h).
+ *		The decoded images are kept in the directory named by EI_IMAGE_CACHE_DIR (see
+ *		\ref ei_image_cache_set_directory).
+ *
  * @param	main_window_size	If "fullscreen is false, the size of the root window of the
  *					application.
  *					If "fullscreen" is true, the current monitor resolution is
@@ -80,6 +85,67 @@ ei_widget_t* ei_app_root_widget(void);
  */
 ei_surface_t ei_app_root_surface(void);
 
+/**
+ * \brief	Configures the picking offscreen, a buffer of widget ids owned by the library.
+ *		Must be called after \ref ei_app_create.
+ *
+ * @param	id_bits			16 or 32: size of the stored ids. 0 (the default) uses 16 bits
+ *					as long as there are less than 65536 widgets, 32 bits otherwise.
+ * @param	half_resolution		If true, one id is stored per block of 2x2 pixels (4 times less
+ *					memory). Picks near the border of a widget are then refined
+ *					at full resolution.
+ */
+void ei_app_set_pick_options(int id_bits, ei_bool_t half_resolution);
+
+/**
+ * \brief	A function called at the beginning or at the end of each frame.
+ *
+ * @param	now		The date of the frame, in seconds (see \ref hw_now).
+ * @param	user_param	The parameter given to \ref ei_app_set_frame_callbacks.
+ */
+typedef void	(*ei_frame_callback_t)	(double now, void* user_param);
+
+/**
+ * \brief	Caps the number of frames drawn per second. Invalidated rectangles are accumulated
+ *		between frames. The default is 60.
+ *
+ * @param	max_fps		The maximum number of frames per second, or 0 for no cap (a frame
+ *				is drawn after each batch of events).
+ */
+void ei_app_set_max_fps(int max_fps);
+
+/**
+ * \brief	Sets the functions called at the beginning of each frame (before the invalidated
+ *		rectangles are redrawn, so it can move widgets for an animation) and at its end
+ *		(once the screen is updated).
+ *
+ * @param	begin		Called at the beginning of each frame. May be NULL.
+ * @param	end		Called at the end of each frame. May be NULL.
+ * @param	user_param	Passed to both functions.
+ */
+void ei_app_set_frame_callbacks(ei_frame_callback_t begin, ei_frame_callback_t end, void* user_param);
+
+/**
+ * \brief	Asks for a frame even if nothing is invalidated, e.g. to continue an animation from
+ *		the frame-begin callback. When no frame is requested and nothing is invalidated,
+ *		the application is idle: it waits for the next event without drawing.
+ */
+void ei_app_request_frame(void);
+
+/**
+ * \brief	Starts writing rendering counters to a file, one line per iteration of the main loop:
+ *		event type, invalidated rectangles, redrawn area, widgets visited/drawn/culled,
+ *		pixels written on the window and pick buffer, polygon and text calls, and time spent
+ *		to draw, pick and update the screen (see \ref ei_stats.h). Can also be enabled by
+ *		the environment variable EI_STATS=file.
+ *
+ * @param	filename	The file to create: JSON if its name ends with ".json", CSV otherwise.
+ *				NULL stops the counters and closes the file.
+ *
+ * @return			EI_FALSE if the file could not be created.
+ */
+ei_bool_t ei_app_set_stats(const char* filename);
+
 
 
 
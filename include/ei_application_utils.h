@@ -8,24 +8,70 @@
 #define EI_APPLICATION_UTILS_H
 
 #include "ei_event.h"
+#include "ei_pick.h"
 #include "ei_types.h"
 
 #define max(a, b) (((a) > (b)) ? (a) : (b))
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 
 /**
- * \brief	Sets the pick surface (for global usage)
+ * \brief	Sets the pick buffer (for global usage)
  *
- * @param 	surface
+ * @param 	buffer
  */
-void ei_set_pick_surface(ei_surface_t surface);
+void ei_set_pick_buffer(ei_pick_buffer_t *buffer);
 
 /**
- * \brief 	Returns the pick surface (for global usage)
+ * \brief 	Returns the pick buffer (for global usage)
  *
- * @return 		The pick surface
+ * @return 		The pick buffer
  */
-ei_surface_t ei_get_pick_surface(void);
+ei_pick_buffer_t *ei_get_pick_buffer(void);
+
+/**
+ * \brief	Sets the size of the ids stored in the pick buffer: 16, 32, or 0 to use 16 bits
+ * 		as long as every pick_id is lower than 65536 (the buffer switches to 32 bits otherwise).
+ *
+ * @param 	id_bits
+ */
+void ei_set_pick_id_bits(int id_bits);
+
+/**
+ * \brief	Marks "rect" as out of date in the pick surface. The pick surface is not redrawn
+ * 		immediately: stale areas are accumulated until a pick query lands inside them
+ * 		(see \ref ei_update_pick_surface).
+ *
+ * @param 	rect
+ */
+void ei_invalidate_pick_rect(ei_rect_t rect);
+
+/**
+ * \brief	Redraws the stale area of the pick surface if "where" lies inside it.
+ * 		Must be called before reading the pick surface at "where".
+ *
+ * @param 	where		The location of the pick query, in the root window coordinates.
+ */
+void ei_update_pick_surface(const ei_point_t *where);
+
+/**
+ * \brief	Returns the pick_id of the top-most widget at "where" (0 if none). Updates the pick
+ * 		buffer first. At half resolution, the id is refined at full resolution when "where"
+ * 		is near the border of a widget.
+ *
+ * @param 	where		In the root window coordinates, inside the root window.
+ *
+ * @return 			The pick_id.
+ */
+uint32_t ei_pick_id_at(const ei_point_t *where);
+
+/**
+ * \brief	Sends "event" to the active widget (picked on a button press), or to the default
+ * 		handle function if it is not a located event and the widget did not handle it.
+ * 		The active widget is unset after a button release.
+ *
+ * @param 	event
+ */
+void dispatch_event(ei_event_t *event);
 
 /**
  * \brief 	Returns a boolean which is true if and only if "event" is a located event
@@ -54,18 +100,44 @@ ei_rect_t rect_intersection(ei_rect_t r1, ei_rect_t r2);
  */
 ei_rect_t rect_union(ei_rect_t r1, ei_rect_t r2);
 
+/**
+ * \brief	Tells if the rectangles "r1" and "r2" have the same position and size
+ *
+ * @param 	r1
+ * @param 	r2
+ * @return 		EI_TRUE if "r1" and "r2" are equal
+ */
+ei_bool_t rect_equal(ei_rect_t r1, ei_rect_t r2);
 
 /**
- * \brief 	Draws recursively "widget" and every other widgets beside or below in hierarchy.
- * 		Can be used to draw every widget when used with root widget.
+ * \brief	Returns the rectangle of size "size" placed in "area" according to "anchor" (centered
+ * 		if ei_anc_none). The result overflows "area" if "size" is larger.
+ *
+ * @param 	area
+ * @param 	size
+ * @param 	anchor
+ * @return 		The rectangle
+ */
+ei_rect_t rect_anchored(ei_rect_t area, ei_size_t size, ei_anchor_t anchor);
+
+
+/**
+ * \brief 	Draws "widget" and all its descendants, each child clipped by the content rect of its
+ * 		parent. Can be used to draw every widget when used with root widget. The traversal is
+ * 		iterative: the depth and the width of the tree are not limited by the C stack.
  *
  * @param 	widget
  *
- * @param 	root_window	The root window of the application, returned by \ref ei_app_root_surface
+ * @param 	root_window	The root window of the application, returned by \ref ei_app_root_surface.
+ * 				If NULL, only the pick buffer is drawn.
+ *
+ * @param 	pick_surface	The pick buffer, returned by \ref ei_get_pick_buffer.
+ * 				If NULL, only the root window is drawn.
  *
  * @param 	clipper		See documentation of draw functions
  */
-void draw_widget_recursively(ei_widget_t *widget, ei_surface_t root_window, ei_rect_t *clipper);
+void draw_widget_recursively(ei_widget_t *widget, ei_surface_t root_window, ei_pick_buffer_t *pick_surface,
+			     ei_rect_t *clipper);
 
 /**
  * \brief	Frees the root window
@@ -83,11 +155,4 @@ void free_root_window(ei_surface_t root_window);
  */
 ei_rect_t big_union_rect(ei_linked_rect_t *rectangle_list);
 
-/**
- * \brief	Frees "rectangle_list"
- *
- * @param 	rectangle_list
- */
-void free_rectangle_list(ei_linked_rect_t *rectangle_list);
-
 #endif //EI_APPLICATION_UTILS_H
\ No newline at end of file
@@ -0,0 +1,67 @@
+/**
+ *  @file	ei_arena.h
+ *  @brief	Frame arena: a bump-pointer allocator for the temporaries of a redraw (clippers,
+ *		point lists, side tables, damaged rectangles). Everything is released at once by
+ *		\ref ei_arena_reset, once per iteration of the main loop.
+ *
+ */
+
+#ifndef EI_ARENA_H
+#define EI_ARENA_H
+
+#include <stddef.h>
+
+/**
+ * \brief	A position in the arena, returned by \ref ei_arena_mark.
+ */
+typedef struct ei_arena_mark_t {
+	struct ei_arena_block_t	*block;	///< Block in use when the mark was taken.
+	size_t			used;	///< Bytes used in this block when the mark was taken.
+} ei_arena_mark_t;
+
+/**
+ * \brief	Returns "size" bytes from the arena (aligned on 16 bytes). The memory must not be
+ *		freed: it is valid until the next \ref ei_arena_reset (or \ref ei_arena_rewind to an
+ *		older mark).
+ *
+ * @param 	size
+ *
+ * @return 			The memory, not initialized.
+ */
+void *ei_arena_alloc(size_t size);
+
+/**
+ * \brief	Returns the current position of the arena, to release later the temporaries of
+ *		a single function with \ref ei_arena_rewind.
+ *
+ * @return 			The mark.
+ */
+ei_arena_mark_t ei_arena_mark(void);
+
+/**
+ * \brief	Releases every allocation made since "mark" was taken.
+ *
+ * @param 	mark
+ */
+void ei_arena_rewind(ei_arena_mark_t mark);
+
+/**
+ * \brief	Releases every allocation of the arena. If the arena had to grow during the frame,
+ *		its blocks are merged into one, so that the next frames do not call malloc.
+ */
+void ei_arena_reset(void);
+
+/**
+ * \brief	Returns the number of calls to malloc made by the arena since the beginning of the
+ *		application. Stays constant once the redraws reach a steady state.
+ *
+ * @return 			The number of calls.
+ */
+size_t ei_arena_malloc_count(void);
+
+/**
+ * \brief	Frees the memory of the arena (every allocation becomes invalid).
+ */
+void ei_arena_free(void);
+
+#endif //EI_ARENA_H
@@ -10,7 +10,15 @@
 
 #include <stdint.h>
 #include "ei_types.h"
+#include "ei_image.h"
 
+/**
+ * \brief 	Releases a list of points returned by \ref arc or \ref rounded_frame. Does nothing:
+ * 		the points are allocated in the frame arena (see \ref ei_arena_alloc) and released
+ * 		with it.
+ *
+ * @param 	ptr
+ */
 void free_points(ei_linked_point_t *ptr);
 
 /**
@@ -20,7 +28,7 @@ void free_points(ei_linked_point_t *ptr);
  * @param 	rayon               The ray of the arc.
  * @param 	debut               The beginning angle of the arc.
  * @param 	fin                 The ending angle of the arc.
- * @return			a linked point
+ * @return			a linked point, allocated in the frame arena
  */
 ei_linked_point_t *arc(ei_point_t centre,
 		       float rayon,
@@ -34,7 +42,7 @@ ei_linked_point_t *arc(ei_point_t centre,
  * @param 	rayon       The ray of the corners
  * @param 	top_part    The boolean to know if there is the top part.
  * @param 	bot_part    The boolean to know if there is the bot part.
- * @return			a linked point
+ * @return			a linked point, allocated in the frame arena
  */
 ei_linked_point_t *rounded_frame(ei_rect_t rect,
 				 float rayon,
@@ -55,7 +63,8 @@ ei_linked_point_t *rounded_frame(ei_rect_t rect,
  * @param       button_color    The color of the part inside the button.
  * @param       rayon           The ray of the corners of the button.
  * @param       relief          Relief of the button.
- * @param       pick            Boolean to know if the surface is a pick surface.
+ * @param       img             If not NULL, the image drawn inside the button instead of the text.
+ * @param       img_anchor      Where the image is placed inside the button.
  * @return			nothing
  */
 void draw_button(ei_surface_t surface,
@@ -67,6 +76,7 @@ void draw_button(ei_surface_t surface,
 		 ei_color_t button_color,
 		 float rayon,
 		 ei_relief_t relief,
-		 ei_bool_t pick);
+		 const ei_image_t *img,
+		 ei_anchor_t img_anchor);
 
 #endif //PROJETC_IG_EI_BUTTON_H
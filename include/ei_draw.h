@@ -1,7 +1,8 @@
 /**
  *  @file	ei_draw.h
  *  @brief	Graphical primitives to draw lines, polygons, text, and operation of drawing
- *		surfaces.
+ *		surfaces. Every function accepts a view of a surface (see \ref ei_surface.h) wherever it
+ *		accepts a surface; a view is locked by \ref ei_surface_lock.
  *
  *  \author 
  *  Created by François Bérard on 30.12.11.
@@ -130,6 +131,47 @@ int			ei_copy_surface		(ei_surface_t		destination,
 						 ei_bool_t		alpha);
 
 
+/**
+ * \brief	The filters of \ref ei_copy_surface_scaled.
+ */
+typedef enum {
+	ei_filter_box		= 0,	///< Average of the source pixels covered by each destination pixel
+					///  (the nearest source pixel when enlarging).
+	ei_filter_bilinear		///< Interpolation of the 4 source pixels nearest to the center of each
+					///  destination pixel (the source is first halved when it is more than
+					///  twice as large).
+} ei_filter_t;
+
+/**
+ * \brief	Copies pixels from a source surface to a destination surface, scaled: the source area
+ *		is resampled to the size of the destination area. When both have the same size, this is
+ *		\ref ei_copy_surface.
+ *		Both surfaces must be *locked* by \ref hw_surface_lock.
+ *
+ *		When the source is an image of \ref ei_image_cache_load, the halved levels of the image
+ *		and the last results are kept by the cache: copying again the same area at the same size
+ *		does not resample.
+ *
+ * @param	destination	The surface on which to copy pixels.
+ * @param	dst_rect	If NULL, the entire destination surface is used. If not NULL,
+ *				defines the rectangle on the destination surface where to copy
+ *				the pixels. The pixels outside of the destination surface are not drawn.
+ * @param	source		The surface from which to copy pixels.
+ * @param	src_rect	If NULL, the entire source surface is used. If not NULL, defines the
+ *				rectangle on the source surface from which to copy the pixels. It is
+ *				clipped by the source surface.
+ * @param	filter		The filter used to resample the pixels.
+ * @param	alpha		See \ref ei_copy_surface.
+ *
+ * @return			Returns 0 on success, 1 on failure (empty source or destination area).
+ */
+int			ei_copy_surface_scaled	(ei_surface_t		destination,
+						 const ei_rect_t*	dst_rect,
+						 ei_surface_t		source,
+						 const ei_rect_t*	src_rect,
+						 ei_filter_t		filter,
+						 ei_bool_t		alpha);
+
 
 
 #endif
@@ -28,11 +28,6 @@ typedef struct ei_side_table {
 	struct ei_side **array;
 } ei_side_table;
 
-/**
- * \brief Boolean allowing draw functions to only use mono-colors (no alpha used)
- */
-ei_bool_t is_pick_surface;
-
 /**
  * \brief 	Do the opposite of \ref ei_map_rgba. Converts a 32 bits integer returned by \ref hw_surface_get_buffer
  * 		into the red, green, blue and alpha components.
@@ -63,8 +58,9 @@ ei_bool_t point_in_clipper(int x, int y, const ei_rect_t *clipper);
  * @param 	color
  * @param	clipper
  * @param	alpha		If false, exact copy of color. If true, weighted copy with alpha.
+ * @return			1 if the pixel was written, 0 if it is outside the clipper
  */
-void draw_pixel(ei_surface_t surface, uint32_t *pixel_ptr, int x, int y, ei_color_t *color, const ei_rect_t *clipper, ei_bool_t alpha);
+int draw_pixel(ei_surface_t surface, uint32_t *pixel_ptr, int x, int y, ei_color_t *color, const ei_rect_t *clipper, ei_bool_t alpha);
 
 /**
  * \brief	Add pixels "src_pixel" and "dst_pixel". If alpha is TRUE, weight with pixels' alpha. If alpha is FALSE,
@@ -81,6 +77,18 @@ void draw_pixel(ei_surface_t surface, uint32_t *pixel_ptr, int x, int y, ei_colo
  */
 uint32_t add_pixels(ei_surface_t source, uint32_t *src_pixel, ei_color_t *src_color, ei_surface_t destination, uint32_t *dst_pixel, ei_bool_t alpha);
 
+/**
+ * \brief	Fills a row of pixels: each pixel becomes (pixel & keep) | value. Once the first aligned
+ * 		pixel is reached, the pixels are written with aligned SIMD stores (SSE2, or AVX2 when it is
+ * 		enabled): with the rows of \ref ei_surface_alloc_pixels, there is no first pixel to skip.
+ *
+ * @param	row		The first pixel.
+ * @param	width		The number of pixels.
+ * @param	value		The bits to set. They must be 0 in "keep".
+ * @param	keep		The bits of the pixels that are kept (e.g. the alpha channel), 0 for none.
+ */
+void fill_row(uint32_t *row, int width, uint32_t value, uint32_t keep);
+
 /**
  * \brief       Draw a straight segment.
  *
@@ -92,11 +100,12 @@ uint32_t add_pixels(ei_surface_t source, uint32_t *src_pixel, ei_color_t *src_co
  * @param       y2
  * @param	color		The color used to draw the line. The alpha channel is managed.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ * @return			the number of pixels written (within the clipper)
  */
-void draw_segment_straight(ei_surface_t surface,
-			   int x1, int x2, int y1, int y2,
-			   ei_color_t color,
-			   const ei_rect_t *clipper);
+int draw_segment_straight(ei_surface_t surface,
+			  int x1, int x2, int y1, int y2,
+			  ei_color_t color,
+			  const ei_rect_t *clipper);
 
 /**
  * \brief       Draw a segment using Bresenham algorithm.
@@ -112,20 +121,21 @@ void draw_segment_straight(ei_surface_t surface,
  * @param       swap            0 or 1 ; determines whether x and y coordinates are swapped
  * @param	color		The color used to draw the line. The alpha channel is managed.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ * @return			the number of pixels written (within the clipper)
  */
-void draw_segment_bresenham(ei_surface_t surface,
-			    int x1, int y1, int dx, int dy, int sign_x, int sign_y, int swap,
-			    ei_color_t color,
-			    const ei_rect_t *clipper);
+int draw_segment_bresenham(ei_surface_t surface,
+			   int x1, int y1, int dx, int dy, int sign_x, int sign_y, int swap,
+			   ei_color_t color,
+			   const ei_rect_t *clipper);
 
 /**
  * \brief	Construct the side table of polygon defined by "first_point"
  *
- * @param 	surface
+ * @param 	height		Number of scanlines of the table (sides starting below are ignored)
  * @param 	first_point
  * @return
  */
-ei_side_table construct_side_table(ei_surface_t surface, const ei_linked_point_t *first_point);
+ei_side_table construct_side_table(int height, const ei_linked_point_t *first_point);
 
 /**
  * \brief 	Add "sides" to "*tca"
@@ -166,8 +176,9 @@ void sort_side_table(ei_side *side);
  * @param 	tca
  * @param 	color
  * @param 	clipper
+ * @return			the number of pixels written (within the clipper)
  */
-void draw_scanline(ei_surface_t surface, uint32_t **pixel_ptr, ei_side *tca, int y, ei_color_t color,
+int draw_scanline(ei_surface_t surface, uint32_t **pixel_ptr, ei_side *tca, int y, ei_color_t color,
 		   const ei_rect_t *clipper);
 
 /**
@@ -0,0 +1,115 @@
+/**
+ *  @file	ei_geometry.h
+ *  @brief	Geometry table: the screen_location, content_rect and parent of every widget, stored in
+ *		parallel arrays indexed by the widget's pick_id (see \ref ei_register_widget_id).
+ *
+ *		The layout pass writes the table each time it computes a widget, so that the passes
+ *		which only need rectangles (layout of the children, culling of the redraw) scan
+ *		contiguous arrays instead of following widget pointers across the heap.
+ *
+ */
+
+#ifndef EI_GEOMETRY_H
+#define EI_GEOMETRY_H
+
+#include <stdint.h>
+
+#include "ei_types.h"
+#include "ei_widget.h"
+
+/**
+ * \brief	Flags computed by \ref ei_geometry_cull.
+ */
+typedef enum {
+	ei_geometry_visible		= 1,	///< The screen_location of the widget meets the clipper.
+	ei_geometry_children_visible	= 2	///< The content_rect of the widget meets the clipper.
+} ei_geometry_flag_t;
+
+/**
+ * \brief	Rectangles stored as one array per edge, so that a scan compares whole vectors of
+ *		coordinates at once. The edges "x1" and "y1" are excluded.
+ */
+typedef struct ei_geometry_rects_t {
+	int32_t		*x0;
+	int32_t		*y0;
+	int32_t		*x1;
+	int32_t		*y1;
+} ei_geometry_rects_t;
+
+/**
+ * \brief	The table. Entry 0 (no widget) is a zero rectangle: it is the parent of the root widget.
+ */
+typedef struct ei_geometry_table_t {
+	ei_geometry_rects_t screen;	///< screen_location of each widget.
+	ei_geometry_rects_t content;	///< *content_rect of each widget.
+	uint32_t	*parent;	///< pick_id of the parent of each widget, 0 for the root widget.
+	uint8_t		*flags;		///< Result of the last \ref ei_geometry_cull, see \ref ei_geometry_flag_t.
+	uint32_t	capacity;	///< Number of entries of each array.
+} ei_geometry_table_t;
+
+/**
+ * \brief	Returns the rectangle of entry "id" of "rects".
+ *
+ * @param 	rects
+ * @param 	id
+ *
+ * @return 			The rectangle
+ */
+static inline ei_rect_t ei_geometry_rect(const ei_geometry_rects_t *rects, uint32_t id)
+{
+	ei_rect_t rect = {{rects->x0[id], rects->y0[id]}, {rects->x1[id] - rects->x0[id], rects->y1[id] - rects->y0[id]}};
+	return rect;
+}
+
+/**
+ * \brief	Returns the table (its arrays move when it grows).
+ *
+ * @return 			The table
+ */
+const ei_geometry_table_t *ei_geometry_table(void);
+
+/**
+ * \brief	Grows the table to hold at least "capacity" entries, new entries set to 0.
+ *
+ * @param 	capacity
+ */
+void ei_geometry_reserve(uint32_t capacity);
+
+/**
+ * \brief	Fills the entry of a new widget: its rectangles and the pick_id of its parent.
+ *
+ * @param 	widget
+ */
+void ei_geometry_attach(ei_widget_t *widget);
+
+/**
+ * \brief	Clears the entry of a destroyed widget, so that its id can be given again.
+ *
+ * @param 	id
+ */
+void ei_geometry_release(uint32_t id);
+
+/**
+ * \brief	Copies the screen_location and the content_rect of "widget" to its entry. Called each
+ *		time the layout pass computes the widget.
+ *
+ * @param 	widget
+ */
+void ei_geometry_sync(ei_widget_t *widget);
+
+/**
+ * \brief	Sets the flags of every entry lower than "bound" in one linear scan: whether its
+ *		screen_location and its content_rect meet "clipper". A widget that is not flagged can
+ *		be skipped by a traversal clipped by "clipper" (resp. its children).
+ *
+ * @param 	clipper
+ * @param 	bound		See \ref ei_widget_id_bound.
+ */
+void ei_geometry_cull(const ei_rect_t *clipper, uint32_t bound);
+
+/**
+ * \brief	Frees the table.
+ */
+void ei_geometry_free(void);
+
+#endif //EI_GEOMETRY_H
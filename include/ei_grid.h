@@ -0,0 +1,57 @@
+/**
+ *  @file	ei_grid.h
+ *  @brief	Manages the positionning of the children of a container in rows and columns.
+ *
+ */
+
+#ifndef EI_GRID_H
+#define EI_GRID_H
+
+#include "ei_types.h"
+
+struct ei_widget_t;
+
+/**
+ * \brief	Configures the geometry of a widget using the "grid" geometry manager: the widget is
+ *		put in a cell of a table of rows and columns that fills its parent's *content_rect*,
+ *		from its top-left corner.
+ *
+ *		A widget keeps its requested size. The width of a column is the largest requested
+ *		width of its widgets, and the height of a row the largest requested height of its
+ *		widgets. All the children of a container are laid out at once, before the next frame,
+ *		in a single pass over the requested sizes; only the widgets of the rows and columns
+ *		that changed are moved.
+ *
+ *		If the widget was already managed by the grid, arguments that are not NULL replace
+ *		previous values. A widget that is placed by \ref ei_place leaves the grid. The
+ *		children of a container can not be managed both by the grid and by \ref ei_pack.
+ *
+ * @param	widget		The widget to place.
+ * @param	row		The row of the cell, from 0 (defaults to 0).
+ * @param	column		The column of the cell, from 0 (defaults to 0).
+ * @param	anchor		Where to put the widget in its cell, when the cell is larger than the
+ *				widget (defaults to ei_anc_center).
+ */
+void		ei_grid			(struct ei_widget_t*	widget,
+					 int*			row,
+					 int*			column,
+					 ei_anchor_t*		anchor);
+
+/**
+ * \brief	Configures the grid of a container.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	spacing		Space between two rows and between two columns (defaults to 0).
+ */
+void		ei_grid_configure	(struct ei_widget_t*	container,
+					 int*			spacing);
+
+/**
+ * \brief	Removes a widget from the grid of its parent, and from the screen.
+ *		Note: the widget is not destroyed and still exists in memory.
+ *
+ * @param	widget		The widget to remove from screen.
+ */
+void		ei_grid_forget		(struct ei_widget_t*	widget);
+
+#endif
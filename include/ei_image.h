@@ -0,0 +1,65 @@
+/**
+ *  @file	ei_image.h
+ *  @brief	Images of the frames and buttons. An image is converted once, when the widget is
+ *		configured, to the channel order of the root surface: drawing it is a copy of rows,
+ *		without any conversion.
+ *
+ */
+
+#ifndef EI_IMAGE_H
+#define EI_IMAGE_H
+
+#include <stdint.h>
+
+#include "hw_interface.h"
+#include "ei_types.h"
+
+/**
+ * \brief	A converted image.
+ */
+typedef struct ei_image_t {
+	uint32_t	*pixels;	///< "size.height" rows of "size.width" pixels, in the channel order of the root surface.
+	int		stride;		///< Pixels between two rows (see \ref ei_surface_alloc_pixels).
+	ei_size_t	size;
+	ei_bool_t	opaque;		///< Every pixel is opaque: rows are copied with memcpy, without blending.
+	int		alpha_shift;	///< Position in bits of the alpha of a pixel (the unused byte if the root surface has no alpha).
+	int		shifts[3];	///< Position in bits of the red, green and blue components of a pixel.
+} ei_image_t;
+
+/**
+ * \brief	Converts a part of a surface to the channel order of "target". The surface is not
+ *		used after the call, it can be freed.
+ *
+ * @param	source		The surface of the image, usually returned by \ref hw_image_load, or
+ *				a view (see \ref ei_surface.h).
+ *				It must not be locked.
+ * @param	rect		The part of "source" to convert, or NULL for the whole surface. It is
+ *				clipped by the surface.
+ * @param	target		The surface where the image will be drawn (the root surface).
+ *
+ * @return			The image, to be freed by \ref ei_image_free.
+ */
+ei_image_t *ei_image_create(ei_surface_t source, const ei_rect_t *rect, ei_surface_t target);
+
+/**
+ * \brief	Frees an image. Does nothing if "image" is NULL.
+ *
+ * @param	image
+ */
+void ei_image_free(ei_image_t *image);
+
+/**
+ * \brief	Draws "image" in "area" according to "anchor". The pixels outside of "area" and
+ *		"clipper" are not drawn. Opaque images are copied row by row, the others are blended
+ *		with the surface using their alpha channel.
+ *
+ * @param	surface		The surface given to \ref ei_image_create, *locked* by \ref hw_surface_lock.
+ * @param	image
+ * @param	area		The area of the widget where the image is drawn.
+ * @param	anchor		Where the image is placed in "area".
+ * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void ei_image_draw(ei_surface_t surface, const ei_image_t *image, ei_rect_t area, ei_anchor_t anchor,
+		   const ei_rect_t *clipper);
+
+#endif //EI_IMAGE_H
@@ -0,0 +1,95 @@
+/**
+ *  @file	ei_image_async.h
+ *  @brief	Loading of images on worker threads, so that decoding a large image does not block the
+ *		events and the drawing of the application.
+ *
+ *		The images are decoded in the channel order of the root surface by a pool of threads
+ *		(started by the first request), then added to the cache of \ref ei_image_cache.h on the
+ *		thread of \ref ei_app_run: the callbacks are called there, from the event loop, and can
+ *		configure and invalidate widgets. Requests of the same file are decoded once.
+ *
+ *		During a replay (see \ref ei_record.h), and on Windows, the images are decoded at the
+ *		request, but the callbacks are still called from the event loop.
+ *
+ */
+
+#ifndef EI_IMAGE_ASYNC_H
+#define EI_IMAGE_ASYNC_H
+
+#include "hw_interface.h"
+#include "ei_event.h"
+#include "ei_types.h"
+#include "ei_widget.h"
+
+/**
+ * \brief	The function called when an image of \ref ei_image_load_async is decoded.
+ *
+ * @param	image		The image, referenced in the cache as if returned by
+ *				\ref ei_image_cache_load: it must be released by
+ *				\ref ei_image_cache_release. NULL if the file could not be read.
+ * @param	user_param	The parameter given to \ref ei_image_load_async.
+ */
+typedef void (*ei_image_callback_t)(ei_surface_t image, void *user_param);
+
+/**
+ * \brief	Loads the image "filename" in the channel order of the root surface without blocking:
+ *		"callback" is called from the event loop once the image is decoded (at the next
+ *		iteration if it is already in the cache), never from this function.
+ *
+ * @param	filename	The name of the image file.
+ * @param	callback	The function called with the image.
+ * @param	user_param	Passed to "callback".
+ */
+void ei_image_load_async(const char *filename, ei_image_callback_t callback, void *user_param);
+
+/**
+ * \brief	Cancels the calls of "callback" with "user_param" that are still waiting for an image.
+ *		The images are still decoded and added to the cache.
+ *
+ * @param	callback
+ * @param	user_param
+ */
+void ei_image_cancel_async(ei_image_callback_t callback, void *user_param);
+
+/**
+ * \brief	Configures the image of a frame or a button with the file "filename", loaded by
+ *		\ref ei_image_load_async. Until the image is decoded, the widget shows a placeholder
+ *		(a grey checkerboard of size "placeholder_size"). If the file can not be read, the
+ *		widget is left without image. Configuring the text or the image of the widget, or
+ *		destroying it, cancels the request.
+ *
+ * @param	widget		A frame or a button. Other widgets are ignored.
+ * @param	filename	The name of the image file.
+ * @param	img_rect	See the parameter "img_rect" of \ref ei_frame_configure, or NULL. It is
+ *				copied.
+ * @param	placeholder_size The size of the placeholder, usually the expected size of the image.
+ */
+void ei_widget_set_image_async(ei_widget_t *widget, const char *filename, const ei_rect_t *img_rect,
+			       ei_size_t placeholder_size);
+
+/**
+ * \brief	Cancels the image requested for "widget" by \ref ei_widget_set_image_async, if any.
+ *		Called when the image or the text of a frame or a button is configured, and when it is
+ *		released.
+ *
+ * @param	widget
+ */
+void ei_widget_cancel_image_async(ei_widget_t *widget);
+
+/**
+ * \brief	Calls the callbacks of the decoded images if "event" is the event posted by the worker
+ *		threads. Called by \ref ei_app_run.
+ *
+ * @param	event
+ *
+ * @return			EI_TRUE if the event was handled: it must not be given to the widgets.
+ */
+ei_bool_t ei_image_async_dispatch(const ei_event_t *event);
+
+/**
+ * \brief	Stops the worker threads and frees the requests that were not delivered (their
+ *		callbacks are not called). Called by \ref ei_app_free.
+ */
+void ei_image_async_free(void);
+
+#endif //EI_IMAGE_ASYNC_H
@@ -0,0 +1,170 @@
+/**
+ *  @file	ei_image_cache.h
+ *  @brief	Cache of the images read from files. An image file is decoded once for every channel
+ *		order: the windows that show the same file share its surface.
+ *
+ *		The images are counted by reference. An image that is no longer referenced stays in
+ *		the cache, and is freed only when the memory used by the cache exceeds its budget,
+ *		least recently released first.
+ *
+ *		The decoded images can also be kept on disk for the next runs of the application, see
+ *		\ref ei_image_cache_set_directory.
+ *
+ */
+
+#ifndef EI_IMAGE_CACHE_H
+#define EI_IMAGE_CACHE_H
+
+#include <stddef.h>
+
+#include <stdint.h>
+
+#include "hw_interface.h"
+#include "ei_draw.h"
+#include "ei_types.h"
+
+#define EI_IMAGE_CACHE_DEFAULT_BUDGET	((size_t) 64 << 20)	///< The default budget of the cache, in bytes.
+
+/**
+ * \brief	Counters of the cache, see \ref ei_image_cache_get_stats.
+ */
+typedef struct {
+	unsigned long	hits;		///< Loads that returned an image of the cache.
+	unsigned long	misses;		///< Loads of an image that was not in the cache.
+	unsigned long	disk_hits;	///< Misses read from the cache directory instead of decoding the file.
+	unsigned long	evictions;	///< Unreferenced images freed to stay within the budget.
+	int		images;		///< Images in the cache, referenced or not.
+	int		referenced;	///< Images in use (not yet released).
+	size_t		bytes;		///< Memory used by the pixels of the images in the cache, with their
+					///  halved levels and resampled areas (see \ref ei_image_cache_scaled).
+	size_t		budget;		///< See \ref ei_image_cache_set_budget.
+} ei_image_cache_stats_t;
+
+/**
+ * \brief	Returns the image read from "filename" with the channel order of "channels", decoded by
+ *		\ref hw_image_load if it is not in the cache. Each call must be followed by a call to
+ *		\ref ei_image_cache_release.
+ *
+ *		The surface is shared: it must not be modified nor freed by \ref hw_surface_free.
+ *
+ * @param	filename	The name of the image file.
+ * @param	channels	A surface that defines the channel order of the image (usually the root
+ *				surface).
+ *
+ * @return			The image, or NULL if the file could not be read.
+ */
+ei_surface_t ei_image_cache_load(const char *filename, ei_surface_t channels);
+
+/**
+ * \brief	Returns the image read from "filename" with the channel order of "channels" if it is in
+ *		the cache, like \ref ei_image_cache_load, but never decodes it.
+ *
+ * @param	filename	The name of the image file.
+ * @param	channels	A surface that defines the channel order of the image.
+ *
+ * @return			The image, to be released by \ref ei_image_cache_release, or NULL if it is
+ *				not in the cache.
+ */
+ei_surface_t ei_image_cache_find(const char *filename, ei_surface_t channels);
+
+/**
+ * \brief	Decodes the image "filename" as \ref ei_image_cache_load does when it is not in the
+ *		cache: reads the cache directory, or decodes the file and stores it in the directory.
+ *		The cache itself is not used, so that the images can be decoded on other threads (see
+ *		\ref ei_image_async.h). The same file must not be decoded by two threads at once.
+ *
+ * @param	filename	The name of the image file.
+ * @param	channels	A surface that defines the channel order of the image.
+ * @param	from_disk	Where to store true if the image was read from the cache directory.
+ *
+ * @return			A new surface, to be given to \ref ei_image_cache_insert, or NULL if
+ *				the file could not be read.
+ */
+ei_surface_t ei_image_cache_decode(const char *filename, ei_surface_t channels, ei_bool_t *from_disk);
+
+/**
+ * \brief	Adds an image of \ref ei_image_cache_decode to the cache. If the image was added in the
+ *		meantime, "surface" is freed and the image of the cache is returned.
+ *
+ * @param	filename	The name of the image file.
+ * @param	channels	The surface given to \ref ei_image_cache_decode.
+ * @param	surface		The surface returned by \ref ei_image_cache_decode, or NULL.
+ * @param	from_disk	See \ref ei_image_cache_decode.
+ *
+ * @return			The image, as returned by \ref ei_image_cache_load, or NULL if "surface"
+ *				is NULL and the image is not in the cache.
+ */
+ei_surface_t ei_image_cache_insert(const char *filename, ei_surface_t channels, ei_surface_t surface,
+				   ei_bool_t from_disk);
+
+/**
+ * \brief	References once more an image returned by \ref ei_image_cache_load, e.g. to share it.
+ *		Unlike \ref ei_image_cache_find, it is not counted as a hit. Each call must be followed
+ *		by a call to \ref ei_image_cache_release. Does nothing if "image" is NULL.
+ *
+ * @param	image
+ */
+void ei_image_cache_retain(ei_surface_t image);
+
+/**
+ * \brief	Releases an image returned by \ref ei_image_cache_load. When it is no longer
+ *		referenced, it stays in the cache until the budget is exceeded. Does nothing if "image"
+ *		is NULL.
+ *
+ * @param	image
+ */
+void ei_image_cache_release(ei_surface_t image);
+
+/**
+ * \brief	Sets the memory that the cache may use before freeing unreferenced images (defaults to
+ *		\ref EI_IMAGE_CACHE_DEFAULT_BUDGET). The referenced images are never freed, they may
+ *		exceed the budget. 0 frees the images as soon as they are released.
+ *
+ * @param	bytes		The budget, in bytes of pixels.
+ */
+void ei_image_cache_set_budget(size_t bytes);
+
+/**
+ * \brief	Sets the directory where the decoded images are kept between two runs of the application
+ *		(see \ref ei_image_disk.h): an image that is not in memory is read from this directory
+ *		if its file did not change since it was stored, without decoding it. Can also be set by
+ *		the environment variable EI_IMAGE_CACHE_DIR, read by \ref ei_app_create.
+ *		Not available on Windows.
+ *
+ * @param	directory	The directory (created if needed), or NULL to decode every image
+ *				(the default).
+ */
+void ei_image_cache_set_directory(const char *directory);
+
+/**
+ * \brief	Returns the counters of the cache, since \ref ei_app_create.
+ *
+ * @param	stats		Filled with the counters.
+ */
+void ei_image_cache_get_stats(ei_image_cache_stats_t *stats);
+
+/**
+ * \brief	Returns the pixels of "area" of an image of the cache, resampled to "size" with "filter"
+ *		(see \ref ei_copy_surface_scaled). The last resampled areas of an image are kept, as well
+ *		as the halved levels of the image used by the bilinear filter: a call with the same
+ *		arguments does not resample again.
+ *
+ * @param	image		An image returned by \ref ei_image_cache_load, *locked* by
+ *				\ref hw_surface_lock.
+ * @param	area		The part of the image, inside the image.
+ * @param	size		The size of the result, at least 1x1.
+ * @param	filter
+ * @param	stride		Where to store the number of pixels between two rows of the result.
+ *
+ * @return			"size.height" rows of "size.width" pixels in the channel order of the
+ *				image, valid until the next call. NULL if "image" is not in the cache.
+ */
+const uint32_t *ei_image_cache_scaled(ei_surface_t image, ei_rect_t area, ei_size_t size, ei_filter_t filter,
+				      int *stride);
+
+/**
+ * \brief	Frees every image of the cache, referenced or not. Called by \ref ei_app_free.
+ */
+void ei_image_cache_free(void);
+
+#endif //EI_IMAGE_CACHE_H
@@ -0,0 +1,53 @@
+/**
+ *  @file	ei_image_disk.h
+ *  @brief	Cache on disk of the decoded images of \ref ei_image_cache.h, so that the next runs of
+ *		an application do not decode them again.
+ *
+ *		A decoded image is stored in a file of the cache directory, named after the hash of the
+ *		absolute path of the image file and the channel order. The file starts with a header
+ *		page: the size and the stride of the pixels, the channel order, the size and the
+ *		modification time (to the nanosecond) of the image file, and its absolute path. The pixels follow, raw and
+ *		aligned on a page, so that the file is mapped in memory and copied row by row to a new
+ *		surface. A file whose header does not match the image file (modified since, or another
+ *		file with the same hash) is ignored, and replaced by the next store.
+ *
+ *		Not available on Windows: the functions do nothing.
+ *
+ */
+
+#ifndef EI_IMAGE_DISK_H
+#define EI_IMAGE_DISK_H
+
+#include "hw_interface.h"
+#include "ei_types.h"
+
+/**
+ * \brief	Sets the directory of the cache (created if needed, but not its parents).
+ *
+ * @param	directory	The directory, or NULL to disable the cache on disk (the default).
+ */
+void ei_image_disk_set_directory(const char *directory);
+
+/**
+ * \brief	Returns a new surface with the decoded image of "filename" in the channel order of
+ *		"channels", read from the cache directory.
+ *
+ * @param	filename	The name of the image file.
+ * @param	channels	A surface that defines the channel order.
+ *
+ * @return			The surface, to be freed by \ref hw_surface_free, or NULL if the image is
+ *				not in the cache directory or the image file changed.
+ */
+ei_surface_t ei_image_disk_load(const char *filename, ei_surface_t channels);
+
+/**
+ * \brief	Writes the decoded image of "filename" to the cache directory. The file is written
+ *		under a temporary name, then renamed: a concurrent load never sees a partial file.
+ *
+ * @param	filename	The name of the image file.
+ * @param	channels	The surface that defined the channel order of "image".
+ * @param	image		The surface returned by \ref hw_image_load. It must not be locked.
+ */
+void ei_image_disk_store(const char *filename, ei_surface_t channels, ei_surface_t image);
+
+#endif //EI_IMAGE_DISK_H
@@ -0,0 +1,138 @@
+/**
+ *  @file	ei_manager_utils.h
+ *  @brief	Storage shared by the geometry managers that lay out all the children of a container
+ *		at once (\ref ei_grid.h and \ref ei_pack.h).
+ *
+ *		The manager of a container keeps one cell per managed child, with the requested size of
+ *		the child when it was last laid out. It runs during the layout pass (see \ref ei_layout_update),
+ *		before the children of the container are placed: it computes the rectangle of the children
+ *		whose row, column or position changed, and gives it to the placer.
+ *
+ */
+
+#ifndef EI_MANAGER_UTILS_H
+#define EI_MANAGER_UTILS_H
+
+#include "ei_types.h"
+#include "ei_widget.h"
+
+/**
+ * \brief	The kinds of manager.
+ */
+typedef enum {
+	ei_manager_grid = 0,		///< Rows and columns, see \ref ei_grid.
+	ei_manager_pack			///< Children stacked in one direction, see \ref ei_pack.
+} ei_manager_kind_t;
+
+/**
+ * \brief	A managed child.
+ */
+typedef struct {
+	ei_widget_t *widget;
+	int row;			///< Grid: row of the cell.
+	int column;			///< Grid: column of the cell.
+	ei_anchor_t anchor;		///< Grid: where the widget is placed in its cell.
+	ei_bool_t fill;			///< Pack: the widget takes the whole width (or height) of the container.
+	ei_size_t measured;		///< Requested size of the widget when it was last laid out.
+	ei_bool_t changed;		///< The cell was added or modified since the last layout.
+} ei_manager_cell_t;
+
+/**
+ * \brief	The manager of a container (field "manager" of the container).
+ */
+typedef struct ei_manager_t {
+	ei_manager_kind_t kind;
+	ei_manager_cell_t *cells;	///< Grid: in any order. Pack: in the packing order.
+	int length;
+	int capacity;
+	int spacing;			///< Space between two rows, columns or packed children.
+	ei_axis_set_t direction;	///< Pack: ei_axis_x to stack from left to right, top to bottom otherwise.
+	ei_bool_t dirty;		///< Some cell changed since the last layout.
+	int first_changed;		///< Pack: index of the first cell to place again.
+	ei_size_t content_size;		///< Size of the content_rect of the container at the last layout.
+	int *column_width;		///< Grid: size and position of the columns and rows at the last layout.
+	int *column_x;
+	int columns;
+	int column_capacity;
+	int *row_height;
+	int *row_y;
+	int rows;
+	int row_capacity;
+} ei_manager_t;
+
+/**
+ * \brief	Returns the manager of "container", created if needed. A container has a single kind of manager.
+ *
+ * @param 	container
+ * @param 	kind
+ *
+ * @return		The manager
+ */
+ei_manager_t *ei_manager_get(ei_widget_t *container, ei_manager_kind_t kind);
+
+/**
+ * \brief	Returns the cell of "widget" in the manager of its parent. The widget is added to the manager
+ * 		if needed (and then no longer placed by \ref ei_place). The cell is marked as changed.
+ *
+ * @param 	widget
+ * @param 	kind
+ *
+ * @return		The cell, valid until the next change of the manager
+ */
+ei_manager_cell_t *ei_manager_attach(ei_widget_t *widget, ei_manager_kind_t kind);
+
+/**
+ * \brief	Removes "widget" from the manager of its parent. Does nothing if it is not managed.
+ *
+ * @param 	widget
+ */
+void ei_manager_detach(ei_widget_t *widget);
+
+/**
+ * \brief	Tells the manager of the parent of "widget" that the widget must be laid out again, for
+ * 		example because its requested size changed. Does nothing if it is not managed.
+ *
+ * @param 	widget
+ */
+void ei_manager_notify(ei_widget_t *widget);
+
+/**
+ * \brief	Marks "manager" as changed: the next layout pass runs it.
+ *
+ * @param 	container	The container of "manager".
+ * @param 	manager
+ */
+void ei_manager_changed(ei_widget_t *container, ei_manager_t *manager);
+
+/**
+ * \brief	Frees the manager of "container", if any. Its children are no longer managed.
+ *
+ * @param 	container
+ */
+void ei_manager_free(ei_widget_t *container);
+
+/**
+ * \brief	Runs the manager of "container" if something changed: called by the layout pass before
+ * 		the children of "container" are placed.
+ *
+ * @param 	container
+ */
+void ei_manager_layout(ei_widget_t *container);
+
+/**
+ * \brief	Lays out the children of a grid container (see \ref ei_grid.c). The cells are placed
+ * 		relatively to the content_rect of the container by the layout pass.
+ *
+ * @param 	manager		The manager of the container.
+ */
+void grid_layout(ei_manager_t *manager);
+
+/**
+ * \brief	Lays out the children of a pack container (see \ref ei_pack.c).
+ *
+ * @param 	container
+ * @param 	manager
+ */
+void pack_layout(ei_widget_t *container, ei_manager_t *manager);
+
+#endif //EI_MANAGER_UTILS_H
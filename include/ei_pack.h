@@ -0,0 +1,56 @@
+/**
+ *  @file	ei_pack.h
+ *  @brief	Manages the positionning of the children of a container stacked in one direction.
+ *
+ */
+
+#ifndef EI_PACK_H
+#define EI_PACK_H
+
+#include "ei_types.h"
+
+struct ei_widget_t;
+
+/**
+ * \brief	Configures the geometry of a widget using the "pack" geometry manager: the widgets
+ *		are stacked in their parent's *content_rect*, from top to bottom (or from left to
+ *		right, see \ref ei_pack_configure), in the order of their first call to this function.
+ *
+ *		A widget keeps its requested size, except across the direction of the stack if it
+ *		fills the container. All the children of a container are laid out at once, before
+ *		the next frame, in a single pass over the requested sizes; only the widgets after
+ *		the first one that changed are moved.
+ *
+ *		If the widget was already packed, arguments that are not NULL replace previous
+ *		values. A widget that is placed by \ref ei_place leaves the stack. The children of a
+ *		container can not be managed both by \ref ei_grid and by the pack.
+ *
+ * @param	widget		The widget to place.
+ * @param	fill		If EI_TRUE, the widget takes the whole width of the container (its
+ *				whole height when stacked from left to right). Defaults to EI_FALSE.
+ */
+void		ei_pack			(struct ei_widget_t*	widget,
+					 ei_bool_t*		fill);
+
+/**
+ * \brief	Configures the stack of a container.
+ *
+ * @param	container	The parent of the packed widgets.
+ * @param	direction	ei_axis_x to stack from left to right, ei_axis_y to stack from top
+ *				to bottom (defaults to ei_axis_y).
+ * @param	spacing		Space between two widgets (defaults to 0).
+ */
+void		ei_pack_configure	(struct ei_widget_t*	container,
+					 ei_axis_set_t*		direction,
+					 int*			spacing);
+
+/**
+ * \brief	Removes a widget from the stack of its parent, and from the screen. The next
+ *		widgets move up (or left).
+ *		Note: the widget is not destroyed and still exists in memory.
+ *
+ * @param	widget		The widget to remove from screen.
+ */
+void		ei_pack_forget		(struct ei_widget_t*	widget);
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ *  @file	ei_pick.h
+ *  @brief	Picking offscreen: a buffer of widget ids, owned by the library, where widgets
+ *		draw their shape with their "pick_id" (see \ref ei_widgetclass_drawfunc_t).
+ *
+ */
+
+#ifndef EI_PICK_H
+#define EI_PICK_H
+
+#include <stdint.h>
+
+#include "ei_types.h"
+
+/**
+ * \brief	A buffer of widget ids. Ids are stored as 16 bits or 32 bits integers, without any
+ *		color conversion. With half resolution, one id is stored per block of 2x2 pixels:
+ *		the id of the top-left pixel of the block.
+ */
+typedef struct ei_pick_buffer_t {
+	ei_rect_t	rect;		///< Area covered by the buffer, in the root window coordinates (full resolution).
+	int		shift;		///< 0 if one id is stored per pixel, 1 if one id is stored per block of 2x2 pixels.
+	int		id_bits;	///< 16 or 32: size of the stored ids.
+	int		stride;		///< Number of ids per row of storage.
+	int		rows;		///< Number of rows of storage.
+	void		*ids;		///< Storage, initialized to 0 (no widget).
+} ei_pick_buffer_t;
+
+/**
+ * \brief	Creates a pick buffer.
+ *
+ * @param 	rect		Area covered by the buffer, in the root window coordinates.
+ * @param 	id_bits		16 or 32. 16 bits buffers can only store ids lower than 65536.
+ * @param 	half_resolution	If true, one id is stored per block of 2x2 pixels.
+ *
+ * @return 			The buffer, to be freed by \ref ei_pick_buffer_free.
+ */
+ei_pick_buffer_t *ei_pick_buffer_create(ei_rect_t rect, int id_bits, ei_bool_t half_resolution);
+
+/**
+ * \brief	Frees a buffer created by \ref ei_pick_buffer_create.
+ *
+ * @param 	buffer
+ */
+void ei_pick_buffer_free(ei_pick_buffer_t *buffer);
+
+/**
+ * \brief	Returns the id stored for the pixel (x, y), or 0 if the pixel is outside the buffer.
+ *
+ * @param 	buffer
+ * @param 	x, y		In the root window coordinates.
+ *
+ * @return			The id.
+ */
+uint32_t ei_pick_buffer_get(const ei_pick_buffer_t *buffer, int x, int y);
+
+/**
+ * \brief	Tells if the id returned by \ref ei_pick_buffer_get for the pixel (x, y) is exact.
+ *		Always true at full resolution. At half resolution, true when the stored samples
+ *		surrounding the pixel all have the same id.
+ *
+ * @param 	buffer
+ * @param 	x, y		In the root window coordinates.
+ *
+ * @return			EI_TRUE if the id is exact.
+ */
+ei_bool_t ei_pick_buffer_is_exact(const ei_pick_buffer_t *buffer, int x, int y);
+
+/**
+ * \brief	Returns the pixels whose stored samples are read by \ref ei_pick_buffer_get and
+ *		\ref ei_pick_buffer_is_exact for the pixel (x, y): the pixel itself at full resolution,
+ *		up to the 3x3 pixels around it at half resolution. They must be up to date before the
+ *		buffer is read at (x, y).
+ *
+ * @param 	buffer
+ * @param 	x, y		In the root window coordinates.
+ *
+ * @return			The area, in the root window coordinates.
+ */
+ei_rect_t ei_pick_buffer_samples_rect(const ei_pick_buffer_t *buffer, int x, int y);
+
+/**
+ * \brief	Writes "id" on the pixels [x_min, x_max[ of the row y. The span must already be
+ *		clipped to the buffer's rect.
+ *
+ * @param 	buffer
+ * @param 	y
+ * @param 	x_min
+ * @param 	x_max
+ * @param 	id
+ */
+void ei_pick_fill_span(ei_pick_buffer_t *buffer, int y, int x_min, int x_max, uint32_t id);
+
+/**
+ * \brief	Writes "id" on every pixel of "rect".
+ *
+ * @param 	buffer
+ * @param 	rect
+ * @param 	id
+ * @param 	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void ei_pick_fill_rect(ei_pick_buffer_t *buffer, const ei_rect_t *rect, uint32_t id, const ei_rect_t *clipper);
+
+/**
+ * \brief	Writes "id" on every pixel of a polygon (same filling rule as \ref ei_draw_polygon).
+ *
+ * @param 	buffer
+ * @param 	first_point	The head of a linked list of the points of the polygon.
+ * @param 	id
+ * @param 	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void ei_pick_fill_polygon(ei_pick_buffer_t *buffer, const ei_linked_point_t *first_point, uint32_t id,
+			  const ei_rect_t *clipper);
+
+/**
+ * \brief	Encodes a pick id as a color (red is the lowest byte), e.g. to display the pick buffer.
+ *
+ * @param 	id
+ *
+ * @return			The color.
+ */
+ei_color_t ei_pick_id_to_color(uint32_t id);
+
+#endif //EI_PICK_H
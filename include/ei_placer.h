@@ -59,6 +59,10 @@ typedef struct ei_placer_params_t {
  * 		If the widget was already managed by the "placer", then this calls simply updates
  *		the placer parameters: arguments that are not NULL replace previous values.
  *
+ *		The geometry is not computed immediately: it is computed for every placed widget at
+ *		once, before the next frame is drawn (see \ref ei_placer_flush). Placing a widget
+ *		several times before a frame costs a single computation.
+ *
  * 		When the arguments are passed as NULL, the placer uses default values (detailed in
  *		the argument descriptions below). If no size is provided (either absolute or
  *		relative), then either the requested size of the widget is used if one was provided,
@@ -116,5 +120,14 @@ void ei_placer_run(struct ei_widget_t* widget);
  */
 void ei_placer_forget(struct ei_widget_t* widget);
 
+/**
+ * \brief	Computes now the geometry of every widget placed since the last frame.
+ *
+ *		\ref ei_place only records the placement parameters: the geometry is computed once
+ *		per frame, before drawing. Call this function to read the "screen_location" of a
+ *		widget right after placing it.
+ */
+void ei_placer_flush(void);
+
 
 #endif
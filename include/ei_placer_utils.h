@@ -27,6 +27,17 @@ struct double_int {
 	int right;
 };
 
+/**
+ * \brief	Flags of the field "layout_flags" of a widget: what the layout pass (see \ref ei_layout_update)
+ * 		must do for this widget and below it.
+ */
+typedef enum {
+	ei_layout_self = 1,		///< The placer parameters changed (\ref ei_place): the geometry must be computed.
+	ei_layout_children = 2,		///< The content_rect of the widget changed: its children must be placed again.
+	ei_layout_descendants = 4,	///< Some descendant has one of the flags above.
+	ei_layout_damaged = 8		///< Set during the pass: the area of the widget (and so of its children) is invalidated.
+} ei_layout_flag_t;
+
 /**
  * \brief 	Initializes the field "placer_params" of "widget" if it is not NULL (allocates its memory).
  *
@@ -41,6 +52,11 @@ void init_placer_params(struct ei_widget_t *widget);
  */
 void forget_placer_params(ei_widget_t *widget);
 
+/**
+ * \brief 	Frees the pool of the placer parameters (every widget must have been forgotten before)
+ */
+void free_placer_slab(void);
+
 /**
  * \brief 	Manages the "anchor" and "anchor_data" fields of "widget->placer_params"
  *
@@ -108,4 +124,51 @@ void manage_height(ei_widget_t *widget, int *height, float *rel_height);
  */
 void manage_screen_location(ei_widget_t *widget);
 
+/**
+ * \brief 	Marks "widget" so that its geometry is computed by the next layout pass, and marks its
+ * 		ancestors so that the pass reaches it.
+ *
+ * @param 	widget
+ */
+void ei_layout_mark(ei_widget_t *widget);
+
+/**
+ * \brief 	Marks "widget" so that the next layout pass places its children again (and runs its grid or
+ * 		pack manager), and marks its ancestors so that the pass reaches it.
+ *
+ * @param 	widget
+ */
+void ei_layout_mark_children(ei_widget_t *widget);
+
+/**
+ * \brief 	Places "widget" at "rect" (relative to the content_rect of its parent), as \ref ei_place
+ * 		with absolute parameters only, but without leaving the manager of its parent. Only used
+ * 		by the managers during the layout pass: the widget is computed by the same pass.
+ * 		Does nothing if the widget is already placed there.
+ *
+ * @param 	widget
+ * @param 	rect
+ */
+void place_in_parent(ei_widget_t *widget, ei_rect_t rect);
+
+/**
+ * \brief 	Tells if some widget is marked for the next layout pass.
+ *
+ * @return		EI_TRUE if \ref ei_layout_update has something to do
+ */
+ei_bool_t ei_layout_is_pending(void);
+
+/**
+ * \brief 	Layout pass, run once per frame before drawing, and before picking: a single top-down
+ * 		traversal of the marked parts of the tree. A widget is computed again if it was placed
+ * 		since the last pass, or if the parent's content_rect it depends on changed: when only the
+ * 		position of the content_rect changed, or when the widget has no relative parameter, the
+ * 		widget and its descendants are translated instead of being computed again.
+ * 		Every widget whose screen_location changed invalidates the union of its old and new
+ * 		locations, within the content_rect of its parent, unless the area of an ancestor was
+ * 		already invalidated (children are drawn within the content_rect of their parent).
+ * 		Does nothing if no widget was marked.
+ */
+void ei_layout_update(void);
+
 #endif //EI_PLACER_UTILS_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+/**
+ *  @file	ei_record.h
+ *  @brief	Recording of the events of a session to a file, and deterministic replay of such a
+ *		file through \ref ei_app_run, with a virtual clock. The replay reports the time spent
+ *		to process each event and to redraw each frame, to compare builds on the same input.
+ *
+ *		The recording and the replay can also be started by the environment variables
+ *		EI_RECORD=file and EI_REPLAY=file, read by \ref ei_app_create.
+ *
+ */
+
+#ifndef EI_RECORD_H
+#define EI_RECORD_H
+
+#include <stdio.h>
+
+#include "ei_event.h"
+#include "ei_types.h"
+
+/**
+ * \brief	Starts recording every event returned by \ref hw_event_wait_next, with its date, to
+ *		"filename". Application events (\ref ei_ev_app) are not recorded: their parameter
+ *		is a pointer. The file is closed by \ref ei_record_stop.
+ *
+ * @param	filename	The file to create.
+ *
+ * @return			EI_FALSE if the file could not be created.
+ */
+ei_bool_t ei_record_start(const char *filename);
+
+/**
+ * \brief	Starts replaying a file created by \ref ei_record_start: \ref ei_app_run receives the
+ *		recorded events instead of the events of the window, as fast as possible, with a virtual
+ *		clock (see \ref ei_now). The application quits one second (virtual) after the last event.
+ *
+ * @param	filename	The file to replay.
+ *
+ * @return			EI_FALSE if the file could not be read.
+ */
+ei_bool_t ei_replay_start(const char *filename);
+
+/**
+ * \brief	Stops the recording or the replay. At the end of a replay, the report is written on
+ *		the standard output (see \ref ei_replay_report). Called by \ref ei_app_free.
+ */
+void ei_record_stop(void);
+
+/**
+ * \brief	Writes the times measured during the replay: for each type of event, the number of
+ *		events and their mean and maximum processing time, then the same for the frames.
+ *
+ * @param	out		Where to write.
+ */
+void ei_replay_report(FILE *out);
+
+/**
+ * \brief	Returns true if a replay is running.
+ *
+ * @return			EI_TRUE during a replay.
+ */
+ei_bool_t ei_replay_is_active(void);
+
+/**
+ * \brief	Adds a measure to the replay report. Does nothing if no replay is running.
+ *
+ * @param	type		The type of the processed event, or \ref ei_ev_last for a frame.
+ * @param	seconds		The time spent.
+ */
+void ei_replay_account(ei_eventtype_t type, double seconds);
+
+/**
+ * \brief	Same as \ref hw_event_wait_next, but records the event, or returns the next event of
+ *		the replay.
+ *
+ * @param	event		Where to store the event.
+ */
+void ei_event_wait_next(ei_event_t *event);
+
+/**
+ * \brief	Same as \ref hw_event_post_app, but queued by the replay when it is running. Like
+ *		\ref hw_event_post_app, it can be called from any thread.
+ *
+ * @param	user_param
+ */
+void ei_event_post_app(void *user_param);
+
+/**
+ * \brief	Same as \ref hw_event_schedule_app, but scheduled on the virtual clock when a replay is
+ *		running.
+ *
+ * @param	ms_delay
+ * @param	user_param
+ */
+void ei_event_schedule_app(int ms_delay, void *user_param);
+
+/**
+ * \brief	Same as \ref hw_now, but returns the virtual clock when a replay is running.
+ *
+ * @return			The date, in seconds.
+ */
+double ei_now(void);
+
+#endif //EI_RECORD_H
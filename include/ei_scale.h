@@ -0,0 +1,77 @@
+/**
+ *  @file	ei_scale.h
+ *  @brief	Resampling of pixels, for \ref ei_copy_surface_scaled. The pixels are 32 bits integers
+ *		whose 4 bytes are filtered independently: the channel order does not matter.
+ *
+ *		The inner loops use SSE2 when the compiler targets it (always on x86-64), and AVX2 for
+ *		the vertical interpolation when it is enabled (e.g. -mavx2). Otherwise, two channels are
+ *		processed at once in a 32 bits integer. The rows of the halved sources are allocated by
+ *		\ref ei_surface_alloc_pixels.
+ *
+ */
+
+#ifndef EI_SCALE_H
+#define EI_SCALE_H
+
+#include <stdint.h>
+
+#include "ei_draw.h"
+#include "ei_types.h"
+
+/**
+ * \brief	Resamples "src_size" pixels of "src" to "dst_size" pixels in "dst".
+ *
+ * @param	dst		"dst_size.height" rows of "dst_size.width" pixels.
+ * @param	dst_stride	The number of pixels between two rows of the result.
+ * @param	dst_size	The size of the result, at least 1x1.
+ * @param	src		The first pixel of the source.
+ * @param	src_stride	The number of pixels between two rows of the source.
+ * @param	src_size	The size of the source, at least 1x1.
+ * @param	filter		The filter. With \ref ei_filter_bilinear, a source larger than twice
+ *				the result is first halved (see \ref ei_scale_levels).
+ */
+void ei_scale_pixels(uint32_t *dst, int dst_stride, ei_size_t dst_size, const uint32_t *src, int src_stride,
+		     ei_size_t src_size, ei_filter_t filter);
+
+/**
+ * \brief	Returns the number of times a source of size "src_size" is halved before being resampled
+ *		to "dst_size" with "filter": the bilinear filter only reads 2x2 source pixels per
+ *		result pixel, so the source is first reduced to less than twice the result.
+ *
+ * @param	src_size
+ * @param	dst_size
+ * @param	filter
+ *
+ * @return			The number of halvings, 0 for \ref ei_filter_box.
+ */
+int ei_scale_levels(ei_size_t src_size, ei_size_t dst_size, ei_filter_t filter);
+
+/**
+ * \brief	Returns the size of the half of a source of size "size" (at least 1x1).
+ *
+ * @param	size
+ *
+ * @return			The size of the half.
+ */
+ei_size_t ei_scale_half_size(ei_size_t size);
+
+/**
+ * \brief	Halves "src": each pixel of "dst" is the average of 2x2 pixels of "src".
+ *
+ * @param	dst		The result, of size \ref ei_scale_half_size of "src_size".
+ * @param	dst_stride	The number of pixels between two rows of the result.
+ * @param	src		The first pixel of the source.
+ * @param	src_stride	The number of pixels between two rows of the source.
+ * @param	src_size
+ */
+void ei_scale_halve(uint32_t *dst, int dst_stride, const uint32_t *src, int src_stride, ei_size_t src_size);
+
+/**
+ * \brief	Enables or disables the SSE2 and AVX2 loops (enabled by default). Both paths give the
+ *		same pixels: this is used by the tests to compare them.
+ *
+ * @param	enabled		EI_FALSE to use only the scalar loops.
+ */
+void ei_scale_set_simd(ei_bool_t enabled);
+
+#endif //EI_SCALE_H
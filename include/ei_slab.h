@@ -0,0 +1,58 @@
+/**
+ *  @file	ei_slab.h
+ *  @brief	Pools of fixed-size blocks, used by the library for widgets and their side allocations:
+ *		freed blocks are kept in a free list and reused by the next allocation.
+ *
+ */
+
+#ifndef EI_SLAB_H
+#define EI_SLAB_H
+
+#include <stddef.h>
+
+/**
+ * \brief	A pool of blocks of "block_size" bytes. Blocks are taken from chunks of
+ *		"blocks_per_chunk" blocks, which are only released by \ref ei_slab_release.
+ */
+typedef struct ei_slab_t {
+	size_t	block_size;		///< Size of a block, at least the size of a pointer.
+	size_t	blocks_per_chunk;	///< Number of blocks allocated at once.
+	void	*free_list;		///< Freed blocks, chained through their first bytes.
+	void	*chunks;		///< Allocated chunks, chained through their first bytes.
+	char	*next_block;		///< First block of the last chunk which has never been given.
+	char	*end_block;		///< End of the last chunk.
+	size_t	live;			///< Number of blocks currently given.
+} ei_slab_t;
+
+/**
+ * \brief	Initializer of a pool (no memory is allocated until the first \ref ei_slab_alloc).
+ *
+ * @param	size		Size of the blocks of the pool (e.g. sizeof of a widget structure).
+ */
+#define EI_SLAB_INITIALIZER(size)	{ (size), 64, NULL, NULL, NULL, NULL, 0 }
+
+/**
+ * \brief	Returns a block of the pool, with all bytes set to 0.
+ *
+ * @param 	slab
+ *
+ * @return 			The block, to be given back by \ref ei_slab_free.
+ */
+void *ei_slab_alloc(ei_slab_t *slab);
+
+/**
+ * \brief	Gives a block back to its pool. Does nothing if "block" is NULL.
+ *
+ * @param 	slab
+ * @param 	block		A block returned by \ref ei_slab_alloc on the same pool.
+ */
+void ei_slab_free(ei_slab_t *slab, void *block);
+
+/**
+ * \brief	Frees every chunk of the pool. Every block given by the pool becomes invalid.
+ *
+ * @param 	slab
+ */
+void ei_slab_release(ei_slab_t *slab);
+
+#endif //EI_SLAB_H
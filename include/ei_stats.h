@@ -0,0 +1,114 @@
+/**
+ *  @file	ei_stats.h
+ *  @brief	Rendering counters: for each iteration of the main loop (see \ref ei_app_run), the
+ *		number of events and invalidated rectangles, the redrawn area, the widgets visited,
+ *		drawn or culled, the pixels and primitives drawn, and the time spent to draw, pick
+ *		and update the screen. Each iteration is written as a line of a CSV or JSON file.
+ *
+ *		The counters are enabled by \ref ei_app_set_stats, or by the environment variable
+ *		EI_STATS=file read by \ref ei_app_create. When they are disabled, the counting
+ *		functions return immediately.
+ *
+ */
+
+#ifndef EI_STATS_H
+#define EI_STATS_H
+
+#include "ei_event.h"
+#include "ei_types.h"
+
+/**
+ * \brief	The counters of an iteration.
+ */
+typedef enum {
+	ei_stats_events = 0,		///< Events dispatched.
+	ei_stats_rects,			///< Rectangles invalidated (\ref ei_app_invalidate_rect).
+	ei_stats_damage_area,		///< Area of the union of the invalidated rectangles, redrawn.
+	ei_stats_visited,		///< Widgets visited by the drawing traversals (screen and pick).
+	ei_stats_drawn,			///< Widgets drawn (visible in the clipper).
+	ei_stats_culled,		///< Widgets skipped (outside of the clipper).
+	ei_stats_window_pixels,		///< Pixels written on the root window.
+	ei_stats_pick_pixels,		///< Ids written in the pick buffer.
+	ei_stats_polygons,		///< Calls to \ref ei_draw_polygon.
+	ei_stats_texts,			///< Calls to \ref ei_draw_text.
+	ei_stats_counter_last		///< Number of counters.
+} ei_stats_counter_t;
+
+/**
+ * \brief	The timers of an iteration.
+ */
+typedef enum {
+	ei_stats_draw_time = 0,		///< Redraw of the invalidated rectangles.
+	ei_stats_pick_time,		///< Redraw of the pick buffer.
+	ei_stats_update_time,		///< \ref hw_surface_update_rects.
+	ei_stats_timer_last		///< Number of timers.
+} ei_stats_timer_t;
+
+/**
+ * \brief	Starts writing the counters to "filename": as JSON if its name ends with ".json",
+ *		as CSV otherwise. The file is closed by \ref ei_stats_stop.
+ *
+ * @param	filename	The file to create.
+ *
+ * @return			EI_FALSE if the file could not be created.
+ */
+ei_bool_t ei_stats_start(const char *filename);
+
+/**
+ * \brief	Writes the last iteration and closes the file. Called by \ref ei_app_free.
+ */
+void ei_stats_stop(void);
+
+/**
+ * \brief	Returns true if the counters are enabled.
+ *
+ * @return			EI_TRUE if a file is open.
+ */
+ei_bool_t ei_stats_is_active(void);
+
+/**
+ * \brief	Sets the type of the event that started the current iteration (the first event of
+ *		the batch).
+ *
+ * @param	type
+ */
+void ei_stats_set_event(ei_eventtype_t type);
+
+/**
+ * \brief	Adds "count" to a counter of the current iteration.
+ *
+ * @param	counter
+ * @param	count
+ */
+void ei_stats_add(ei_stats_counter_t counter, long count);
+
+/**
+ * \brief	Adds "count" pixels written on "surface": counted only if "surface" is the root window.
+ *
+ * @param	surface
+ * @param	count
+ */
+void ei_stats_add_pixels(ei_surface_t surface, long count);
+
+/**
+ * \brief	Returns the date at which a measure starts, to be given to \ref ei_stats_add_time.
+ *
+ * @return			The date (see \ref hw_now), or 0 if the counters are disabled.
+ */
+double ei_stats_clock(void);
+
+/**
+ * \brief	Adds the time elapsed since "start" to a timer of the current iteration.
+ *
+ * @param	timer
+ * @param	start		The value returned by \ref ei_stats_clock.
+ */
+void ei_stats_add_time(ei_stats_timer_t timer, double start);
+
+/**
+ * \brief	Writes the current iteration and starts a new one. Called at the end of each
+ *		iteration of \ref ei_app_run.
+ */
+void ei_stats_end_iteration(void);
+
+#endif //EI_STATS_H
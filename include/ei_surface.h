@@ -0,0 +1,175 @@
+/**
+ *  @file	ei_surface.h
+ *  @brief	Views on a part of a surface, and the accessors of surfaces used by the drawing
+ *		functions of \ref ei_draw.h.
+ *
+ *		A view shares the pixels of its parent: creating a view does not allocate nor copy
+ *		pixels. It has its own size and coordinates (its top-left pixel is (0, 0)), and the
+ *		stride of its parent. Every drawing function accepts a view wherever it accepts a
+ *		surface, and so does the configuration of the image of a widget: the tiles of a
+ *		sprite sheet or of an atlas are views of a single surface.
+ *
+ *		The accessors below work for both views and the surfaces of \ref hw_interface.h. The
+ *		functions of \ref hw_interface.h must not be called with a view.
+ *
+ */
+
+#ifndef EI_SURFACE_H
+#define EI_SURFACE_H
+
+#include <stdint.h>
+
+#include "hw_interface.h"
+#include "ei_types.h"
+
+#define EI_SURFACE_ALIGNMENT 64		///< Alignment in bytes of the rows of the pixels allocated by the library.
+
+/**
+ * \brief	Creates a view on a part of a surface. The view holds a reference on its parent if the
+ *		parent is a view. A surface of \ref hw_interface.h can not be counted: it must not be
+ *		freed before its views.
+ *
+ * @param	parent		A surface or a view.
+ * @param	rect		The part of "parent", in the coordinates of "parent". It is clipped
+ *				by "parent". NULL for the whole parent.
+ *
+ * @return			The view, with a reference count of 1.
+ */
+ei_surface_t ei_surface_create_view(ei_surface_t parent, const ei_rect_t *rect);
+
+/**
+ * \brief	Adds a reference to a view. Does nothing for a surface of \ref hw_interface.h.
+ *
+ * @param	surface
+ */
+void ei_surface_retain(ei_surface_t surface);
+
+/**
+ * \brief	Removes a reference to a view, freed with its last reference (its parent is then
+ *		released). Does nothing for a surface of \ref hw_interface.h.
+ *
+ * @param	surface
+ */
+void ei_surface_release(ei_surface_t surface);
+
+/**
+ * \brief	Returns true if "surface" is a view of \ref ei_surface_create_view.
+ *
+ * @param	surface
+ *
+ * @return			EI_TRUE for a view.
+ */
+ei_bool_t ei_surface_is_view(ei_surface_t surface);
+
+/**
+ * \brief	Returns the surface of \ref hw_interface.h that owns the pixels of "surface" ("surface"
+ *		itself if it is not a view).
+ *
+ * @param	surface
+ *
+ * @return			The surface.
+ */
+ei_surface_t ei_surface_get_root(ei_surface_t surface);
+
+/**
+ * \brief	Returns the first pixel of "surface", which must be locked (see \ref ei_surface_lock).
+ *		The pixels of a row are consecutive, the rows are \ref ei_surface_get_stride bytes apart.
+ *
+ * @param	surface
+ *
+ * @return			The address of the top-left pixel.
+ */
+uint8_t *ei_surface_get_buffer(ei_surface_t surface);
+
+/**
+ * \brief	Returns the number of bytes between the beginning of two rows of "surface".
+ *
+ *		The prebuilt hardware layer does not expose the pitch of its surfaces: they are assumed
+ *		packed, and the stride is always 4 times the width of the surface (of its root surface
+ *		for a view). Only the pixels allocated by the library itself (see
+ *		\ref ei_surface_alloc_pixels, e.g. in \ref ei_image_t) have padded, aligned rows, and
+ *		those carry their own stride.
+ *
+ * @param	surface
+ *
+ * @return			The stride.
+ */
+int ei_surface_get_stride(ei_surface_t surface);
+
+/**
+ * \brief	Returns the size of "surface".
+ *
+ * @param	surface
+ *
+ * @return			The size.
+ */
+ei_size_t ei_surface_get_size(ei_surface_t surface);
+
+/**
+ * \brief	Returns the rectangle of "surface": see \ref hw_surface_get_rect. The rectangle of a view
+ *		starts at (0, 0).
+ *
+ * @param	surface
+ *
+ * @return			The rectangle.
+ */
+ei_rect_t ei_surface_get_rect(ei_surface_t surface);
+
+/**
+ * \brief	Returns the clipper of a drawing on "surface": a drawing function does not check the
+ *		bounds of a surface when its clipper is NULL, but it must not draw outside of a view.
+ *
+ * @param	surface
+ * @param	clipper		The clipper given to the drawing function, or NULL.
+ * @param	storage		Where to store the clipper restricted to a view.
+ *
+ * @return			"clipper" if "surface" is not a view, "storage" otherwise.
+ */
+const ei_rect_t *ei_surface_clipper(ei_surface_t surface, const ei_rect_t *clipper, ei_rect_t *storage);
+
+/**
+ * \brief	See \ref hw_surface_get_channel_indices. A view has the channels of its parent.
+ */
+void ei_surface_get_channel_indices(ei_surface_t surface, int *ir, int *ig, int *ib, int *ia);
+
+/**
+ * \brief	See \ref hw_surface_has_alpha. A view has the alpha channel of its parent.
+ */
+ei_bool_t ei_surface_has_alpha(ei_surface_t surface);
+
+/**
+ * \brief	Locks "surface" (for a view, the surface that owns its pixels), see \ref hw_surface_lock.
+ */
+void ei_surface_lock(ei_surface_t surface);
+
+/**
+ * \brief	Unlocks "surface" (for a view, the surface that owns its pixels), see \ref hw_surface_unlock.
+ */
+void ei_surface_unlock(ei_surface_t surface);
+
+/**
+ * \brief	Allocates uninitialized pixels whose rows start on \ref EI_SURFACE_ALIGNMENT bytes: the
+ *		SIMD kernels use aligned loads and stores from the beginning of a row, and a row never
+ *		shares a cache line with the next one.
+ *
+ * @param	size		The size of the pixels.
+ * @param	stride		Where to store the number of bytes between the beginning of two rows,
+ *				a multiple of \ref EI_SURFACE_ALIGNMENT.
+ *
+ * @return			The first pixel, to be freed by \ref ei_surface_free_pixels.
+ */
+uint32_t *ei_surface_alloc_pixels(ei_size_t size, int *stride);
+
+/**
+ * \brief	Frees the pixels of \ref ei_surface_alloc_pixels. Does nothing if "pixels" is NULL.
+ *
+ * @param	pixels
+ */
+void ei_surface_free_pixels(uint32_t *pixels);
+
+/**
+ * \brief	Frees the views that were not released. Called by \ref ei_app_free.
+ */
+void ei_surface_free_views(void);
+
+#endif //EI_SURFACE_H
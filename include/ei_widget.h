@@ -33,23 +33,31 @@ typedef void		(*ei_widget_destructor_t)(struct ei_widget_t* widget);
  *		class by adding its own fields. 
  */
 typedef struct ei_widget_t {
+	/* Hot fields: read for every widget by the traversals (drawing, layout, destruction), 64 bytes on 64-bit targets */
 	ei_widgetclass_t*	wclass;		///< The class of widget of this widget. Avoids the field name "class" which is a keyword in C++.
 	uint32_t		pick_id;	///< Id of this widget in the picking offscreen.
-	ei_color_t*		pick_color;	///< pick_id encoded as a color.
+	int			layout_flags;	///< Children (or descendants) to lay out again before the next drawing, see \ref ei_layout_flag_t. Managed by the library.
+	struct ei_widget_t*	parent;		///< Pointer to the parent of this widget.
+	struct ei_widget_t*	children_head;	///< Pointer to the first child of this widget.	Children are chained with the "next_sibling" field.
+	struct ei_widget_t*	next_sibling;	///< Pointer to the next child of this widget's parent widget.
+	ei_rect_t		screen_location;///< Position and size of the widget expressed in the root window reference.
+	ei_rect_t*		content_rect;	///< Where to place children, when this widget is used as a container. By defaults, points to the screen_location.
+
+	/* Cold fields: read when the widget itself is configured, placed or destroyed */
+	ei_color_t		pick_color;	///< pick_id encoded as a color.
 	void*			user_data;	///< Pointer provided by the programmer for private use. May be NULL.
 	ei_widget_destructor_t	destructor;	///< Pointer to the programmer's function to call before destroying this widget. May be NULL.
 
 	/* Widget Hierachy Management */
-	struct ei_widget_t*	parent;		///< Pointer to the parent of this widget.
-	struct ei_widget_t*	children_head;	///< Pointer to the first child of this widget.	Children are chained with the "next_sibling" field.
 	struct ei_widget_t*	children_tail;	///< Pointer to the last child of this widget.
-	struct ei_widget_t*	next_sibling;	///< Pointer to the next child of this widget's parent widget.
+	struct ei_widget_t*	prev_sibling;	///< Pointer to the previous child of this widget's parent widget.
 
 	/* Geometry Management */
 	ei_placer_params_t*	placer_params;	///< Pointer to the placer parameters for this widget. If NULL, the widget is not currently managed and thus, is not displayed on the screen.
+	struct ei_manager_t*	manager;	///< Grid or pack manager of the children of this widget, NULL if none (see \ref ei_grid.h, \ref ei_pack.h).
+	int			manager_slot;	///< Index of this widget in the manager of its parent, -1 if it is not managed by a grid or a pack.
 	ei_size_t		requested_size;	///< Size requested by the widget (big enough for its label, for example), or by the programmer. This can be different than its screen size defined by the placer.
-	ei_rect_t		screen_location;///< Position and size of the widget expressed in the root window reference.
-	ei_rect_t*		content_rect;	///< Where to place children, when this widget is used as a container. By defaults, points to the screen_location.
+	ei_rect_t		layout_parent;	///< The parent's content_rect when this widget was last placed. Managed by the library.
 } ei_widget_t;
 
 
@@ -88,6 +96,22 @@ ei_widget_t*		ei_widget_create		(ei_widgetclass_name_t	class_name,
 							 void*			user_data,
 							 ei_widget_destructor_t destructor);
 
+/**
+ * @brief	Same as \ref ei_widget_create, but the class is given by a handle returned by
+ *		\ref ei_widgetclass_get_handle: no lookup of the class name is done.
+ *
+ * @param	wclass		The handle of the class of the widget that is to be created.
+ * @param	parent 		A pointer to the parent widget. Can not be NULL.
+ * @param	user_data	A pointer provided by the programmer for private use. May be NULL.
+ * @param	destructor	A pointer to a function to call before destroying a widget structure. May be NULL.
+ *
+ * @return			The newly created widget, or NULL if "wclass" is NULL.
+ */
+ei_widget_t*		ei_widget_create_from_handle	(ei_widgetclass_handle_t wclass,
+							 ei_widget_t*		parent,
+							 void*			user_data,
+							 ei_widget_destructor_t destructor);
+
 /**
  * @brief	Destroys a widget. Calls its destructor if it was provided.
  * 		Removes the widget from the screen if it is currently managed by the placer.
@@ -97,6 +121,17 @@ ei_widget_t*		ei_widget_create		(ei_widgetclass_name_t	class_name,
  */
 void			ei_widget_destroy		(ei_widget_t*		widget);
 
+/**
+ * @brief	Destroys all the descendants of a widget, but not the widget itself. Calls the
+ *		destructors that were provided. The area of the children that are managed by the
+ *		placer is redrawn at once.
+ *
+ *		Equivalent to calling \ref ei_widget_destroy on every child, in a single pass.
+ *
+ * @param	widget		The widget whose children are to be destroyed.
+ */
+void			ei_widget_destroy_children	(ei_widget_t*		widget);
+
 
 /**
  * @brief	Returns the widget that is at a given location on screen.
@@ -141,11 +176,15 @@ ei_widget_t*		ei_widget_pick			(ei_point_t*		where);
  *				Defines both the anchoring point on the parent and on the widget.
  *				Defaults to \ref ei_anc_center.
  * @param	img		The image to display in the widget, or NULL. Any surface can be
- *				used, but usually a surface returned by \ref hw_image_load. Only one
+ *				used, but usually a surface returned by \ref hw_image_load, or a view
+ *				of such a surface (\ref ei_surface_create_view). Only one
  *				of the parameter "text" and "img" should be used (i.e. non-NULL).
- 				Defaults to NULL.
+ 				Defaults to NULL. The image is copied when the widget is configured,
+ *				in the format of the root surface: the surface can be freed after the
+ *				call. It must not be locked.
  * @param	img_rect	If not NULL, this rectangle defines a subpart of "img" to use as the
- *				image displayed in the widget. Defaults to NULL.
+ *				image displayed in the widget. Defaults to NULL. Only used together
+ *				with "img".
  * @param	img_anchor	The anchor of the image, i.e. where it is placed within the widget
  *				when the size of the widget is bigger than the size of the image.
  *				Defaults to \ref ei_anc_center.
@@ -9,6 +9,7 @@
 #define EI_WIDGET_UTILS_H
 
 #include "ei_types.h"
+#include "ei_image.h"
 #include "ei_widget.h"
 #include "ei_widgetclass.h"
 
@@ -21,8 +22,7 @@ typedef struct ei_frame_t {
 	ei_font_t text_font;
 	ei_color_t text_color;
 	ei_anchor_t text_anchor;
-	ei_surface_t *img;
-	ei_rect_t *img_rect;
+	ei_image_t *img;		///< Converted when configured, see \ref ei_image_create
 	ei_anchor_t img_anchor;
 	ei_bool_t requested_bool;
 } ei_frame_t;
@@ -37,8 +37,7 @@ typedef struct ei_button_t {
 	ei_font_t text_font;
 	ei_color_t text_color;
 	ei_anchor_t text_anchor;
-	ei_surface_t *img;
-	ei_rect_t *img_rect;
+	ei_image_t *img;		///< Converted when configured, see \ref ei_image_create
 	ei_anchor_t img_anchor;
 	ei_callback_t callback;
 	void *user_param;
@@ -76,23 +75,66 @@ typedef struct ei_toplevel_t {
  */
 void empty_callback(ei_widget_t *widget, struct ei_event_t *event, void *user_param);
 
+/**
+ * \brief 	Adds "widget" as the last child of "parent" (on top of its siblings), in constant time.
+ * 		"widget" must not be linked to a parent.
+ *
+ * @param 	widget
+ * @param 	parent
+ */
+void ei_widget_link_last(ei_widget_t *widget, ei_widget_t *parent);
+
+/**
+ * \brief 	Removes "widget" from the children of its parent, in constant time, thanks to the
+ * 		"prev_sibling" field. The "parent" field is kept. Does nothing for the root widget.
+ *
+ * @param 	widget
+ */
+void ei_widget_unlink(ei_widget_t *widget);
+
 /**
  * \brief 	Similar to \ref ei_widget_destroy, but used only on widgets that do not need
- * 		their "next_sibling" / "children_head" / "children_tail" fields to be rewritten.
+ * 		their "next_sibling" / "prev_sibling" / "children_head" / "children_tail" fields to be rewritten.
+ * 		Iterative: the depth of the tree is not limited by the C stack.
  *
  * @param 	widget
  */
 void ei_widget_destroy_child(ei_widget_t *widget);
 
 /**
- * \brief 	Function used to attribuate an unique "pick_id" to "widget".
+ * \brief 	Frees the memory of the structure of "widget", once its fields are released:
+ * 		gives it back to the pool of its class if it is a class of the library, calls free
+ * 		otherwise.
+ *
+ * @param 	widget
+ */
+void ei_widget_free_memory(ei_widget_t *widget);
+
+/**
+ * \brief 	Frees the pools of the classes of the library (every widget must have been destroyed before)
+ */
+void free_widget_slabs(void);
+
+/**
+ * \brief 	Registers "widget" and returns its unique "pick_id" (used for pick surface).
+ * 		Ids are dense: the ids of destroyed widgets are reused before new ones are given.
+ * 		The id 0 is never given, it stands for "no widget" in the pick surface.
+ *
+ * @param 	widget
  *
- * @return		Unique pick id (used for pick surface)
+ * @return		Unique pick id
  */
-uint32_t ei_get_widget_id(void);
+uint32_t ei_register_widget_id(ei_widget_t *widget);
 
 /**
- * \brief 	Finds the widget such as "widget->pick_id == id". Returns NULL is not found
+ * \brief 	Unregisters the widget of pick id "id", so that "id" can be given to a new widget.
+ *
+ * @param 	id
+ */
+void ei_release_widget_id(uint32_t id);
+
+/**
+ * \brief 	Finds the widget such as "widget->pick_id == id" in constant time. Returns NULL is not found
  *
  * @param 	id
  *
@@ -101,13 +143,16 @@ uint32_t ei_get_widget_id(void);
 ei_widget_t *ei_find_widget_by_id(uint32_t id);
 
 /**
- * \brief 	Recursive function used by \ref ei_find_widget_by_id for the search
+ * \brief 	Returns a bound of the pick ids given so far: every pick_id is lower than this value.
  *
- * @param 	widget
- * @param 	id
- * @return 		Widget or NULL corresponding to the id
+ * @return		The bound
+ */
+uint32_t ei_widget_id_bound(void);
+
+/**
+ * \brief 	Frees the registry of widgets (every widget must have been destroyed before)
  */
-ei_widget_t *search_widget(ei_widget_t *widget, uint32_t id);
+void free_widget_registry(void);
 
 /**
  * \brief 	Returns the natural size of a widget (see parameters)
@@ -115,10 +160,10 @@ ei_widget_t *search_widget(ei_widget_t *widget, uint32_t id);
  * @param 	border_width
  * @param 	text
  * @param 	text_font
- * @param 	img_rect
+ * @param 	img
  * @return			natural size
  */
-ei_size_t ei_widget_natural_size(int border_width, char *text, ei_font_t text_font, ei_rect_t *img_rect);
+ei_size_t ei_widget_natural_size(int border_width, char *text, ei_font_t text_font, const ei_image_t *img);
 
 /**
  * \brief	Returns a frame with default fields
@@ -319,7 +364,6 @@ ei_bool_t toplevel_handlefunc(ei_widget_t *widget, struct ei_event_t *event);
  * @param 	clipper
  * @param 	rect
  * @param 	toplevel_color
- * @param 	pick
  * @param 	border_width
  */
 void draw_toplevel(ei_surface_t surface,
@@ -329,7 +373,6 @@ void draw_toplevel(ei_surface_t surface,
 		   const ei_rect_t *clipper,
 		   ei_rect_t rect,
 		   ei_color_t toplevel_color,
-		   ei_bool_t pick,
 		   int border_width);
 
 /**
@@ -343,7 +386,8 @@ void draw_toplevel(ei_surface_t surface,
  * @param 	rect
  * @param 	frame_color
  * @param 	relief
- * @param 	pick
+ * @param 	img		Drawn instead of the text if not NULL
+ * @param 	img_anchor
  */
 void draw_frame(ei_surface_t surface,
 		const char *text,
@@ -353,6 +397,7 @@ void draw_frame(ei_surface_t surface,
 		ei_rect_t rect,
 		ei_color_t frame_color,
 		ei_relief_t relief,
-		ei_bool_t pick);
+		const ei_image_t *img,
+		ei_anchor_t img_anchor);
 
 #endif //EI_WIDGET_UTILS_H
\ No newline at end of file
@@ -49,7 +49,10 @@ typedef void	(*ei_widgetclass_releasefunc_t)		(struct ei_widget_t*	widget);
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
  *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				If NULL, only the picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen: an \ref ei_pick_buffer_t where the widget writes
+ *				its "pick_id" (see \ref ei_pick_fill_rect). If NULL, it is not drawn
+ *				(the library only updates the picking offscreen when a pick query needs it).
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -111,6 +114,13 @@ typedef struct ei_widgetclass_t {
 	struct ei_widgetclass_t*		next;			///< A pointer to the next instance of ei_widget_class_t, allows widget class descriptions to be chained.
 } ei_widgetclass_t;
 
+/**
+ * \brief	A direct reference to a registered class. Creating widgets from a handle (see
+ *		\ref ei_widget_create_from_handle) skips the lookup of the class name.
+ *		A handle stays valid until \ref ei_app_free.
+ */
+typedef ei_widgetclass_t*	ei_widgetclass_handle_t;
+
 
 
 
@@ -145,6 +155,16 @@ void			ei_widgetclass_register		(ei_widgetclass_t* widgetclass);
  */
 ei_widgetclass_t*	ei_widgetclass_from_name	(ei_widgetclass_name_t name);
 
+/**
+ * @brief	Returns a handle on a registered class, from its name. The name is looked up
+ *		once: the handle can then be kept to create many widgets of this class.
+ *
+ * @param	name		The name of the class of widget.
+ *
+ * @return			The handle, or NULL if no class of this name was registered.
+ */
+ei_widgetclass_handle_t	ei_widgetclass_get_handle	(ei_widgetclass_name_t name);
+
 
 
 
@@ -8,25 +8,32 @@
 #ifndef EI_WIDGETCLASS_UTILS_H
 #define EI_WIDGETCLASS_UTILS_H
 
-#include "directory.h"
+#include <stdint.h>
+
+#include "ei_widgetclass.h"
 
 /**
- * \brief	Returns the global variable of the dictionnary of widget classes
+ * \brief	Adds a class to the registry of widget classes, or replaces the class of the same name.
+ * 		The registry is a table with open addressing: the hash of each name is computed once,
+ * 		at registration, and no memory is allocated per class.
+ * 		The class is also chained (field "next") after the previously registered class.
  *
- * @return 		Dictionnary of widget classes
+ * @param	wclass
  */
-struct dir *get_widget_dir(void);
+void ei_class_registry_insert(ei_widgetclass_t *wclass);
 
 /**
- * \brief 	Frees the dictionnary of widget classes
+ * \brief	Finds a class from its name.
+ *
+ * @param	name
+ *
+ * @return 		The class, or NULL if no class of this name was registered
  */
-void free_widget_dir(void);
+ei_widgetclass_t *ei_class_registry_lookup(const char *name);
 
 /**
- * \brief	Sets the first widget class (used for freeing every widget class)
- *
- * @param	wclass
+ * \brief 	Frees the registry of widget classes, and every registered class
  */
-void set_first_widgetclass(ei_widgetclass_t *wclass);
+void free_widgetclass_registry(void);
 
 #endif //EI_WIDGETCLASS_UTILS_H
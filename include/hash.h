@@ -1,6 +1,6 @@
 /**
  *  @file	hash.h
- *  @brief	Contains the hash function useful for \ref directory.h
+ *  @brief	Contains the hash function of the registry of widget classes (see \ref ei_widgetclass_utils.h)
  *
  */
 
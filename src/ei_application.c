@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "hw_interface.h"
@@ -6,7 +7,15 @@
 #include "ei_widget.h"
 #include "ei_widgetclass.h"
 
+#include "ei_arena.h"
 #include "ei_draw_utils.h"
+#include "ei_image_async.h"
+#include "ei_image_cache.h"
+#include "ei_pick.h"
+#include "ei_placer_utils.h"
+#include "ei_record.h"
+#include "ei_stats.h"
+#include "ei_surface.h"
 #include "ei_application_utils.h"
 #include "ei_widget_utils.h"
 #include "ei_widgetclass_utils.h"
@@ -17,6 +26,15 @@ ei_bool_t DO_QUIT = EI_FALSE;
 ei_surface_t ROOT_WINDOW;
 ei_widget_t *ROOT_FRAME;
 ei_linked_rect_t *RECTANGLE_LIST;
+int BATCH_END;			///< Its address marks the end of a batch of events (see ei_app_run)
+int FRAME_TICK;			///< Its address marks the timer event that wakes the loop for a frame
+int MAX_FPS = 60;		///< 0 if the number of frames per second is not capped
+double LAST_FRAME = -1;		///< Date (ei_now) of the last frame
+ei_bool_t TICK_PENDING = EI_FALSE;
+ei_bool_t FRAME_REQUESTED = EI_FALSE;
+ei_frame_callback_t FRAME_BEGIN = NULL;
+ei_frame_callback_t FRAME_END = NULL;
+void *FRAME_USER_PARAM = NULL;
 /**                  **/
 /** ---------------- **/
 
@@ -29,6 +47,12 @@ ei_linked_rect_t *RECTANGLE_LIST;
  *			<li> creates the root widget to access the root window. </li>
  *		</ul>
  *
+ *		The events can be recorded to a file, or replayed from such a file, by setting the
+ *		environment variable EI_RECORD or EI_REPLAY to the name of the file (see \ref ei_record.h).
+ *		The rendering counters are written to the file named by EI_STATS (see \ref ei_stats.h).
+ *		The decoded images are kept in the directory named by EI_IMAGE_CACHE_DIR (see
+ *		\ref ei_image_cache_set_directory).
+ *
  * @param	main_window_size	If "fullscreen is false, the size of the root window of the
  *					application.
  *					If "fullscreen" is true, the current monitor resolution is
@@ -38,8 +62,26 @@ ei_linked_rect_t *RECTANGLE_LIST;
  *					is a system window.
  */
 void ei_app_create(ei_size_t main_window_size, ei_bool_t fullscreen) {
+	const char *trace;
 	hw_init();
 
+	// Enregistrement ou rejeu des évènements demandé par l'environnement
+	if ((trace = getenv("EI_REPLAY")) != NULL) {
+		if (!ei_replay_start(trace)) {
+			fprintf(stderr, "EI_REPLAY: cannot read %s\n", trace);
+		}
+	} else if ((trace = getenv("EI_RECORD")) != NULL) {
+		if (!ei_record_start(trace)) {
+			fprintf(stderr, "EI_RECORD: cannot create %s\n", trace);
+		}
+	}
+	if ((trace = getenv("EI_STATS")) != NULL && !ei_stats_start(trace)) {
+		fprintf(stderr, "EI_STATS: cannot create %s\n", trace);
+	}
+	if ((trace = getenv("EI_IMAGE_CACHE_DIR")) != NULL) {
+		ei_image_cache_set_directory(trace);
+	}
+
 	// Register all classes of widget
 	ei_widgetclass_t *frame_class = malloc(sizeof(ei_widgetclass_t));
 	ei_widgetclass_t *button_class = malloc(sizeof(ei_widgetclass_t));
@@ -57,16 +99,14 @@ void ei_app_create(ei_size_t main_window_size, ei_bool_t fullscreen) {
 	ROOT_WINDOW = hw_create_window(main_window_size, fullscreen);
 	ei_size_t real_size = hw_surface_get_size(ROOT_WINDOW);
 
-	// Create pick surface
-	ei_surface_t pick_surface = hw_surface_create(ROOT_WINDOW, real_size, EI_TRUE);
-	ei_set_pick_surface(pick_surface);
+	// Create pick buffer (ids sur 16 bits tant qu'il y a moins de 65536 widgets)
+	ei_set_pick_buffer(ei_pick_buffer_create(hw_surface_get_rect(ROOT_WINDOW), 16, EI_FALSE));
 
 	// Create root widget
 	ROOT_FRAME = ei_widget_create("frame", NULL, NULL, NULL);
 	ei_place(ROOT_FRAME, NULL, 0, 0, &real_size.width, &real_size.height, NULL, NULL, NULL, NULL);
 
 	// Create rectangle list (for ei_app_invalidate_rects)
-	RECTANGLE_LIST = malloc(sizeof(ei_linked_rect_t));
 	RECTANGLE_LIST = NULL;
 }
 
@@ -78,79 +118,181 @@ void ei_app_free(void) {
 	// Free every widget
 	ei_widget_destroy(ROOT_FRAME);
 
-	// Free widget classes
-	free_widget_dir();
+	// Free widget registry and widget classes
+	free_widget_registry();
+	free_widget_slabs();
+	free_placer_slab();
+	free_widgetclass_registry();
+
+	// Free the images loaded from files
+	ei_image_async_free();
+	ei_image_cache_free();
+	ei_surface_free_views();
 
-	// Free both root window and pick surface
+	// Free both root window and pick buffer
 	free_root_window(ROOT_WINDOW);
+	ei_arena_free();
+	RECTANGLE_LIST = NULL;
+
+	// Stop recording or replaying, close the counters
+	ei_record_stop();
+	ei_stats_stop();
 
 	// Release hardware
 	hw_quit();
 }
 
+/**
+ * \brief	Returns true if "event" is the marker posted by \ref ei_app_run after the events
+ *		pending at the beginning of a batch.
+ */
+static ei_bool_t is_batch_end(ei_event_t event) {
+	return (ei_bool_t) (event.type == ei_ev_app && event.param.application.user_param == &BATCH_END);
+}
+
+/**
+ * \brief	Returns true if "event" is the timer event scheduled for the next frame.
+ */
+static ei_bool_t is_frame_tick(ei_event_t event) {
+	return (ei_bool_t) (event.type == ei_ev_app && event.param.application.user_param == &FRAME_TICK);
+}
+
+/**
+ * \brief	Dispatches "event" (see \ref dispatch_event), and measures its processing time
+ *		during a replay.
+ */
+static void dispatch_timed(ei_event_t *event) {
+	double start;
+	ei_stats_add(ei_stats_events, 1);
+	if (!ei_replay_is_active()) {
+		dispatch_event(event);
+		return;
+	}
+	start = hw_now();
+	dispatch_event(event);
+	ei_replay_account(event->type, hw_now() - start);
+}
+
+/**
+ * \brief	Draws a frame: calls the frame-begin callback, redraws the rectangles invalidated
+ *		since the last frame, updates the screen and calls the frame-end callback.
+ */
+static void draw_frame_now(double now) {
+	ei_rect_t big_rect;
+	double start = ei_replay_is_active() ? hw_now() : 0;
+	double clock;
+	FRAME_REQUESTED = EI_FALSE;
+	LAST_FRAME = now;
+	if (FRAME_BEGIN != NULL) {
+		FRAME_BEGIN(now, FRAME_USER_PARAM);
+	}
+	ei_layout_update();
+	if (RECTANGLE_LIST != NULL) {
+		clock = ei_stats_clock();
+		hw_surface_lock(ROOT_WINDOW);
+		big_rect = big_union_rect(RECTANGLE_LIST);
+		ei_stats_add(ei_stats_damage_area, (long) big_rect.size.width * big_rect.size.height);
+		draw_widget_recursively(ROOT_FRAME, ROOT_WINDOW, NULL, &big_rect);
+		hw_surface_unlock(ROOT_WINDOW);
+		ei_stats_add_time(ei_stats_draw_time, clock);
+		clock = ei_stats_clock();
+		hw_surface_update_rects(ROOT_WINDOW, RECTANGLE_LIST);
+		ei_stats_add_time(ei_stats_update_time, clock);
+		RECTANGLE_LIST = NULL;
+	}
+	if (FRAME_END != NULL) {
+		FRAME_END(now, FRAME_USER_PARAM);
+	}
+	if (ei_replay_is_active()) {
+		ei_replay_account(ei_ev_last, hw_now() - start);
+	}
+}
+
+/**
+ * \brief	Draws a frame if something was invalidated or placed or a frame was requested, and if the
+ *		last frame is old enough. Then, if a frame is still due (animation, or frame too
+ *		early), schedules a timer event to wake the loop at the right time. Does nothing if
+ *		there is nothing to draw: the application is idle.
+ */
+static void schedule_frame(void) {
+	double now, period, wait;
+	if (RECTANGLE_LIST == NULL && !FRAME_REQUESTED && !ei_layout_is_pending()) {
+		return;
+	}
+	now = ei_now();
+	period = (MAX_FPS > 0) ? 1.0 / MAX_FPS : 0;
+	wait = LAST_FRAME + period - now;
+	if (wait <= 0) {
+		draw_frame_now(now);
+		if (RECTANGLE_LIST == NULL && !FRAME_REQUESTED && !ei_layout_is_pending()) {
+			return;
+		}
+		// Invalidé ou demandé pendant la frame (animation) : prochaine frame une période après celle-ci
+		wait = max(LAST_FRAME + period - ei_now(), 0);
+	}
+	if (!TICK_PENDING) {
+		ei_event_schedule_app((int) (wait * 1000) + 1, &FRAME_TICK);
+		TICK_PENDING = EI_TRUE;
+	}
+}
+
 /**
 * \brief	Runs the application: enters the main event loop. Exits when
 *		\ref ei_app_quit_request is called.
 */
 void ei_app_run() {
 	ei_event_t event;
-	ei_widget_t *active_widget = NULL;
-	ei_bool_t event_handled;
-	ei_bool_t set_inactive = EI_FALSE;
-	ei_rect_t big_rect;
+	ei_event_t pending_move;
+	ei_bool_t has_pending_move;
+	ei_rect_t root_rect = hw_surface_get_rect(ROOT_WINDOW);
 
-	// Dessiner tout une première fois
-	hw_surface_lock(ROOT_WINDOW);
-	draw_widget_recursively(ROOT_FRAME, ROOT_WINDOW, NULL);
-	draw_widget_recursively(ROOT_FRAME, ROOT_WINDOW, NULL);
-	hw_surface_unlock(ROOT_WINDOW);
-	hw_surface_update_rects(ROOT_WINDOW, NULL);
+	// Dessiner tout une première fois (la surface de picking sera dessinée au premier clic)
+	ei_app_invalidate_rect(&root_rect);
+	schedule_frame();
+	if (RECTANGLE_LIST == NULL) {
+		ei_arena_reset();
+	}
 
-	event.type = ei_ev_none;
-	hw_event_wait_next(&event);
 	while (!DO_QUIT) {
-		event_handled = EI_FALSE;
-		if (is_located_event(event)) {
-			if (event.type == ei_ev_mouse_buttondown) { // Set active
-				ei_event_set_active_widget(ei_widget_pick(&event.param.mouse.where));
-			} else if (event.type == ei_ev_mouse_buttonup) { // Unset active
-				set_inactive = EI_TRUE;
+		// Attente du premier évènement du lot, puis marqueur posté derrière les évènements en attente
+		ei_event_wait_next(&event);
+		ei_event_post_app(&BATCH_END);
+		ei_stats_set_event(event.type);
+		has_pending_move = EI_FALSE;
+		while (!is_batch_end(event) && !DO_QUIT) {
+			if (is_frame_tick(event)) { // Réveil pour une frame : rien à transmettre
+				TICK_PENDING = EI_FALSE;
+			} else if (ei_image_async_dispatch(&event)) {
+				// Images décodées par les threads : rappels déjà appelés
+			} else if (event.type == ei_ev_mouse_move) {
+				// Déplacements consécutifs fusionnés : seule la dernière position est traitée
+				pending_move = event;
+				has_pending_move = EI_TRUE;
+			} else {
+				if (has_pending_move) {
+					dispatch_timed(&pending_move);
+					has_pending_move = EI_FALSE;
+				}
+				dispatch_timed(&event);
 			}
-		}
-		active_widget = ei_event_get_active_widget();
-		if (active_widget != NULL) {
-			event_handled = active_widget->wclass->handlefunc(active_widget, &event);
-		}
-		if (!event_handled && !is_located_event(event)) {
-			// Si ce n’est pas un évènement situé, le traitant concerné est celui
-			// qui a été défini par le programmeur
-			ei_default_handle_func_t default_handle = ei_event_get_default_handle_func();
-			if (default_handle != NULL) {
-				default_handle(&event);
+			if (!DO_QUIT) {
+				ei_event_wait_next(&event);
 			}
 		}
-
-		// Update necessary rectangles
-		if (RECTANGLE_LIST != NULL) {
-			hw_surface_lock(ROOT_WINDOW);
-			big_rect = big_union_rect(RECTANGLE_LIST);
-			draw_widget_recursively(ROOT_FRAME, ROOT_WINDOW, &big_rect);
-			is_pick_surface = EI_TRUE;
-			draw_widget_recursively(ROOT_FRAME, ei_get_pick_surface(), &big_rect);
-			is_pick_surface = EI_FALSE;
-			hw_surface_unlock(ROOT_WINDOW);
-			hw_surface_update_rects(ROOT_WINDOW, RECTANGLE_LIST);
-			free_rectangle_list(RECTANGLE_LIST);
-			RECTANGLE_LIST = NULL;
+		if (has_pending_move && !DO_QUIT) {
+			dispatch_timed(&pending_move);
 		}
 
-		// Set inactive
-		if (set_inactive) {
-			ei_event_set_active_widget(NULL);
-			set_inactive = EI_FALSE;
+		// Au plus une frame pour tout le lot, et au plus MAX_FPS frames par seconde
+		if (!DO_QUIT) {
+			schedule_frame();
 		}
 
-		hw_event_wait_next(&event);
+		// Les temporaires (rectangles, points, côtés) sont rendus une fois la frame affichée
+		if (RECTANGLE_LIST == NULL) {
+			ei_arena_reset();
+		}
+		ei_stats_end_iteration();
 	}
 }
 
@@ -162,10 +304,12 @@ void ei_app_run() {
  *				A copy is made, so it is safe to release the rectangle on return.
  */
 void ei_app_invalidate_rect(ei_rect_t *rect) {
-	ei_linked_rect_t *new = malloc(sizeof(ei_linked_rect_t));
+	ei_linked_rect_t *new = ei_arena_alloc(sizeof(ei_linked_rect_t)); // Rendu après la prochaine frame
 	new->rect = *rect;
 	new->next = RECTANGLE_LIST;
 	RECTANGLE_LIST = new;
+	ei_stats_add(ei_stats_rects, 1);
+	ei_invalidate_pick_rect(*rect); // Redessinée seulement si un clic y arrive
 }
 
 /**
@@ -194,4 +338,35 @@ ei_widget_t *ei_app_root_widget(void) {
  */
 ei_surface_t ei_app_root_surface(void) {
 	return ROOT_WINDOW;
-}
\ No newline at end of file
+}
+
+void ei_app_set_pick_options(int id_bits, ei_bool_t half_resolution) {
+	ei_pick_buffer_t *buffer = ei_get_pick_buffer();
+	int bits = (id_bits == 32 || ei_widget_id_bound() > 0xFFFF) ? 32 : 16;
+	ei_set_pick_id_bits(id_bits);
+	ei_set_pick_buffer(ei_pick_buffer_create(buffer->rect, bits, half_resolution));
+	ei_pick_buffer_free(buffer);
+	ei_invalidate_pick_rect(hw_surface_get_rect(ROOT_WINDOW));
+}
+
+void ei_app_set_max_fps(int max_fps) {
+	MAX_FPS = (max_fps > 0) ? max_fps : 0;
+}
+
+void ei_app_set_frame_callbacks(ei_frame_callback_t begin, ei_frame_callback_t end, void *user_param) {
+	FRAME_BEGIN = begin;
+	FRAME_END = end;
+	FRAME_USER_PARAM = user_param;
+}
+
+void ei_app_request_frame(void) {
+	FRAME_REQUESTED = EI_TRUE;
+}
+
+ei_bool_t ei_app_set_stats(const char *filename) {
+	if (filename == NULL) {
+		ei_stats_stop();
+		return EI_TRUE;
+	}
+	return ei_stats_start(filename);
+}
@@ -1,23 +1,158 @@
 #include <stdlib.h>
 
+#include "ei_application.h"
 #include "ei_event.h"
 #include "ei_types.h"
+#include "ei_utils.h"
 #include "ei_widget.h"
 
 #include "ei_application_utils.h"
+#include "ei_arena.h"
+#include "ei_geometry.h"
+#include "ei_pick.h"
+#include "ei_placer_utils.h"
+#include "ei_stats.h"
+#include "ei_widget_utils.h"
 
 /** Global variables **/
 /**                  **/
-ei_surface_t PICK_SURFACE;
+ei_pick_buffer_t *PICK_BUFFER = NULL;
+int PICK_ID_BITS = 0;			///< 16, 32, or 0 to choose 16 bits while the ids allow it
+ei_rect_t PICK_DAMAGE;			///< Union of the areas of the pick surface that are out of date
+ei_bool_t PICK_DAMAGED = EI_FALSE;
+ei_rect_t *CLIPPER_STACK = NULL;	///< Clipper of the children of each level of the drawing traversal
+size_t CLIPPER_STACK_CAPACITY = 0;
 /**                  **/
 /** ---------------- **/
 
-void ei_set_pick_surface(ei_surface_t surface) {
-	PICK_SURFACE = surface;
+void ei_set_pick_buffer(ei_pick_buffer_t *buffer) {
+	PICK_BUFFER = buffer;
 }
 
-ei_surface_t ei_get_pick_surface(void) {
-	return PICK_SURFACE;
+ei_pick_buffer_t *ei_get_pick_buffer(void) {
+	return PICK_BUFFER;
+}
+
+void ei_set_pick_id_bits(int id_bits) {
+	PICK_ID_BITS = id_bits;
+}
+
+void ei_invalidate_pick_rect(ei_rect_t rect) {
+	if (rect.size.width <= 0 || rect.size.height <= 0) {
+		return;
+	}
+	if (PICK_DAMAGED) {
+		PICK_DAMAGE = rect_union(PICK_DAMAGE, rect);
+	} else {
+		PICK_DAMAGE = rect;
+		PICK_DAMAGED = EI_TRUE;
+	}
+}
+
+void ei_update_pick_surface(const ei_point_t *where) {
+	// La géométrie doit être à jour avant de dessiner les ids
+	ei_layout_update();
+	// Passage aux ids 32 bits quand les ids ne tiennent plus sur 16 bits
+	if (PICK_BUFFER->id_bits == 16 && (PICK_ID_BITS == 32 || ei_widget_id_bound() > 0xFFFF)) {
+		ei_pick_buffer_t *buffer = ei_pick_buffer_create(PICK_BUFFER->rect, 32, (ei_bool_t) PICK_BUFFER->shift);
+		ei_pick_buffer_free(PICK_BUFFER);
+		PICK_BUFFER = buffer;
+		PICK_DAMAGED = EI_FALSE;
+		ei_invalidate_pick_rect(PICK_BUFFER->rect);
+	}
+	ei_rect_t samples;
+	double clock;
+	if (!PICK_DAMAGED) {
+		return;
+	}
+	// En demi-résolution, les échantillons voisins lus par ei_pick_buffer_is_exact doivent aussi être à jour
+	samples = rect_intersection(ei_pick_buffer_samples_rect(PICK_BUFFER, where->x, where->y), PICK_DAMAGE);
+	if (samples.size.width <= 0 || samples.size.height <= 0) {
+		return; // La zone périmée n'est pas concernée par la requête
+	}
+	clock = ei_stats_clock();
+	draw_widget_recursively(ei_app_root_widget(), NULL, PICK_BUFFER, &PICK_DAMAGE);
+	PICK_DAMAGED = EI_FALSE;
+	ei_stats_add_time(ei_stats_pick_time, clock);
+}
+
+/**
+ * \brief	Returns true if "where" lies in "rect" (right and bottom edges excluded).
+ */
+static inline ei_bool_t rect_contains(ei_rect_t rect, const ei_point_t *where) {
+	return (ei_bool_t) (where->x >= rect.top_left.x && where->x < rect.top_left.x + rect.size.width &&
+			    where->y >= rect.top_left.y && where->y < rect.top_left.y + rect.size.height);
+}
+
+/**
+ * \brief	Draws the ids of the single pixel "where" at full resolution. Only the widgets whose
+ *		screen_location contains the pixel are drawn, and only the children of the widgets
+ *		whose content_rect contains it are visited, in the order of \ref draw_widget_recursively.
+ */
+static uint32_t pick_exact_id(const ei_point_t *where) {
+	ei_rect_t pixel = ei_rect(*where, ei_size(1, 1));
+	uint32_t exact_id = 0;
+	ei_pick_buffer_t exact = {pixel, 0, 32, 1, 1, &exact_id};
+	ei_widget_t *widget = ei_app_root_widget();
+	ei_arena_mark_t mark;
+
+	while (widget != NULL) {
+		ei_stats_add(ei_stats_visited, 1);
+		if (rect_contains(widget->screen_location, where)) {
+			mark = ei_arena_mark();
+			widget->wclass->drawfunc(widget, NULL, &exact, &pixel);
+			ei_arena_rewind(mark);
+			ei_stats_add(ei_stats_drawn, 1);
+		}
+		if (widget->children_head != NULL && rect_contains(*widget->content_rect, where)) {
+			widget = widget->children_head;
+			continue;
+		}
+		while (widget != NULL && widget->next_sibling == NULL) {
+			widget = widget->parent;
+		}
+		if (widget != NULL) {
+			widget = widget->next_sibling;
+		}
+	}
+	return exact_id;
+}
+
+uint32_t ei_pick_id_at(const ei_point_t *where) {
+	uint32_t id;
+	ei_update_pick_surface(where);
+	id = ei_pick_buffer_get(PICK_BUFFER, where->x, where->y);
+	if (!ei_pick_buffer_is_exact(PICK_BUFFER, where->x, where->y)) {
+		// Demi-résolution, près d'un bord : on redessine le seul pixel demandé, en pleine résolution
+		double clock = ei_stats_clock();
+		id = pick_exact_id(where);
+		ei_stats_add_time(ei_stats_pick_time, clock);
+	}
+	return id;
+}
+
+void dispatch_event(ei_event_t *event) {
+	ei_bool_t event_handled = EI_FALSE;
+	ei_widget_t *active_widget;
+	ei_default_handle_func_t default_handle;
+	if (event->type == ei_ev_mouse_buttondown) { // Set active
+		ei_event_set_active_widget(ei_widget_pick(&event->param.mouse.where));
+	}
+	active_widget = ei_event_get_active_widget();
+	if (active_widget != NULL) {
+		event_handled = active_widget->wclass->handlefunc(active_widget, event);
+	}
+	if (!event_handled && !is_located_event(*event)) {
+		// Si ce n’est pas un évènement situé, le traitant concerné est celui
+		// qui a été défini par le programmeur
+		default_handle = ei_event_get_default_handle_func();
+		if (default_handle != NULL) {
+			default_handle(event);
+		}
+	}
+	if (event->type == ei_ev_mouse_buttonup) { // Unset active
+		ei_event_set_active_widget(NULL);
+	}
 }
 
 ei_bool_t is_located_event(ei_event_t event) {
@@ -43,24 +178,106 @@ ei_rect_t rect_union(ei_rect_t r1, ei_rect_t r2) {
 	return r0;
 }
 
-void draw_widget_recursively(ei_widget_t *widget, ei_surface_t root_window, ei_rect_t *clipper) {
-	// Traitement pour un widget
-	ei_rect_t *current_clipper = malloc(sizeof(ei_rect_t));
-	if (clipper == NULL) {
-		*current_clipper = widget->screen_location;
-	} else {
-		*current_clipper = rect_intersection(*clipper, widget->screen_location);
+ei_bool_t rect_equal(ei_rect_t r1, ei_rect_t r2) {
+	return (ei_bool_t) (r1.top_left.x == r2.top_left.x && r1.top_left.y == r2.top_left.y &&
+			    r1.size.width == r2.size.width && r1.size.height == r2.size.height);
+}
+
+ei_rect_t rect_anchored(ei_rect_t area, ei_size_t size, ei_anchor_t anchor) {
+	// Fraction de l'espace libre laissée à gauche (en haut) du widget
+	float fx = 0.5f, fy = 0.5f;
+	switch (anchor) {
+		case ei_anc_north:
+			fy = 0;
+			break;
+		case ei_anc_northeast:
+			fx = 1;
+			fy = 0;
+			break;
+		case ei_anc_east:
+			fx = 1;
+			break;
+		case ei_anc_southeast:
+			fx = 1;
+			fy = 1;
+			break;
+		case ei_anc_south:
+			fy = 1;
+			break;
+		case ei_anc_southwest:
+			fx = 0;
+			fy = 1;
+			break;
+		case ei_anc_west:
+			fx = 0;
+			break;
+		case ei_anc_northwest:
+			fx = 0;
+			fy = 0;
+			break;
+		default:
+			break;
 	}
-	if (current_clipper->size.width != 0 && current_clipper->size.height != 0) {
-		widget->wclass->drawfunc(widget, root_window, PICK_SURFACE, current_clipper);
+	return ei_rect(ei_point(area.top_left.x + (int) ((area.size.width - size.width) * fx),
+				area.top_left.y + (int) ((area.size.height - size.height) * fy)), size);
+}
+
+/**
+ * \brief	Returns the entry "depth" of the stack of clippers, growing the stack if needed.
+ */
+static ei_rect_t *clipper_at(size_t depth) {
+	if (depth >= CLIPPER_STACK_CAPACITY) {
+		CLIPPER_STACK_CAPACITY = (CLIPPER_STACK_CAPACITY == 0) ? 64 : 2 * CLIPPER_STACK_CAPACITY;
+		CLIPPER_STACK = realloc(CLIPPER_STACK, CLIPPER_STACK_CAPACITY * sizeof(ei_rect_t));
 	}
-	free(current_clipper);
+	return &CLIPPER_STACK[depth];
+}
+
+void draw_widget_recursively(ei_widget_t *widget, ei_surface_t root_window, ei_pick_buffer_t *pick_surface,
+			     ei_rect_t *clipper) {
+	// Parcours préfixe sans récursion : le widget, ses enfants, puis son frère suivant. La pile ne
+	// garde que le clipper de chaque niveau, pour supporter des arbres très larges ou très profonds.
+	// Un parcours linéaire de la table de géométrie marque d'abord les widgets qui touchent le clipper :
+	// les autres sont passés sans lire leurs rectangles.
+	const uint8_t *flags = ei_geometry_table()->flags;
+	ei_widget_t *start = widget;
+	ei_rect_t current_clipper;
+	ei_rect_t children_clipper;
+	ei_arena_mark_t mark;
+	size_t depth = 0;
+	*clipper_at(0) = (clipper == NULL) ? widget->screen_location : *clipper;
+	ei_geometry_cull(&CLIPPER_STACK[0], ei_widget_id_bound());
+
+	while (widget != NULL) {
+		// Traitement pour un widget
+		current_clipper = (flags[widget->pick_id] & ei_geometry_visible) ?
+				  rect_intersection(CLIPPER_STACK[depth], widget->screen_location) : ei_rect_zero();
+		ei_stats_add(ei_stats_visited, 1);
+		if (current_clipper.size.width > 0 && current_clipper.size.height > 0) {
+			mark = ei_arena_mark(); // Les temporaires du dessin (points, côtés) sont rendus après chaque widget
+			widget->wclass->drawfunc(widget, root_window, pick_surface, &current_clipper);
+			ei_arena_rewind(mark);
+			ei_stats_add(ei_stats_drawn, 1);
+		} else {
+			ei_stats_add(ei_stats_culled, 1);
+		}
 
-	// Prochain widget à traiter
-	if (widget->next_sibling != NULL) {
-		draw_widget_recursively(widget->next_sibling, root_window, clipper);
-	} else if (widget->children_head != NULL) {
-		draw_widget_recursively(widget->children_head, root_window, clipper);
+		// Les enfants sont limités à la zone de contenu du parent
+		if (widget->children_head != NULL && (flags[widget->pick_id] & ei_geometry_children_visible)) {
+			children_clipper = rect_intersection(CLIPPER_STACK[depth], *widget->content_rect);
+			if (children_clipper.size.width > 0 && children_clipper.size.height > 0) {
+				*clipper_at(++depth) = children_clipper;
+				widget = widget->children_head;
+				continue;
+			}
+		}
+
+		// Prochain widget à traiter : le frère suivant, ou celui du premier ancêtre qui en a un
+		while (widget != start && widget->next_sibling == NULL) {
+			widget = widget->parent;
+			depth--;
+		}
+		widget = (widget == start) ? NULL : widget->next_sibling;
 	}
 }
 
@@ -69,9 +286,12 @@ void free_root_window(ei_surface_t root_window) {
 	hw_surface_unlock(root_window);
 	hw_surface_free(root_window);
 
-	// Free pick surface
-	hw_surface_unlock(PICK_SURFACE);
-	hw_surface_free(PICK_SURFACE);
+	// Free pick buffer and traversal stack
+	ei_pick_buffer_free(PICK_BUFFER);
+	PICK_BUFFER = NULL;
+	free(CLIPPER_STACK);
+	CLIPPER_STACK = NULL;
+	CLIPPER_STACK_CAPACITY = 0;
 }
 
 ei_rect_t big_union_rect(ei_linked_rect_t *rectangle_list) {
@@ -83,16 +303,3 @@ ei_rect_t big_union_rect(ei_linked_rect_t *rectangle_list) {
 	}
 	return big_rect;
 }
-
-void free_rectangle_list(ei_linked_rect_t *rectangle_list) {
-	if (rectangle_list == NULL) {
-		return;
-	}
-	ei_linked_rect_t *ptr;
-	while (rectangle_list->next != NULL) {
-		ptr = rectangle_list->next;
-		free(rectangle_list);
-		rectangle_list = ptr;
-	}
-	free(rectangle_list);
-}
\ No newline at end of file
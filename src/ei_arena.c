@@ -0,0 +1,114 @@
+#include <stdlib.h>
+
+#include "ei_arena.h"
+
+/**
+ * \brief	Memory of the arena. The blocks are chained: after a rewind, the following blocks
+ *		are kept and reused.
+ */
+typedef struct ei_arena_block_t {
+	struct ei_arena_block_t	*next;
+	size_t			capacity;	///< Bytes available after the header.
+	size_t			used;
+} ei_arena_block_t;
+
+#define ARENA_ALIGN		16
+#define ARENA_HEADER_SIZE	((sizeof(ei_arena_block_t) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+#define ARENA_FIRST_CAPACITY	((size_t) 64 * 1024)
+
+/** Global variables **/
+/**                  **/
+ei_arena_block_t *ARENA_HEAD = NULL;		///< First block of the chain
+ei_arena_block_t *ARENA_CURRENT = NULL;		///< Block where the allocations are made
+size_t ARENA_MALLOC_COUNT = 0;
+/**                  **/
+/** ---------------- **/
+
+static inline size_t max_size(size_t a, size_t b) {
+	return (a > b) ? a : b;
+}
+
+static ei_arena_block_t *new_block(size_t capacity) {
+	ei_arena_block_t *block = malloc(ARENA_HEADER_SIZE + capacity);
+	ARENA_MALLOC_COUNT++;
+	block->next = NULL;
+	block->capacity = capacity;
+	block->used = 0;
+	return block;
+}
+
+static inline char *block_data(ei_arena_block_t *block) {
+	return (char *) block + ARENA_HEADER_SIZE;
+}
+
+void *ei_arena_alloc(size_t size) {
+	size = (size + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1);
+	if (ARENA_CURRENT == NULL) {
+		ARENA_HEAD = new_block(max_size(ARENA_FIRST_CAPACITY, size));
+		ARENA_CURRENT = ARENA_HEAD;
+	}
+	while (ARENA_CURRENT->used + size > ARENA_CURRENT->capacity) {
+		// Bloc suivant (gardé après un rewind) ou nouveau bloc, deux fois plus grand
+		if (ARENA_CURRENT->next == NULL || ARENA_CURRENT->next->capacity < size) {
+			ei_arena_block_t *block = new_block(max_size(2 * ARENA_CURRENT->capacity, size));
+			block->next = ARENA_CURRENT->next;
+			ARENA_CURRENT->next = block;
+		}
+		ARENA_CURRENT = ARENA_CURRENT->next;
+		ARENA_CURRENT->used = 0;
+	}
+	void *ptr = block_data(ARENA_CURRENT) + ARENA_CURRENT->used;
+	ARENA_CURRENT->used += size;
+	return ptr;
+}
+
+ei_arena_mark_t ei_arena_mark(void) {
+	ei_arena_mark_t mark;
+	mark.block = ARENA_CURRENT;
+	mark.used = (ARENA_CURRENT == NULL) ? 0 : ARENA_CURRENT->used;
+	return mark;
+}
+
+void ei_arena_rewind(ei_arena_mark_t mark) {
+	if (mark.block == NULL) { // Marque prise avant la première allocation
+		mark.block = ARENA_HEAD;
+	}
+	ARENA_CURRENT = mark.block;
+	if (ARENA_CURRENT != NULL) {
+		ARENA_CURRENT->used = mark.used;
+	}
+}
+
+void ei_arena_reset(void) {
+	if (ARENA_HEAD == NULL) {
+		return;
+	}
+	if (ARENA_HEAD->next != NULL) { // L'arène a grandi : fusion en un seul bloc
+		size_t capacity = 0;
+		ei_arena_block_t *block = ARENA_HEAD;
+		while (block != NULL) {
+			capacity += block->capacity;
+			block = block->next;
+		}
+		ei_arena_free();
+		ARENA_HEAD = new_block(capacity);
+	}
+	ARENA_HEAD->used = 0;
+	ARENA_CURRENT = ARENA_HEAD;
+}
+
+size_t ei_arena_malloc_count(void) {
+	return ARENA_MALLOC_COUNT;
+}
+
+void ei_arena_free(void) {
+	ei_arena_block_t *block = ARENA_HEAD;
+	ei_arena_block_t *next;
+	while (block != NULL) {
+		next = block->next;
+		free(block);
+		block = next;
+	}
+	ARENA_HEAD = NULL;
+	ARENA_CURRENT = NULL;
+}
@@ -4,20 +4,14 @@
 #include "ei_draw.h"
 #include "ei_types.h"
 
+#include "ei_arena.h"
 #include "ei_button.h"
 #include "ei_draw_utils.h"
+#include "ei_image.h"
 
 void free_points(ei_linked_point_t *ptr) {
-	if (ptr == NULL) {
-		return;
-	}
-	ei_linked_point_t *point;
-	while (ptr->next != NULL) {
-		point = ptr->next;
-		free(ptr);
-		ptr = point;
-	}
-	free(ptr);
+	// Les points sont dans l'arène de la frame : libérés par ei_arena_reset
+	(void) ptr;
 }
 
 ei_linked_point_t *arc(ei_point_t centre,
@@ -33,7 +27,7 @@ ei_linked_point_t *arc(ei_point_t centre,
 			point.y = centre.y + (int) rayon * sin(angle);
 			if (premier == NULL || point.x != premier->point.x || point.y != premier->point.y) {
 			        // ajout si le point est différent du précédent
-				ei_linked_point_t *nouveau = malloc(sizeof(ei_linked_point_t));
+				ei_linked_point_t *nouveau = ei_arena_alloc(sizeof(ei_linked_point_t));
 				nouveau->point = point;
 				nouveau->next = premier;
 				premier = nouveau; // ajout en tete du nouveau point
@@ -48,7 +42,7 @@ ei_linked_point_t *arc(ei_point_t centre,
 			point.y = centre.y + (int) rayon * sin(angle);
 			if (premier == NULL || point.x != premier->point.x || point.y != premier->point.y) {
                                 // ajout si le point est différent du précédent
-				ei_linked_point_t *nouveau = malloc(sizeof(ei_linked_point_t));
+				ei_linked_point_t *nouveau = ei_arena_alloc(sizeof(ei_linked_point_t));
 				nouveau->point = point;
 				nouveau->next = premier;
 				premier = nouveau; // ajout en tete du nouveau point
@@ -115,7 +109,7 @@ ei_linked_point_t *rounded_frame(ei_rect_t rect,
 		ptr = ptr->next;
 	}
 	//On relie le dernier point avec le premier
-	ei_linked_point_t *last = malloc(sizeof(ei_linked_point_t));
+	ei_linked_point_t *last = ei_arena_alloc(sizeof(ei_linked_point_t));
 	last->next = NULL;
 	last->point = premier->point;
 	ptr->next = last;
@@ -131,88 +125,84 @@ void draw_button(ei_surface_t surface,
 		 ei_color_t button_color,
 		 float rayon,
 		 ei_relief_t relief,
-		 ei_bool_t pick) {
+		 const ei_image_t *img,
+		 ei_anchor_t img_anchor) {
 	ei_color_t top_color;
 	ei_color_t bot_color;
-	is_pick_surface = pick;
-	if (pick == EI_TRUE) {
-		ei_linked_point_t *pts = rounded_frame(rect, rayon, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, button_color, clipper);
-		free_points(pts);
-	} else {
-		if (relief == ei_relief_sunken) {
-		        //Couleurs pour un bouton enfoncé
-			top_color.red = button_color.red * 0.9;
-			top_color.green = button_color.green * 0.9;
-			top_color.blue = button_color.blue * 0.9, top_color.alpha = button_color.alpha;
-			if (button_color.red * 1.1 <= 255) {
-                                bot_color.red = button_color.red * 1.1;
-			} else {
-                                bot_color.red = 255;
-			}
-                        if (button_color.green * 1.1 <= 255) {
-                                bot_color.green = button_color.green * 1.1;
-                        } else {
-                                bot_color.red = 255;
-                        }
-                        if (button_color.blue * 1.1 <= 255) {
-                                bot_color.blue = button_color.blue * 1.1;
-                        } else {
-                                bot_color.red = 255;
-                        }
-			bot_color.alpha = button_color.alpha;
+	if (relief == ei_relief_sunken) {
+	        //Couleurs pour un bouton enfoncé
+		top_color.red = button_color.red * 0.9;
+		top_color.green = button_color.green * 0.9;
+		top_color.blue = button_color.blue * 0.9, top_color.alpha = button_color.alpha;
+		if (button_color.red * 1.1 <= 255) {
+                        bot_color.red = button_color.red * 1.1;
 		} else {
-		        //Couleurs pour un bouton relevé
-                        if (button_color.red * 1.1 <= 255) {
-                                top_color.red = button_color.red * 1.1;
-                        } else {
-                                top_color.red = 255;
-                        }
-                        if (button_color.green * 1.1 <= 255) {
-                                top_color.green = button_color.green * 1.1;
-                        } else {
-                                top_color.red = 255;
-                        }
-                        if (button_color.blue * 1.1 <= 255) {
-                                top_color.blue = button_color.blue * 1.1;
-                        } else {
-                                top_color.red = 255;
-                        }
-			top_color.alpha = button_color.alpha;
-			bot_color.red = button_color.red * 0.9;
-			bot_color.green = button_color.green * 0.9;
-			bot_color.blue = button_color.blue * 0.9, bot_color.alpha = button_color.alpha;
+                        bot_color.red = 255;
 		}
-		//Partie haute
-		ei_linked_point_t *pts = rounded_frame(rect, rayon, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, top_color, clipper);
-		free_points(pts);
-
-		//Partie basse
-		pts = rounded_frame(rect, rayon, EI_FALSE, EI_TRUE);
-		ei_draw_polygon(surface, pts, bot_color, clipper);
-		free_points(pts);
-
-		//Partie intérieure
-		rect.top_left.x += rect.size.width / 20;
-		rect.top_left.y += rect.size.height / 20;
-		rect.size.width -= rect.size.width * 2 / 20;
-		rect.size.height -= rect.size.height * 2 / 20;
-		pts = rounded_frame(rect, rayon, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, button_color, clipper);
-		free_points(pts);
-
-		//Texte
-		ei_point_t where;
-		if (relief == ei_relief_raised) {
-                        where.x = rect.top_left.x + rect.size.width * 1.5 / 10;
-                        where.y = rect.top_left.y + rect.size.height * 3 / 10;
-		} else {
-                        where.x = rect.top_left.x + rect.size.width * 1.5 / 10;
-                        where.y = rect.top_left.y + rect.size.height * 3.5 / 10;
+                if (button_color.green * 1.1 <= 255) {
+                        bot_color.green = button_color.green * 1.1;
+                } else {
+                        bot_color.green = 255;
                 }
-
-		ei_draw_text(surface, &where, text, font, text_color, clipper);
+                if (button_color.blue * 1.1 <= 255) {
+                        bot_color.blue = button_color.blue * 1.1;
+                } else {
+                        bot_color.blue = 255;
+                }
+		bot_color.alpha = button_color.alpha;
+	} else {
+	        //Couleurs pour un bouton relevé
+                if (button_color.red * 1.1 <= 255) {
+                        top_color.red = button_color.red * 1.1;
+                } else {
+                        top_color.red = 255;
+                }
+                if (button_color.green * 1.1 <= 255) {
+                        top_color.green = button_color.green * 1.1;
+                } else {
+                        top_color.green = 255;
+                }
+                if (button_color.blue * 1.1 <= 255) {
+                        top_color.blue = button_color.blue * 1.1;
+                } else {
+                        top_color.blue = 255;
+                }
+		top_color.alpha = button_color.alpha;
+		bot_color.red = button_color.red * 0.9;
+		bot_color.green = button_color.green * 0.9;
+		bot_color.blue = button_color.blue * 0.9, bot_color.alpha = button_color.alpha;
 	}
+	//Partie haute
+	ei_linked_point_t *pts = rounded_frame(rect, rayon, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(surface, pts, top_color, clipper);
+
+	//Partie basse
+	pts = rounded_frame(rect, rayon, EI_FALSE, EI_TRUE);
+	ei_draw_polygon(surface, pts, bot_color, clipper);
+
+	//Partie intérieure
+	rect.top_left.x += rect.size.width / 20;
+	rect.top_left.y += rect.size.height / 20;
+	rect.size.width -= rect.size.width * 2 / 20;
+	rect.size.height -= rect.size.height * 2 / 20;
+	pts = rounded_frame(rect, rayon, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(surface, pts, button_color, clipper);
+
+	//Image, à la place du texte
+	if (img != NULL) {
+		ei_image_draw(surface, img, rect, img_anchor, clipper);
+		return;
+	}
+
+	//Texte
+	ei_point_t where;
+	if (relief == ei_relief_raised) {
+                where.x = rect.top_left.x + rect.size.width * 1.5 / 10;
+                where.y = rect.top_left.y + rect.size.height * 3 / 10;
+	} else {
+                where.x = rect.top_left.x + rect.size.width * 1.5 / 10;
+                where.y = rect.top_left.y + rect.size.height * 3.5 / 10;
+        }
 
+	ei_draw_text(surface, &where, text, font, text_color, clipper);
 }
@@ -5,9 +5,15 @@
 #include "hw_interface.h"
 #include "ei_draw.h"
 #include "ei_types.h"
+#include "ei_utils.h"
 
 #include "ei_application_utils.h"
+#include "ei_arena.h"
 #include "ei_draw_utils.h"
+#include "ei_image_cache.h"
+#include "ei_scale.h"
+#include "ei_stats.h"
+#include "ei_surface.h"
 
 /**
 * \brief	Converts the red, green, blue and alpha components of a color into a 32 bits integer
@@ -25,7 +31,7 @@ uint32_t ei_map_rgba(ei_surface_t surface, ei_color_t color) {
         int ir, ig, ib, ia;
 
         /* Obtenir les indices et ordonner dans un tableau */
-        hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+        ei_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
         uint8_t array[4] = {255, 255, 255, 255};
         array[ir] = color.red;
         array[ig] = color.green;
@@ -59,14 +65,18 @@ void ei_draw_polyline(ei_surface_t surface,
                       const ei_rect_t *clipper) {
         int x1, x2, y1, y2, dx, dy, sign_x, sign_y;
         int swap;
+        long written = 0;
+        ei_rect_t view_clipper;
 
+        clipper = ei_surface_clipper(surface, clipper, &view_clipper);
         if (first_point == NULL) {
                 return;
         } else if (first_point->next == NULL) {
                 x1 = first_point->point.x;
                 y1 = first_point->point.y;
 
-                draw_segment_straight(surface, x1, x1, y1, y1, color, clipper);
+                written = draw_segment_straight(surface, x1, x1, y1, y1, color, clipper);
+                ei_stats_add_pixels(surface, written);
                 return;
         }
 
@@ -86,7 +96,7 @@ void ei_draw_polyline(ei_surface_t surface,
                         dx = -dx;
                         sign_x = -1;
                 } else if (dx == 0) {
-                        draw_segment_straight(surface, x1, x2, y1, y2, color, clipper);
+                        written += draw_segment_straight(surface, x1, x2, y1, y2, color, clipper);
                         continue;
                 } else {
                         sign_x = 1;
@@ -95,7 +105,7 @@ void ei_draw_polyline(ei_surface_t surface,
                         dy = -dy;
                         sign_y = -1;
                 } else if (dy == 0) {
-                        draw_segment_straight(surface, x1, x2, y1, y2, color, clipper);
+                        written += draw_segment_straight(surface, x1, x2, y1, y2, color, clipper);
                         continue;
                 } else {
                         sign_y = 1;
@@ -105,8 +115,9 @@ void ei_draw_polyline(ei_surface_t surface,
                 } else {
                         swap = 0;
                 }
-                draw_segment_bresenham(surface, x1, y1, dx, dy, sign_x, sign_y, swap, color, clipper);
+                written += draw_segment_bresenham(surface, x1, y1, dx, dy, sign_x, sign_y, swap, color, clipper);
         }
+        ei_stats_add_pixels(surface, written);
 }
 
 /**
@@ -126,11 +137,15 @@ void ei_draw_polygon(ei_surface_t surface,
                      ei_color_t color,
                      const ei_rect_t *clipper) {
         int y = 0;
-        int height = hw_surface_get_size(surface).height;
-        ei_side_table tc = construct_side_table(surface, first_point);
+        int height = ei_surface_get_size(surface).height;
+        ei_arena_mark_t mark = ei_arena_mark(); // Table des côtés dans l'arène de la frame
+        ei_side_table tc = construct_side_table(height, first_point);
         ei_side *tca = NULL;
-        uint32_t *pixel_ptr = (uint32_t *) hw_surface_get_buffer(surface);
+        uint32_t *pixel_ptr = (uint32_t *) ei_surface_get_buffer(surface);
+        long written = 0;
+        ei_rect_t view_clipper;
 
+        clipper = ei_surface_clipper(surface, clipper, &view_clipper);
         while (((tc.length != 0) || (tca != NULL)) && y < height) {
                 // Déplacer les côtés de TC(y) dans TCA
                 move_sides_to_tca(&tc, y, &tca);
@@ -143,7 +158,7 @@ void ei_draw_polygon(ei_surface_t surface,
 
                 // Modifier les pixels de l’image sur la scanline, dans les intervalles intérieurs au polygone
                 // pixel_ptr est placée à la prochaine scanline à la fin de draw_scanline
-                draw_scanline(surface, &pixel_ptr, tca, y, color, clipper);
+                written += draw_scanline(surface, &pixel_ptr, tca, y, color, clipper);
 
                 // Incrémenter y
                 y++;
@@ -151,14 +166,9 @@ void ei_draw_polygon(ei_surface_t surface,
                 // Mettre à jour les abscisses d’intersections des côtés de TCA avec la nouvelle scanline
                 update_scanline(tca, y);
         }
-	ei_side *ptr;
-	while (tca != NULL && tca->next != NULL) {
-		ptr = tca->next;
-		free(tca);
-		tca = ptr;
-	}
-	free(tca);
-        free(tc.array);
+        ei_arena_rewind(mark);
+        ei_stats_add(ei_stats_polygons, 1);
+        ei_stats_add_pixels(surface, written);
 }
 
 /**
@@ -222,6 +232,8 @@ void ei_draw_text(ei_surface_t surface,
                 dst_rect.size = size;
         }
 
+        ei_stats_add(ei_stats_texts, 1); // Les pixels sont comptés par ei_copy_surface
+
         // Create surface, then lock it
         text_surface = hw_text_create_surface(text, font, color);
         hw_surface_lock(text_surface);
@@ -250,18 +262,50 @@ void ei_draw_text(ei_surface_t surface,
 void ei_fill(ei_surface_t surface,
              const ei_color_t *color,
              const ei_rect_t *clipper) {
-        ei_size_t size = hw_surface_get_size(surface);
-        uint32_t *pixel_ptr;
-        ei_bool_t alpha = EI_TRUE;
-        int x, y;
+        int stride = ei_surface_get_stride(surface) / 4;
+        ei_rect_t filled = ei_rect(ei_point_zero(), ei_surface_get_size(surface));
+        uint32_t value = 0, keep = 0; // Couleur NULL : pixels mis à 0
+        uint32_t *row;
+        int ir, ig, ib, ia, x, y;
 
-        pixel_ptr = (uint32_t *) hw_surface_get_buffer(surface);
-        for (y = 0; y < size.height; y++) {
-                for (x = 0; x < size.width; x++){
-                        draw_pixel(surface, pixel_ptr, x, y, color, clipper, alpha);
-                        pixel_ptr++;
+        // Les bords du clipper sont inclus (voir point_in_clipper)
+        if (clipper != NULL) {
+                filled = rect_intersection(filled, ei_rect(clipper->top_left, ei_size(clipper->size.width + 1,
+                                                                                     clipper->size.height + 1)));
+        }
+        if (filled.size.width > 0 && filled.size.height > 0) {
+                row = (uint32_t *) ei_surface_get_buffer(surface) + (size_t) filled.top_left.y * stride +
+                      filled.top_left.x;
+                if (color != NULL && color->alpha != 255) {
+                        // Couleur transparente : mélange pixel par pixel
+                        for (y = 0; y < filled.size.height; y++, row += stride) {
+                                for (x = 0; x < filled.size.width; x++) {
+                                        row[x] = add_pixels(surface, NULL, (ei_color_t *) color, surface, &row[x],
+                                                            EI_TRUE);
+                                }
+                        }
+                } else {
+                        // Couleur opaque : valeur constante, l'alpha de la surface est conservé
+                        if (color != NULL) {
+                                value = ei_map_rgba(surface, *color);
+                                ei_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+                                if (ia != -1) {
+                                        keep = (uint32_t) 0xff << (8 * ia);
+                                        value &= ~keep;
+                                }
+                        }
+                        for (y = 0; y < filled.size.height; y++, row += stride) {
+                                fill_row(row, filled.size.width, value, keep);
+                        }
                 }
         }
+        if (ei_stats_is_active()) {
+                ei_rect_t area = ei_surface_get_rect(surface);
+                if (clipper != NULL) {
+                        area = rect_intersection(area, *clipper);
+                }
+                ei_stats_add_pixels(surface, (long) max(area.size.width, 0) * max(area.size.height, 0));
+        }
 }
 
 
@@ -291,12 +335,15 @@ int ei_copy_surface(ei_surface_t destination,
                     ei_surface_t source,
                     const ei_rect_t *src_rect,
                     ei_bool_t alpha) {
-        int x, y, dst_x0, dst_y0, src_x0, src_y0, dst_newline = 0, src_newline = 0;
+        int x, y, dst_x0, dst_y0, src_x0, src_y0;
         int dst_width, dst_height, src_width, src_height;
-        ei_size_t dst_size = hw_surface_get_size(destination);
-        ei_size_t src_size = hw_surface_get_size(source);
-        uint32_t *dst_pixel = (uint32_t *) hw_surface_get_buffer(destination);
-        uint32_t *src_pixel = (uint32_t *) hw_surface_get_buffer(source);
+        ei_size_t dst_size = ei_surface_get_size(destination);
+        ei_size_t src_size = ei_surface_get_size(source);
+        int dst_stride = ei_surface_get_stride(destination) / 4;
+        int src_stride = ei_surface_get_stride(source) / 4;
+        int dst_newline = dst_stride - dst_size.width, src_newline = src_stride - src_size.width;
+        uint32_t *dst_pixel = (uint32_t *) ei_surface_get_buffer(destination);
+        uint32_t *src_pixel = (uint32_t *) ei_surface_get_buffer(source);
 
         // Définition des tailles
         if (dst_rect == NULL) {
@@ -308,8 +355,8 @@ int ei_copy_surface(ei_surface_t destination,
                 // Positionnement du pixel sur dst_rect->top_left
                 dst_x0 = dst_rect->top_left.x;
                 dst_y0 = dst_rect->top_left.y;
-                dst_pixel += dst_x0 + (dst_size.width * dst_y0);
-                dst_newline = dst_size.width - dst_rect->size.width; // incrément pour passer à la ligne suivante
+                dst_pixel += dst_x0 + (dst_stride * dst_y0);
+                dst_newline = dst_stride - dst_rect->size.width; // incrément pour passer à la ligne suivante
         }
         if (src_rect == NULL) {
                 src_width = src_size.width;
@@ -320,8 +367,8 @@ int ei_copy_surface(ei_surface_t destination,
                 // Positionnement du pixel sur src_rect->top_left
                 src_x0 = src_rect->top_left.x;
                 src_y0 = src_rect->top_left.y;
-                src_pixel += src_x0 + (src_size.width * src_y0);
-                src_newline = src_size.width - src_rect->size.width; // incrément pour passer à la ligne suivante
+                src_pixel += src_x0 + (src_stride * src_y0);
+                src_newline = src_stride - src_rect->size.width; // incrément pour passer à la ligne suivante
         }
 
         // Vérification des tailles
@@ -339,5 +386,74 @@ int ei_copy_surface(ei_surface_t destination,
                 dst_pixel += dst_newline;
                 src_pixel += src_newline;
         }
+        ei_stats_add_pixels(destination, (long) src_width * src_height);
+        return 0;
+}
+
+int ei_copy_surface_scaled(ei_surface_t destination,
+                           const ei_rect_t *dst_rect,
+                           ei_surface_t source,
+                           const ei_rect_t *src_rect,
+                           ei_filter_t filter,
+                           ei_bool_t alpha) {
+        ei_size_t dst_size = ei_surface_get_size(destination);
+        ei_size_t src_size = ei_surface_get_size(source);
+        int dst_stride = ei_surface_get_stride(destination) / 4;
+        int src_stride = ei_surface_get_stride(source) / 4;
+        ei_rect_t dst_area = (dst_rect == NULL) ? ei_rect(ei_point_zero(), dst_size) : *dst_rect;
+        ei_rect_t src_area = ei_rect(ei_point_zero(), src_size);
+        ei_rect_t visible;
+        const uint32_t *scaled;
+        uint32_t *owned = NULL;
+        uint32_t *dst_pixel;
+        const uint32_t *src_pixel;
+        int stride, x, y;
+
+        if (src_rect != NULL) {
+                src_area = rect_intersection(src_area, *src_rect);
+        }
+        if (src_area.size.width <= 0 || src_area.size.height <= 0 ||
+            dst_area.size.width <= 0 || dst_area.size.height <= 0) {
+                return 1;
+        }
+
+        // Pixels à la taille de la destination : source directe, cache des images, ou rééchantillonnage
+        if (src_area.size.width == dst_area.size.width && src_area.size.height == dst_area.size.height) {
+                scaled = (const uint32_t *) ei_surface_get_buffer(source) + (size_t) src_area.top_left.y * src_stride +
+                         src_area.top_left.x;
+                stride = src_stride;
+        } else {
+                scaled = ei_image_cache_scaled(source, src_area, dst_area.size, filter, &stride);
+                if (scaled == NULL) {
+                        owned = ei_surface_alloc_pixels(dst_area.size, &stride);
+                        stride /= 4;
+                        ei_scale_pixels(owned, stride, dst_area.size,
+                                        (const uint32_t *) ei_surface_get_buffer(source) +
+                                        (size_t) src_area.top_left.y * src_stride + src_area.top_left.x,
+                                        src_stride, src_area.size, filter);
+                        scaled = owned;
+                }
+        }
+
+        // Copie de la partie visible
+        visible = rect_intersection(dst_area, ei_rect(ei_point_zero(), dst_size));
+        for (y = 0; y < visible.size.height; y++) {
+                dst_pixel = (uint32_t *) ei_surface_get_buffer(destination) +
+                            (size_t) (visible.top_left.y + y) * dst_stride + visible.top_left.x;
+                src_pixel = scaled + (size_t) (visible.top_left.y - dst_area.top_left.y + y) * stride +
+                            (visible.top_left.x - dst_area.top_left.x);
+                if (!alpha) {
+                        memcpy(dst_pixel, src_pixel, visible.size.width * sizeof(uint32_t));
+                        continue;
+                }
+                for (x = 0; x < visible.size.width; x++) {
+                        dst_pixel[x] = add_pixels(source, (uint32_t *) &src_pixel[x], NULL, destination, &dst_pixel[x],
+                                                  alpha);
+                }
+        }
+        ei_surface_free_pixels(owned);
+        if (visible.size.width > 0 && visible.size.height > 0) {
+                ei_stats_add_pixels(destination, (long) visible.size.width * visible.size.height);
+        }
         return 0;
 }
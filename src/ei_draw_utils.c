@@ -1,24 +1,28 @@
+#include <limits.h>
 #include <stdint.h>
 #include <stdlib.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "hw_interface.h"
 #include "ei_draw.h"
 #include "ei_types.h"
 
+#include "ei_arena.h"
 #include "ei_draw_utils.h"
-
-/** Global variables **/
-/**                  **/
-ei_bool_t is_pick_surface = EI_FALSE;
-/**                  **/
-/** ---------------- **/
+#include "ei_surface.h"
 
 ei_color_t pixel_to_rgba(ei_surface_t surface, uint32_t pixel) {
 	int ir, ig, ib, ia;
 	ei_color_t color;
 
 	/* Obtenir les indices et ranger dans un tableau */
-	hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+	ei_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
 	int array[4] = {0, 8, 16, 24};
 	color.red = (unsigned char) (pixel >> array[ir]) & 0x000000FF;
 	color.green = (unsigned char) (pixel >> array[ig]) & 0x000000FF;
@@ -42,19 +46,21 @@ ei_bool_t point_in_clipper(int x, int y, const ei_rect_t *clipper) {
 	}
 }
 
-void draw_pixel(ei_surface_t surface, uint32_t *pixel_ptr, int x, int y, ei_color_t *color, const ei_rect_t *clipper, ei_bool_t alpha) {
-	if (point_in_clipper(x, y, clipper)) {
-		if (color == NULL) {
-			*pixel_ptr = (uint32_t) 0x00000000;
-		} else {
-			*pixel_ptr = add_pixels(surface, NULL, color, surface, pixel_ptr, alpha);
-		}
+int draw_pixel(ei_surface_t surface, uint32_t *pixel_ptr, int x, int y, ei_color_t *color, const ei_rect_t *clipper, ei_bool_t alpha) {
+	if (!point_in_clipper(x, y, clipper)) {
+		return 0;
 	}
+	if (color == NULL) {
+		*pixel_ptr = (uint32_t) 0x00000000;
+	} else {
+		*pixel_ptr = add_pixels(surface, NULL, color, surface, pixel_ptr, alpha);
+	}
+	return 1;
 }
 
 uint32_t add_pixels(ei_surface_t source, uint32_t *src_pixel, ei_color_t *src_color, ei_surface_t destination, uint32_t *dst_pixel, ei_bool_t alpha) {
 	uint32_t result;
-	if (!is_pick_surface && alpha) { // Use additive transparency
+	if (alpha) { // Use additive transparency
 		ei_color_t src;
 		ei_color_t dst = pixel_to_rgba(destination, *dst_pixel);
 		if (src_color == NULL) {
@@ -78,28 +84,72 @@ uint32_t add_pixels(ei_surface_t source, uint32_t *src_pixel, ei_color_t *src_co
 	}
 }
 
-void draw_segment_straight(ei_surface_t surface,
-			   int x1, int x2, int y1, int y2,
-			   ei_color_t color,
-			   const ei_rect_t *clipper) {
-	int width = hw_surface_get_size(surface).width;
-	int i, sign = 1, incr;
-	uint32_t *pixel_ptr = (uint32_t *) hw_surface_get_buffer(surface);
+void fill_row(uint32_t *row, int width, uint32_t value, uint32_t keep) {
+	int x = 0;
+#if defined(__AVX2__)
+	__m256i v = _mm256_set1_epi32((int) value);
+	__m256i k = _mm256_set1_epi32((int) keep);
+
+	// Pixels précédant la première adresse alignée
+	for (; x < width && ((uintptr_t) (row + x) & 31) != 0; x++) {
+		row[x] = (row[x] & keep) | value;
+	}
+	if (keep == 0) {
+		for (; x + 8 <= width; x += 8) {
+			_mm256_store_si256((__m256i *) (row + x), v);
+		}
+	} else {
+		for (; x + 8 <= width; x += 8) {
+			__m256i p = _mm256_load_si256((const __m256i *) (row + x));
+			_mm256_store_si256((__m256i *) (row + x), _mm256_or_si256(_mm256_and_si256(p, k), v));
+		}
+	}
+#elif defined(__SSE2__)
+	__m128i v = _mm_set1_epi32((int) value);
+	__m128i k = _mm_set1_epi32((int) keep);
+
+	// Pixels précédant la première adresse alignée
+	for (; x < width && ((uintptr_t) (row + x) & 15) != 0; x++) {
+		row[x] = (row[x] & keep) | value;
+	}
+	if (keep == 0) {
+		for (; x + 4 <= width; x += 4) {
+			_mm_store_si128((__m128i *) (row + x), v);
+		}
+	} else {
+		for (; x + 4 <= width; x += 4) {
+			__m128i p = _mm_load_si128((const __m128i *) (row + x));
+			_mm_store_si128((__m128i *) (row + x), _mm_or_si128(_mm_and_si128(p, k), v));
+		}
+	}
+#endif
+	for (; x < width; x++) {
+		row[x] = (row[x] & keep) | value;
+	}
+}
+
+int draw_segment_straight(ei_surface_t surface,
+			  int x1, int x2, int y1, int y2,
+			  ei_color_t color,
+			  const ei_rect_t *clipper) {
+	int stride = ei_surface_get_stride(surface) / 4;
+	int i, sign = 1, incr, written = 0;
+	uint32_t *pixel_ptr = (uint32_t *) ei_surface_get_buffer(surface);
 	ei_bool_t alpha = EI_TRUE;
 
 	/* On positionne le pointeur au départ (x1, y1) */
-	pixel_ptr += x1 + (y1*width);
+	pixel_ptr += x1 + (y1*stride);
 
 	if (x1 == x2) { // Ligne verticale
 		int dy = y2 - y1;
-		incr = width;
+		incr = stride;
 		if (dy < 0) { // Parcours des pixels à l'envers
 			dy = -dy;
 			incr = -incr;
 			sign = -1;
 		}
 		for (i = 0; i <= dy; i++) {
-			draw_pixel(surface, pixel_ptr, x1, y1 + (sign * i), &color, clipper, alpha);
+			written += draw_pixel(surface, pixel_ptr, x1, y1 + (sign * i), &color, clipper, alpha);
 			pixel_ptr += incr; // y += 1
 		}
 	} else { // Ligne horizontale
@@ -112,29 +162,30 @@ void draw_segment_straight(ei_surface_t surface,
 			sign = -1;
 		}
 		for (i = 0; i <= dx; i++) {
-			draw_pixel(surface, pixel_ptr, x1 + (sign * i), y1, &color, clipper, alpha);
+			written += draw_pixel(surface, pixel_ptr, x1 + (sign * i), y1, &color, clipper, alpha);
 			pixel_ptr += incr; // x += 1
 		}
 	}
+	return written;
 }
 
-void draw_segment_bresenham(ei_surface_t surface,
-			    int x1, int y1, int dx, int dy, int sign_x, int sign_y, int swap,
-			    ei_color_t color,
-			    const ei_rect_t *clipper) {
-	int width = hw_surface_get_size(surface).width;
-	int i, j = 0;
-	int incr_x = sign_x, incr_y = (sign_y) * width; // Parcours des pixels à l'endroit ou non
+int draw_segment_bresenham(ei_surface_t surface,
+			   int x1, int y1, int dx, int dy, int sign_x, int sign_y, int swap,
+			   ei_color_t color,
+			   const ei_rect_t *clipper) {
+	int stride = ei_surface_get_stride(surface) / 4;
+	int i, j = 0, written = 0;
+	int incr_x = sign_x, incr_y = (sign_y) * stride; // Parcours des pixels à l'endroit ou non
 	int E = 0;
-	uint32_t *pixel_ptr = (uint32_t *) hw_surface_get_buffer(surface);
+	uint32_t *pixel_ptr = (uint32_t *) ei_surface_get_buffer(surface);
 	ei_bool_t alpha = EI_TRUE;
 
 	/* On positionne le pointeur au départ (x1, y1) */
-	pixel_ptr += x1 + (y1*width);
+	pixel_ptr += x1 + (y1*stride);
 
 	if (swap == 0) {
 		for (i = 0; i <= dx; i++) {
-			draw_pixel(surface, pixel_ptr, x1 + (sign_x * i), y1 + (sign_y * j), &color, clipper, alpha);
+			written += draw_pixel(surface, pixel_ptr, x1 + (sign_x * i), y1 + (sign_y * j), &color, clipper, alpha);
 			pixel_ptr += incr_x; // x+= 1
 			E += dy;
 			if (2 * E > dx) {
@@ -145,7 +196,7 @@ void draw_segment_bresenham(ei_surface_t surface,
 		}
 	} else { // On inverse x et y
 		for (i = 0; i <= dy; i++) {
-			draw_pixel(surface, pixel_ptr, x1 + (sign_x * j), y1 + (sign_y * i), &color, clipper, alpha);
+			written += draw_pixel(surface, pixel_ptr, x1 + (sign_x * j), y1 + (sign_y * i), &color, clipper, alpha);
 			pixel_ptr += incr_y; // y+= 1 (swap)
 			E += dx;
 			if (2 * E > dy) {
@@ -155,12 +206,13 @@ void draw_segment_bresenham(ei_surface_t surface,
 			}
 		}
 	}
+	return written;
 }
 
-ei_side_table construct_side_table(ei_surface_t surface, const ei_linked_point_t *first_point) {
-	int i, x1, x2, y1, y2, tmp, height = hw_surface_get_size(surface).height;
+ei_side_table construct_side_table(int height, const ei_linked_point_t *first_point) {
+	int i, x1, x2, y1, y2, tmp;
 	const ei_linked_point_t *ptr;
-	ei_side **array = malloc(height * sizeof(ei_side*));
+	ei_side **array = ei_arena_alloc(height * sizeof(ei_side*));
 	for (i = 0; i < height; i++) {
 		array[i] = NULL;
 	}
@@ -181,10 +233,10 @@ ei_side_table construct_side_table(ei_surface_t surface, const ei_linked_point_t
 			x1 = x2;
 			x2 = tmp;
 		}
-		if (y1 > height || y1 < 0) {
+		if (y1 >= height || y1 < 0) {
 			continue;
 		}
-		ei_side *side = malloc(sizeof(ei_side));
+		ei_side *side = ei_arena_alloc(sizeof(ei_side));
 		side->ymax = y2;
 		side->x_ymin = x1;
 		side->dx = x2 - x1;
@@ -227,8 +279,7 @@ void delete_ymax_from_tca(ei_side **tca, int y) {
 	while (ptr != NULL && ptr->next != NULL) {
 		if (ptr->next->ymax == y) {
 			ei_side *to_delete = ptr->next;
-			ptr->next = to_delete->next;
-			free(to_delete);
+			ptr->next = to_delete->next; // Mémoire dans l'arène, rendue par l'appelant
 		} else {
 			ptr = ptr->next;
 		}
@@ -272,9 +323,16 @@ void sort_side_table(ei_side *side) {
 	}
 }
 
-void draw_scanline(ei_surface_t surface, uint32_t **pixel_ptr, ei_side *tca, int y, ei_color_t color,
-		   const ei_rect_t *clipper) {
-	int drawing = 0, x;
+int draw_scanline(ei_surface_t surface, uint32_t **pixel_ptr, ei_side *tca, int y, ei_color_t color,
+		  const ei_rect_t *clipper) {
+	int drawing = 0, x, written = 0;
+	int x_min = INT_MIN, x_max = INT_MAX;
+	ei_bool_t visible = EI_TRUE;
+	if (clipper != NULL) {
+		visible = (ei_bool_t) (y >= clipper->top_left.y && y < clipper->top_left.y + clipper->size.height);
+		x_min = clipper->top_left.x;
+		x_max = clipper->top_left.x + clipper->size.width;
+	}
 	ei_bool_t alpha = EI_TRUE;
 	ei_side sent = {0, 0, 0, 0, 0, tca};
 	ei_side *ptr;
@@ -285,13 +343,17 @@ void draw_scanline(ei_surface_t surface, uint32_t **pixel_ptr, ei_side *tca, int
 				draw_pixel(surface, *pixel_ptr, x, y, &color, clipper, alpha);
 				*pixel_ptr += 1;
 			}
+			if (visible) {
+				written += max(0, min(ptr->next->x_ymin, x_max) - max(ptr->x_ymin, x_min));
+			}
 			drawing = 0;
 		} else {
 			*pixel_ptr += (ptr->next->x_ymin) - (ptr->x_ymin);
 			drawing = 1;
 		}
 	}
-	*pixel_ptr += hw_surface_get_size(surface).width - ptr->x_ymin; // pixel_ptr sur la prochaine scanline
+	*pixel_ptr += ei_surface_get_stride(surface) / 4 - ptr->x_ymin; // pixel_ptr sur la prochaine scanline
+	return written;
 }
 
 ei_point_t find_intersection(int y, ei_side *side) {
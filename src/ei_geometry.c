@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+
+#include "ei_geometry.h"
+
+/** Global variables **/
+/**                  **/
+ei_geometry_table_t GEOMETRY = { { NULL, NULL, NULL, NULL }, { NULL, NULL, NULL, NULL }, NULL, NULL, 0 };
+/**                  **/
+/** ---------------- **/
+
+const ei_geometry_table_t *ei_geometry_table(void) {
+	return &GEOMETRY;
+}
+
+/**
+ * \brief	Grows "*array" from "old" to "capacity" entries of "size" bytes, new entries set to 0.
+ */
+static void grow(void **array, size_t size, uint32_t old, uint32_t capacity) {
+	*array = realloc(*array, capacity * size);
+	memset((char *) *array + old * size, 0, (capacity - old) * size);
+}
+
+static void grow_rects(ei_geometry_rects_t *rects, uint32_t old, uint32_t capacity) {
+	grow((void **) &rects->x0, sizeof(int32_t), old, capacity);
+	grow((void **) &rects->y0, sizeof(int32_t), old, capacity);
+	grow((void **) &rects->x1, sizeof(int32_t), old, capacity);
+	grow((void **) &rects->y1, sizeof(int32_t), old, capacity);
+}
+
+/**
+ * \brief	Writes "rect" to the entry "id" of "rects".
+ */
+static void set_rect(ei_geometry_rects_t *rects, uint32_t id, ei_rect_t rect) {
+	rects->x0[id] = rect.top_left.x;
+	rects->y0[id] = rect.top_left.y;
+	rects->x1[id] = rect.top_left.x + rect.size.width;
+	rects->y1[id] = rect.top_left.y + rect.size.height;
+}
+
+/**
+ * \brief	Frees the arrays of "rects".
+ */
+static void free_rects(ei_geometry_rects_t *rects) {
+	free(rects->x0);
+	free(rects->y0);
+	free(rects->x1);
+	free(rects->y1);
+}
+
+void ei_geometry_reserve(uint32_t capacity) {
+	uint32_t old = GEOMETRY.capacity;
+	if (capacity <= old) {
+		return;
+	}
+	grow_rects(&GEOMETRY.screen, old, capacity);
+	grow_rects(&GEOMETRY.content, old, capacity);
+	grow((void **) &GEOMETRY.parent, sizeof(uint32_t), old, capacity);
+	grow((void **) &GEOMETRY.flags, sizeof(uint8_t), old, capacity);
+	GEOMETRY.capacity = capacity;
+}
+
+void ei_geometry_attach(ei_widget_t *widget) {
+	uint32_t id = widget->pick_id;
+	GEOMETRY.parent[id] = (widget->parent != NULL) ? widget->parent->pick_id : 0;
+	GEOMETRY.flags[id] = 0;
+	ei_geometry_sync(widget);
+}
+
+void ei_geometry_release(uint32_t id) {
+	set_rect(&GEOMETRY.screen, id, ei_rect_zero());
+	set_rect(&GEOMETRY.content, id, ei_rect_zero());
+	GEOMETRY.parent[id] = 0;
+	GEOMETRY.flags[id] = 0;
+}
+
+void ei_geometry_sync(ei_widget_t *widget) {
+	set_rect(&GEOMETRY.screen, widget->pick_id, widget->screen_location);
+	set_rect(&GEOMETRY.content, widget->pick_id, *widget->content_rect);
+}
+
+void ei_geometry_cull(const ei_rect_t *clipper, uint32_t bound) {
+	const int32_t *restrict sx0 = GEOMETRY.screen.x0, *restrict sy0 = GEOMETRY.screen.y0;
+	const int32_t *restrict sx1 = GEOMETRY.screen.x1, *restrict sy1 = GEOMETRY.screen.y1;
+	const int32_t *restrict cx0 = GEOMETRY.content.x0, *restrict cy0 = GEOMETRY.content.y0;
+	const int32_t *restrict cx1 = GEOMETRY.content.x1, *restrict cy1 = GEOMETRY.content.y1;
+	uint8_t *restrict flags = GEOMETRY.flags;
+	int32_t left = clipper->top_left.x;
+	int32_t top = clipper->top_left.y;
+	int32_t right = left + clipper->size.width;
+	int32_t bottom = top + clipper->size.height;
+	uint32_t id;
+
+	// Sans branchement : comparaisons combinées par des "et" binaires, vectorisées par le compilateur
+	for (id = 0; id < bound; id++) {
+		flags[id] = (uint8_t) (((sx0[id] < sx1[id]) & (sy0[id] < sy1[id]) &
+					(sx0[id] < right) & (sx1[id] > left) & (sy0[id] < bottom) & (sy1[id] > top)) |
+				       (((cx0[id] < cx1[id]) & (cy0[id] < cy1[id]) &
+					 (cx0[id] < right) & (cx1[id] > left) & (cy0[id] < bottom) & (cy1[id] > top)) << 1));
+	}
+}
+
+void ei_geometry_free(void) {
+	free_rects(&GEOMETRY.screen);
+	free_rects(&GEOMETRY.content);
+	free(GEOMETRY.parent);
+	free(GEOMETRY.flags);
+	memset(&GEOMETRY, 0, sizeof(GEOMETRY));
+}
@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "ei_application.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+#include "ei_grid.h"
+
+#include "ei_application_utils.h"
+#include "ei_arena.h"
+#include "ei_manager_utils.h"
+#include "ei_placer_utils.h"
+
+/**
+ * \brief	Configures the geometry of a widget using the "grid" geometry manager: the widget is
+ *		put in a cell of a table of rows and columns that fills its parent's *content_rect*,
+ *		from its top-left corner.
+ *
+ * @param	widget		The widget to place.
+ * @param	row		The row of the cell, from 0 (defaults to 0).
+ * @param	column		The column of the cell, from 0 (defaults to 0).
+ * @param	anchor		Where to put the widget in its cell, when the cell is larger than the
+ *				widget (defaults to ei_anc_center).
+ */
+void ei_grid(struct ei_widget_t *widget, int *row, int *column, ei_anchor_t *anchor) {
+	ei_manager_cell_t *cell = ei_manager_attach(widget, ei_manager_grid);
+	if (row != NULL && *row >= 0) {
+		cell->row = *row;
+	}
+	if (column != NULL && *column >= 0) {
+		cell->column = *column;
+	}
+	if (anchor != NULL && *anchor != ei_anc_none) {
+		cell->anchor = *anchor;
+	}
+}
+
+/**
+ * \brief	Configures the grid of a container.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	spacing		Space between two rows and between two columns (defaults to 0).
+ */
+void ei_grid_configure(struct ei_widget_t *container, int *spacing) {
+	ei_manager_t *manager = ei_manager_get(container, ei_manager_grid);
+	if (spacing != NULL) {
+		manager->spacing = *spacing;
+	}
+	ei_manager_changed(container, manager);
+}
+
+/**
+ * \brief	Removes a widget from the grid of its parent, and from the screen.
+ *
+ * @param	widget		The widget to remove from screen.
+ */
+void ei_grid_forget(struct ei_widget_t *widget) {
+	if (widget->placer_params != NULL) {
+		ei_app_invalidate_rect(&widget->screen_location);
+	}
+	ei_placer_forget(widget); // Quitte aussi la grille
+}
+
+/**
+ * \brief	Grows the arrays "*size" and "*pos" of the columns (or rows) to hold at least "length" integers.
+ */
+static void reserve(int **size, int **pos, int *capacity, int length) {
+	if (length > *capacity) {
+		*capacity = max(length, 2 * *capacity);
+		*size = realloc(*size, *capacity * sizeof(int));
+		*pos = realloc(*pos, *capacity * sizeof(int));
+	}
+}
+
+/**
+ * \brief	Computes the position of the columns (or rows) from their size. Sets "moved[i]" if the
+ * 		size or the position of the column i changed since the last layout.
+ */
+static void place_tracks(const int *size, int count, int spacing, int *track_size, int *track_pos, int old_count,
+			 char *moved) {
+	int pos = 0;
+	int i;
+	for (i = 0; i < count; i++) {
+		moved[i] = (char) (i >= old_count || track_pos[i] != pos || track_size[i] != size[i]);
+		track_pos[i] = pos;
+		track_size[i] = size[i];
+		pos += size[i] + spacing;
+	}
+}
+
+void grid_layout(ei_manager_t *manager) {
+	ei_manager_cell_t *cell;
+	ei_arena_mark_t mark;
+	int *width, *height;
+	char *column_moved, *row_moved;
+	int columns = 0, rows = 0;
+	int i;
+
+	if (!manager->dirty) {
+		return;
+	}
+	manager->dirty = EI_FALSE;
+	for (i = 0; i < manager->length; i++) {
+		columns = max(columns, manager->cells[i].column + 1);
+		rows = max(rows, manager->cells[i].row + 1);
+	}
+	mark = ei_arena_mark();
+	width = ei_arena_alloc(columns * sizeof(int));
+	height = ei_arena_alloc(rows * sizeof(int));
+	column_moved = ei_arena_alloc(columns);
+	row_moved = ei_arena_alloc(rows);
+	memset(width, 0, columns * sizeof(int));
+	memset(height, 0, rows * sizeof(int));
+
+	// Mesure : seules les cellules modifiées relisent la taille demandée du widget
+	for (i = 0; i < manager->length; i++) {
+		cell = &manager->cells[i];
+		if (cell->changed) {
+			cell->measured = cell->widget->requested_size;
+		}
+		width[cell->column] = max(width[cell->column], cell->measured.width);
+		height[cell->row] = max(height[cell->row], cell->measured.height);
+	}
+
+	// Colonnes et lignes dont la taille ou la position a changé
+	reserve(&manager->column_width, &manager->column_x, &manager->column_capacity, columns);
+	reserve(&manager->row_height, &manager->row_y, &manager->row_capacity, rows);
+	place_tracks(width, columns, manager->spacing, manager->column_width, manager->column_x, manager->columns,
+		     column_moved);
+	place_tracks(height, rows, manager->spacing, manager->row_height, manager->row_y, manager->rows, row_moved);
+	manager->columns = columns;
+	manager->rows = rows;
+
+	// Seuls les widgets de ces lignes et colonnes, ou modifiés, sont replacés
+	for (i = 0; i < manager->length; i++) {
+		cell = &manager->cells[i];
+		if (cell->changed || column_moved[cell->column] || row_moved[cell->row]) {
+			place_in_parent(cell->widget, rect_anchored(
+				ei_rect(ei_point(manager->column_x[cell->column], manager->row_y[cell->row]),
+					ei_size(manager->column_width[cell->column], manager->row_height[cell->row])),
+				cell->measured, cell->anchor));
+			cell->changed = EI_FALSE;
+		}
+	}
+	ei_arena_rewind(mark);
+}
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "hw_interface.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+
+#include "ei_application_utils.h"
+#include "ei_image.h"
+#include "ei_stats.h"
+#include "ei_surface.h"
+
+/**
+ * \brief	Returns the position in bits of the red, green, blue and alpha components of the pixels
+ * 		of "surface". Without alpha channel, the position of the alpha is the unused byte.
+ */
+static void channel_shifts(ei_surface_t surface, int shifts[3], int *alpha_shift) {
+	int ir, ig, ib, ia;
+	ei_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+	shifts[0] = 8 * ir;
+	shifts[1] = 8 * ig;
+	shifts[2] = 8 * ib;
+	*alpha_shift = 8 * ((ia != -1) ? ia : 6 - ir - ig - ib); // Octet restant : 0 + 1 + 2 + 3 = 6
+}
+
+ei_image_t *ei_image_create(ei_surface_t source, const ei_rect_t *rect, ei_surface_t target) {
+	ei_image_t *image = malloc(sizeof(ei_image_t));
+	ei_rect_t part = ei_surface_get_rect(source);
+	int src_shifts[3], src_alpha_shift, ir, ig, ib, ia;
+	ei_bool_t src_has_alpha;
+	uint32_t *src_row, *dst;
+	uint32_t pixel, alpha;
+	int stride, x, y, c;
+
+	if (rect != NULL) {
+		part = rect_intersection(part, *rect);
+	}
+	image->size = ei_size(max(part.size.width, 0), max(part.size.height, 0));
+	image->pixels = ei_surface_alloc_pixels(image->size, &image->stride);
+	image->stride /= 4;
+	image->opaque = EI_TRUE;
+	channel_shifts(target, image->shifts, &image->alpha_shift);
+	channel_shifts(source, src_shifts, &src_alpha_shift);
+	ei_surface_get_channel_indices(source, &ir, &ig, &ib, &ia);
+	src_has_alpha = (ei_bool_t) (ia != -1);
+
+	// Conversion une fois pour toutes : ordre des canaux de la cible, et opacité de l'image
+	ei_surface_lock(source);
+	stride = ei_surface_get_stride(source) / 4;
+	for (y = 0; y < image->size.height; y++) {
+		src_row = (uint32_t *) ei_surface_get_buffer(source) + (size_t) (part.top_left.y + y) * stride +
+			  part.top_left.x;
+		dst = image->pixels + (size_t) y * image->stride;
+		for (x = 0; x < image->size.width; x++) {
+			pixel = src_row[x];
+			alpha = src_has_alpha ? (pixel >> src_alpha_shift) & 0xff : 0xff;
+			if (alpha != 0xff) {
+				image->opaque = EI_FALSE;
+			}
+			*dst = alpha << image->alpha_shift;
+			for (c = 0; c < 3; c++) {
+				*dst |= ((pixel >> src_shifts[c]) & 0xff) << image->shifts[c];
+			}
+			dst++;
+		}
+	}
+	ei_surface_unlock(source);
+	return image;
+}
+
+void ei_image_free(ei_image_t *image) {
+	if (image == NULL) {
+		return;
+	}
+	ei_surface_free_pixels(image->pixels);
+	free(image);
+}
+
+/**
+ * \brief	Blends a row of "width" pixels of an image with alpha over a row of the surface, with the
+ * 		formula of \ref add_pixels. The alpha of the surface is kept.
+ */
+static void blend_row(const ei_image_t *image, uint32_t *dst, const uint32_t *src, int width) {
+	uint32_t alpha_mask = (uint32_t) 0xff << image->alpha_shift;
+	uint32_t s, d, a, result;
+	int x, c;
+
+	for (x = 0; x < width; x++) {
+		s = src[x];
+		a = (s >> image->alpha_shift) & 0xff;
+		if (a == 0xff) {
+			dst[x] = (s & ~alpha_mask) | (dst[x] & alpha_mask);
+		} else if (a != 0) {
+			d = dst[x];
+			result = d & alpha_mask;
+			for (c = 0; c < 3; c++) {
+				result |= ((a * ((s >> image->shifts[c]) & 0xff) + (255 - a) * ((d >> image->shifts[c]) & 0xff)) /
+					   255) << image->shifts[c];
+			}
+			dst[x] = result;
+		}
+	}
+}
+
+void ei_image_draw(ei_surface_t surface, const ei_image_t *image, ei_rect_t area, ei_anchor_t anchor,
+		   const ei_rect_t *clipper) {
+	ei_rect_t where = rect_anchored(area, image->size, anchor);
+	ei_rect_t visible = rect_intersection(rect_intersection(where, area), ei_surface_get_rect(surface));
+	uint32_t *dst;
+	const uint32_t *src;
+	int stride, y;
+
+	if (clipper != NULL) {
+		visible = rect_intersection(visible, *clipper);
+	}
+	if (visible.size.width <= 0 || visible.size.height <= 0) {
+		return;
+	}
+	stride = ei_surface_get_stride(surface) / 4;
+	dst = (uint32_t *) ei_surface_get_buffer(surface) + (size_t) visible.top_left.y * stride + visible.top_left.x;
+	src = image->pixels + (size_t) (visible.top_left.y - where.top_left.y) * image->stride +
+	      (visible.top_left.x - where.top_left.x);
+
+	// Une ligne visible à la fois : copie directe si l'image est opaque
+	for (y = 0; y < visible.size.height; y++) {
+		if (image->opaque) {
+			memcpy(dst, src, visible.size.width * sizeof(uint32_t));
+		} else {
+			blend_row(image, dst, src, visible.size.width);
+		}
+		dst += stride;
+		src += image->stride;
+	}
+	ei_stats_add_pixels(surface, (long) visible.size.width * visible.size.height);
+}
@@ -0,0 +1,427 @@
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __WIN__
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_draw.h"
+#include "ei_event.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+#include "ei_widgetclass.h"
+
+#include "ei_application_utils.h"
+#include "ei_image_async.h"
+#include "ei_image_cache.h"
+#include "ei_record.h"
+#include "ei_surface.h"
+
+#define ASYNC_MAX_THREADS 4
+#define PLACEHOLDER_TILE 8		///< Size of the squares of the placeholder
+
+/**
+ * \brief	A function (or a widget) waiting for an image.
+ */
+typedef struct async_waiter_t {
+	ei_image_callback_t callback;	///< NULL for the image of a widget (see \ref ei_widget_set_image_async).
+	void *user_param;		///< The widget if "callback" is NULL.
+	ei_rect_t rect;			///< The "img_rect" of the widget, if "has_rect".
+	ei_bool_t has_rect;
+	struct async_waiter_t *next;
+} async_waiter_t;
+
+/**
+ * \brief	The decoding of a file, shared by the requests of this file.
+ */
+typedef struct async_job_t {
+	char *filename;
+	ei_surface_t channels;		///< The root surface.
+	ei_surface_t surface;		///< Set by the worker: the decoded image, or NULL.
+	ei_bool_t from_disk;
+	ei_bool_t cached;		///< "surface" was found in the cache, and is already referenced.
+	async_waiter_t *waiters;	///< Used by the thread of the event loop only.
+	struct async_job_t *next;	///< Queue of the jobs to decode, then of the decoded jobs.
+	struct async_job_t *next_pending;	///< Jobs not yet delivered, from the most recent.
+} async_job_t;
+
+
+/** Global variables **/
+/**                  **/
+async_job_t *PENDING_JOBS = NULL;	///< Thread of the event loop only: merges the requests of a file
+async_job_t *TODO_HEAD = NULL;		///< Jobs to decode, protected by ASYNC_LOCK
+async_job_t *TODO_TAIL = NULL;
+async_job_t *DONE_HEAD = NULL;		///< Decoded jobs, protected by ASYNC_LOCK
+async_job_t *DONE_TAIL = NULL;
+int ASYNC_THREAD_COUNT = 0;
+ei_bool_t ASYNC_QUIT = EI_FALSE;
+char IMAGES_READY;			///< Posted marker: decoded jobs are waiting in DONE_HEAD
+ei_widgetclass_handle_t BUTTON_HANDLE = NULL;	///< Classes that have an image, looked up once
+ei_widgetclass_handle_t FRAME_HANDLE = NULL;
+#ifndef __WIN__
+pthread_mutex_t ASYNC_LOCK = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t ASYNC_WAKE = PTHREAD_COND_INITIALIZER;
+pthread_t ASYNC_THREADS[ASYNC_MAX_THREADS];
+#endif
+/**                  **/
+/** ---------------- **/
+
+static void async_lock(void) {
+#ifndef __WIN__
+	pthread_mutex_lock(&ASYNC_LOCK);
+#endif
+}
+
+static void async_unlock(void) {
+#ifndef __WIN__
+	pthread_mutex_unlock(&ASYNC_LOCK);
+#endif
+}
+
+/**
+ * \brief	Appends "job" to the decoded jobs, ASYNC_LOCK being held. Returns true if the queue was
+ * 		empty: the marker must then be posted (a single marker for the jobs decoded meanwhile).
+ */
+static ei_bool_t push_done(async_job_t *job) {
+	ei_bool_t was_empty = (ei_bool_t) (DONE_HEAD == NULL);
+	job->next = NULL;
+	if (was_empty) {
+		DONE_HEAD = job;
+	} else {
+		DONE_TAIL->next = job;
+	}
+	DONE_TAIL = job;
+	return was_empty;
+}
+
+#ifndef __WIN__
+
+/**
+ * \brief	A worker thread: decodes the queued jobs until \ref ei_image_async_free.
+ */
+static void *worker(void *unused) {
+	async_job_t *job;
+
+	pthread_mutex_lock(&ASYNC_LOCK);
+	while (EI_TRUE) {
+		while (TODO_HEAD == NULL && !ASYNC_QUIT) {
+			pthread_cond_wait(&ASYNC_WAKE, &ASYNC_LOCK);
+		}
+		if (ASYNC_QUIT) {
+			break;
+		}
+		job = TODO_HEAD;
+		TODO_HEAD = job->next;
+		if (TODO_HEAD == NULL) {
+			TODO_TAIL = NULL;
+		}
+		pthread_mutex_unlock(&ASYNC_LOCK);
+
+		// Décodage hors verrou : seul ce thread décode ce fichier
+		job->surface = ei_image_cache_decode(job->filename, job->channels, &job->from_disk);
+
+		pthread_mutex_lock(&ASYNC_LOCK);
+		if (push_done(job)) {
+			ei_event_post_app(&IMAGES_READY);
+		}
+	}
+	pthread_mutex_unlock(&ASYNC_LOCK);
+	return NULL;
+}
+
+/**
+ * \brief	Starts the worker threads if needed: one per processor but one, between 1 and
+ * 		ASYNC_MAX_THREADS. Returns false if no thread could be started.
+ */
+static ei_bool_t start_workers(void) {
+	long processors;
+	int count, i;
+
+	if (ASYNC_THREAD_COUNT > 0) {
+		return EI_TRUE;
+	}
+	processors = sysconf(_SC_NPROCESSORS_ONLN);
+	count = (int) min(max(processors - 1, 1), ASYNC_MAX_THREADS);
+	for (i = 0; i < count; i++) {
+		if (pthread_create(&ASYNC_THREADS[ASYNC_THREAD_COUNT], NULL, worker, NULL) == 0) {
+			ASYNC_THREAD_COUNT++;
+		}
+	}
+	return (ei_bool_t) (ASYNC_THREAD_COUNT > 0);
+}
+
+#else
+
+static ei_bool_t start_workers(void) {
+	return EI_FALSE;
+}
+
+#endif
+
+/**
+ * \brief	Adds "waiter" to the job of "filename", created if there is none. A new job is
+ * 		delivered at the next iteration of the event loop if the image is in the cache, decoded
+ * 		by the workers otherwise.
+ */
+static void request(const char *filename, async_waiter_t *waiter) {
+	async_job_t *job;
+	async_waiter_t **last;
+
+	waiter->next = NULL;
+	for (job = PENDING_JOBS; job != NULL; job = job->next_pending) {
+		if (strcmp(job->filename, filename) == 0) {
+			for (last = &job->waiters; *last != NULL; last = &(*last)->next) {
+			}
+			*last = waiter;
+			return;
+		}
+	}
+
+	job = calloc(1, sizeof(async_job_t));
+	job->filename = malloc(strlen(filename) + 1);
+	strcpy(job->filename, filename);
+	job->channels = ei_app_root_surface();
+	job->waiters = waiter;
+	job->next_pending = PENDING_JOBS;
+	PENDING_JOBS = job;
+
+	job->surface = ei_image_cache_find(filename, job->channels);
+	job->cached = (ei_bool_t) (job->surface != NULL);
+	if (!job->cached) {
+		if (!ei_replay_is_active() && start_workers()) {
+			async_lock();
+			job->next = NULL;
+			if (TODO_HEAD == NULL) {
+				TODO_HEAD = job;
+			} else {
+				TODO_TAIL->next = job;
+			}
+			TODO_TAIL = job;
+#ifndef __WIN__
+			pthread_cond_signal(&ASYNC_WAKE);
+#endif
+			async_unlock();
+			return;
+		}
+		// Pas de thread (ou rejeu déterministe) : décodage immédiat, livraison par la boucle
+		job->surface = ei_image_cache_decode(filename, job->channels, &job->from_disk);
+	}
+	async_lock();
+	if (push_done(job)) {
+		ei_event_post_app(&IMAGES_READY);
+	}
+	async_unlock();
+}
+
+void ei_image_load_async(const char *filename, ei_image_callback_t callback, void *user_param) {
+	async_waiter_t *waiter = calloc(1, sizeof(async_waiter_t));
+	waiter->callback = callback;
+	waiter->user_param = user_param;
+	request(filename, waiter);
+}
+
+/**
+ * \brief	Removes the waiters of "callback" with "user_param" from the pending jobs.
+ */
+static void cancel(ei_image_callback_t callback, void *user_param) {
+	async_job_t *job;
+	async_waiter_t **link, *waiter;
+
+	for (job = PENDING_JOBS; job != NULL; job = job->next_pending) {
+		link = &job->waiters;
+		while (*link != NULL) {
+			waiter = *link;
+			if (waiter->callback == callback && waiter->user_param == user_param) {
+				*link = waiter->next;
+				free(waiter);
+			} else {
+				link = &waiter->next;
+			}
+		}
+	}
+}
+
+void ei_image_cancel_async(ei_image_callback_t callback, void *user_param) {
+	cancel(callback, user_param);
+}
+
+void ei_widget_cancel_image_async(ei_widget_t *widget) {
+	cancel(NULL, widget);
+}
+
+/**
+ * \brief	Returns true if "widget" is a frame or a button, the classes that have an image.
+ */
+static ei_bool_t has_image(const ei_widget_t *widget) {
+	static ei_widgetclass_name_t button = "button", frame = "frame";
+
+	if (FRAME_HANDLE == NULL) {
+		BUTTON_HANDLE = ei_widgetclass_get_handle(button);
+		FRAME_HANDLE = ei_widgetclass_get_handle(frame);
+	}
+	return (ei_bool_t) (widget->wclass == BUTTON_HANDLE || widget->wclass == FRAME_HANDLE);
+}
+
+/**
+ * \brief	Configures the image of the frame or button "widget" (see \ref has_image), and redraws it.
+ */
+static void configure_image(ei_widget_t *widget, ei_surface_t image, ei_rect_t *rect) {
+	if (widget->wclass == BUTTON_HANDLE) {
+		ei_button_configure(widget, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, &image, &rect, NULL,
+				    NULL, NULL);
+	} else if (widget->wclass == FRAME_HANDLE) {
+		ei_frame_configure(widget, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, &image, &rect, NULL);
+	}
+	ei_app_invalidate_rect(&widget->screen_location);
+}
+
+/**
+ * \brief	Returns a new surface of "size" with a grey checkerboard.
+ */
+static ei_surface_t create_placeholder(ei_size_t size) {
+	ei_surface_t root = ei_app_root_surface();
+	ei_color_t light = {0xd8, 0xd8, 0xd8, 0xff}, dark = {0xb8, 0xb8, 0xb8, 0xff};
+	ei_surface_t placeholder;
+	uint32_t colors[2];
+	uint32_t *row;
+	int x, y;
+
+	size = ei_size(max(size.width, 1), max(size.height, 1));
+	placeholder = hw_surface_create(root, size, EI_FALSE);
+	colors[0] = ei_map_rgba(placeholder, light);
+	colors[1] = ei_map_rgba(placeholder, dark);
+	hw_surface_lock(placeholder);
+	for (y = 0; y < size.height; y++) {
+		row = (uint32_t *) (hw_surface_get_buffer(placeholder) + (size_t) y * ei_surface_get_stride(placeholder));
+		for (x = 0; x < size.width; x++) {
+			row[x] = colors[(x / PLACEHOLDER_TILE + y / PLACEHOLDER_TILE) & 1];
+		}
+	}
+	hw_surface_unlock(placeholder);
+	return placeholder;
+}
+
+void ei_widget_set_image_async(ei_widget_t *widget, const char *filename, const ei_rect_t *img_rect,
+			       ei_size_t placeholder_size) {
+	async_waiter_t *waiter;
+	ei_surface_t placeholder;
+
+	if (!has_image(widget)) {
+		return;
+	}
+	waiter = calloc(1, sizeof(async_waiter_t));
+	placeholder = create_placeholder(placeholder_size);
+
+	// Le placeholder est converti par la configuration, qui annule aussi la requête précédente
+	configure_image(widget, placeholder, NULL);
+	hw_surface_free(placeholder);
+
+	waiter->user_param = widget;
+	if (img_rect != NULL) {
+		waiter->rect = *img_rect;
+		waiter->has_rect = EI_TRUE;
+	}
+	request(filename, waiter);
+}
+
+/**
+ * \brief	Gives the image of "job" to its waiters: one reference of the cache for each waiter.
+ * 		The job stays pending during the callbacks: a callback can cancel the next waiters
+ * 		(e.g. by destroying a widget), or request the same file again.
+ */
+static void deliver(async_job_t *job) {
+	async_job_t **link;
+	async_waiter_t *waiter;
+	ei_surface_t image;
+
+	// Référence gardée pendant les rappels : un rappel peut libérer la sienne
+	image = job->cached ? job->surface :
+		ei_image_cache_insert(job->filename, job->channels, job->surface, job->from_disk);
+	while (job->waiters != NULL) {
+		waiter = job->waiters;
+		job->waiters = waiter->next;
+		ei_image_cache_retain(image);
+		if (waiter->callback != NULL) {
+			waiter->callback(image, waiter->user_param);
+		} else {
+			// Image d'un widget : copiée par la configuration
+			configure_image(waiter->user_param, image, waiter->has_rect ? &waiter->rect : NULL);
+			ei_image_cache_release(image);
+		}
+		free(waiter);
+	}
+	ei_image_cache_release(image);
+
+	for (link = &PENDING_JOBS; *link != job; link = &(*link)->next_pending) {
+	}
+	*link = job->next_pending;
+	free(job->filename);
+	free(job);
+}
+
+ei_bool_t ei_image_async_dispatch(const ei_event_t *event) {
+	async_job_t *jobs, *job;
+
+	if (event->type != ei_ev_app || event->param.application.user_param != &IMAGES_READY) {
+		return EI_FALSE;
+	}
+	async_lock();
+	jobs = DONE_HEAD;
+	DONE_HEAD = NULL;
+	DONE_TAIL = NULL;
+	async_unlock();
+
+	while (jobs != NULL) {
+		job = jobs;
+		jobs = job->next;
+		deliver(job);
+	}
+	return EI_TRUE;
+}
+
+void ei_image_async_free(void) {
+	async_job_t *job;
+	async_waiter_t *waiter;
+
+#ifndef __WIN__
+	int i;
+	pthread_mutex_lock(&ASYNC_LOCK);
+	ASYNC_QUIT = EI_TRUE;
+	pthread_cond_broadcast(&ASYNC_WAKE);
+	pthread_mutex_unlock(&ASYNC_LOCK);
+	for (i = 0; i < ASYNC_THREAD_COUNT; i++) {
+		pthread_join(ASYNC_THREADS[i], NULL);
+	}
+#endif
+	ASYNC_THREAD_COUNT = 0;
+	ASYNC_QUIT = EI_FALSE;
+	// Les classes sont libérées avec l'application
+	BUTTON_HANDLE = NULL;
+	FRAME_HANDLE = NULL;
+
+	// Toutes les requêtes non livrées, qu'elles soient à décoder ou décodées
+	while (PENDING_JOBS != NULL) {
+		job = PENDING_JOBS;
+		PENDING_JOBS = job->next_pending;
+		if (job->cached) {
+			ei_image_cache_release(job->surface);
+		} else if (job->surface != NULL) {
+			hw_surface_free(job->surface);
+		}
+		while (job->waiters != NULL) {
+			waiter = job->waiters;
+			job->waiters = waiter->next;
+			free(waiter);
+		}
+		free(job->filename);
+		free(job);
+	}
+	TODO_HEAD = NULL;
+	TODO_TAIL = NULL;
+	DONE_HEAD = NULL;
+	DONE_TAIL = NULL;
+}
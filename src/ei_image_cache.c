@@ -0,0 +1,488 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hw_interface.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+
+#include "ei_application_utils.h"
+
+#include "ei_image_cache.h"
+#include "ei_image_disk.h"
+#include "ei_scale.h"
+#include "ei_surface.h"
+#include "hash.h"
+
+#define CACHE_TABLE_MIN_CAPACITY 16
+#define CACHE_MAX_LEVELS 16		///< Halvings of an image: enough for 65536 pixels wide images
+#define CACHE_MAX_SCALED 4		///< Resampled areas kept per image
+
+/**
+ * \brief	An area of an image resampled by \ref ei_image_cache_scaled.
+ */
+typedef struct cache_scaled_t {
+	ei_rect_t area;
+	ei_size_t size;
+	ei_filter_t filter;
+	uint32_t *pixels;		///< Allocated by \ref ei_surface_alloc_pixels.
+	int stride;			///< Pixels between two rows.
+	struct cache_scaled_t *next;
+} cache_scaled_t;
+
+/**
+ * \brief	An image of the cache, decoded from "filename" with the channel order "channels".
+ */
+typedef struct cache_entry_t {
+	char *filename;
+	int channels[4];		///< Indices of the red, green, blue and alpha channels (see \ref hw_surface_get_channel_indices).
+	ei_surface_t surface;
+	size_t bytes;
+	int refcount;
+	uint32_t *levels[CACHE_MAX_LEVELS];	///< Level i is the half of level i - 1, level -1 is the surface.
+	ei_size_t level_sizes[CACHE_MAX_LEVELS];
+	int level_strides[CACHE_MAX_LEVELS];	///< Pixels between two rows of a level.
+	int level_count;
+	cache_scaled_t *scaled;		///< Last resampled areas, from the most recently used.
+	int scaled_count;
+	struct cache_entry_t *older;	///< Unreferenced images, from the least recently released.
+	struct cache_entry_t *newer;
+} cache_entry_t;
+
+/**
+ * \brief	A slot of a table: an image and the hash of its key. Empty if "entry" is NULL.
+ */
+typedef struct {
+	uint32_t hash;
+	cache_entry_t *entry;
+} cache_slot_t;
+
+/**
+ * \brief	Open addressing (linear probing), capacity is a power of 2.
+ */
+typedef struct {
+	cache_slot_t *slots;
+	uint32_t capacity;
+	uint32_t count;
+} cache_table_t;
+
+
+/** Global variables **/
+/**                  **/
+cache_table_t BY_NAME = {NULL, 0, 0};		///< Images by file name and channel order (for loading)
+cache_table_t BY_SURFACE = {NULL, 0, 0};	///< Images by surface (for releasing)
+cache_entry_t *OLDEST_UNUSED = NULL;		///< Eviction order of the unreferenced images
+cache_entry_t *NEWEST_UNUSED = NULL;
+ei_image_cache_stats_t CACHE_STATS = {0, 0, 0, 0, 0, 0, 0, EI_IMAGE_CACHE_DEFAULT_BUDGET};
+/**                  **/
+/** ---------------- **/
+
+static uint32_t name_hash(const char *filename, const int channels[4]) {
+	return hash(filename) * 31 + (uint32_t) (channels[0] | channels[1] << 2 | channels[2] << 4 | (channels[3] & 3) << 6);
+}
+
+static uint32_t surface_hash(ei_surface_t surface) {
+	uintptr_t p = (uintptr_t) surface;
+	return (uint32_t) ((p >> 4) ^ (p >> 20)) * 2654435761u; // Les bits de poids faible d'une adresse sont nuls
+}
+
+/**
+ * \brief	Returns the slot of "filename" with "channels", or the empty slot where it would be inserted.
+ */
+static cache_slot_t *find_name(const char *filename, const int channels[4], uint32_t h) {
+	uint32_t mask = BY_NAME.capacity - 1;
+	uint32_t i = h & mask;
+	cache_entry_t *entry;
+	while ((entry = BY_NAME.slots[i].entry) != NULL) {
+		if (BY_NAME.slots[i].hash == h && memcmp(entry->channels, channels, sizeof(entry->channels)) == 0 &&
+		    strcmp(entry->filename, filename) == 0) {
+			return &BY_NAME.slots[i];
+		}
+		i = (i + 1) & mask;
+	}
+	return &BY_NAME.slots[i];
+}
+
+/**
+ * \brief	Returns the slot of "surface", or the empty slot where it would be inserted.
+ */
+static cache_slot_t *find_surface(ei_surface_t surface, uint32_t h) {
+	uint32_t mask = BY_SURFACE.capacity - 1;
+	uint32_t i = h & mask;
+	while (BY_SURFACE.slots[i].entry != NULL && BY_SURFACE.slots[i].entry->surface != surface) {
+		i = (i + 1) & mask;
+	}
+	return &BY_SURFACE.slots[i];
+}
+
+/**
+ * \brief	Inserts "entry" of hash "h" in an empty slot of "table", which grows if needed.
+ */
+static void table_insert(cache_table_t *table, cache_entry_t *entry, uint32_t h) {
+	cache_slot_t *slots;
+	uint32_t capacity, i, j;
+
+	// Taux de remplissage maximal : 1/2
+	if (2 * (table->count + 1) > table->capacity) {
+		capacity = (table->capacity == 0) ? CACHE_TABLE_MIN_CAPACITY : 2 * table->capacity;
+		slots = calloc(capacity, sizeof(cache_slot_t));
+		for (i = 0; i < table->capacity; i++) {
+			if (table->slots[i].entry != NULL) {
+				j = table->slots[i].hash & (capacity - 1);
+				while (slots[j].entry != NULL) {
+					j = (j + 1) & (capacity - 1);
+				}
+				slots[j] = table->slots[i];
+			}
+		}
+		free(table->slots);
+		table->slots = slots;
+		table->capacity = capacity;
+	}
+	i = h & (table->capacity - 1);
+	while (table->slots[i].entry != NULL) {
+		i = (i + 1) & (table->capacity - 1);
+	}
+	table->slots[i].hash = h;
+	table->slots[i].entry = entry;
+	table->count++;
+}
+
+/**
+ * \brief	Empties "slot" of "table". The next slots of the same probe sequence are shifted back,
+ * 		so that no tombstone is needed.
+ */
+static void table_remove(cache_table_t *table, cache_slot_t *slot) {
+	uint32_t mask = table->capacity - 1;
+	uint32_t hole = (uint32_t) (slot - table->slots);
+	uint32_t i = hole;
+	uint32_t home;
+
+	for (;;) {
+		i = (i + 1) & mask;
+		if (table->slots[i].entry == NULL) {
+			break;
+		}
+		// Le suivant peut combler le trou si sa place idéale n'est pas entre le trou et lui
+		home = table->slots[i].hash & mask;
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			table->slots[hole] = table->slots[i];
+			hole = i;
+		}
+	}
+	table->slots[hole].entry = NULL;
+	table->count--;
+}
+
+static void unlink_unused(cache_entry_t *entry) {
+	if (entry->older != NULL) {
+		entry->older->newer = entry->newer;
+	} else {
+		OLDEST_UNUSED = entry->newer;
+	}
+	if (entry->newer != NULL) {
+		entry->newer->older = entry->older;
+	} else {
+		NEWEST_UNUSED = entry->older;
+	}
+	entry->older = NULL;
+	entry->newer = NULL;
+}
+
+static void free_entry(cache_entry_t *entry) {
+	cache_scaled_t *scaled;
+	int i;
+	for (i = 0; i < entry->level_count; i++) {
+		ei_surface_free_pixels(entry->levels[i]);
+	}
+	while (entry->scaled != NULL) {
+		scaled = entry->scaled;
+		entry->scaled = scaled->next;
+		ei_surface_free_pixels(scaled->pixels);
+		free(scaled);
+	}
+	hw_surface_free(entry->surface);
+	free(entry->filename);
+	free(entry);
+}
+
+/**
+ * \brief	Frees the least recently released images until the cache fits in its budget.
+ */
+static void evict(void) {
+	cache_entry_t *entry;
+	while (CACHE_STATS.bytes > CACHE_STATS.budget && OLDEST_UNUSED != NULL) {
+		entry = OLDEST_UNUSED;
+		unlink_unused(entry);
+		table_remove(&BY_NAME, find_name(entry->filename, entry->channels, name_hash(entry->filename, entry->channels)));
+		table_remove(&BY_SURFACE, find_surface(entry->surface, surface_hash(entry->surface)));
+		CACHE_STATS.bytes -= entry->bytes;
+		CACHE_STATS.images--;
+		CACHE_STATS.evictions++;
+		free_entry(entry);
+	}
+}
+
+/**
+ * \brief	References "entry" once more: it leaves the unused images if it was one.
+ */
+static void retain(cache_entry_t *entry) {
+	if (entry->refcount++ == 0) {
+		unlink_unused(entry);
+		CACHE_STATS.referenced++;
+	}
+}
+
+/**
+ * \brief	Returns the image of "filename" with the channel order "key", referenced once more, or NULL
+ * 		if it is not in the cache. "h" is the hash of the name.
+ */
+static cache_entry_t *retain_name(const char *filename, const int key[4], uint32_t h) {
+	cache_entry_t *entry;
+	if (BY_NAME.count == 0 || (entry = find_name(filename, key, h)->entry) == NULL) {
+		return NULL;
+	}
+	retain(entry);
+	CACHE_STATS.hits++;
+	return entry;
+}
+
+ei_surface_t ei_image_cache_find(const char *filename, ei_surface_t channels) {
+	int key[4];
+	cache_entry_t *entry;
+
+	hw_surface_get_channel_indices(channels, &key[0], &key[1], &key[2], &key[3]);
+	entry = retain_name(filename, key, name_hash(filename, key));
+	return (entry != NULL) ? entry->surface : NULL;
+}
+
+ei_surface_t ei_image_cache_decode(const char *filename, ei_surface_t channels, ei_bool_t *from_disk) {
+	ei_surface_t surface;
+
+	*from_disk = EI_FALSE;
+	if ((surface = ei_image_disk_load(filename, channels)) != NULL) {
+		*from_disk = EI_TRUE;
+	} else if ((surface = hw_image_load(filename, channels)) != NULL) {
+		ei_image_disk_store(filename, channels, surface);
+	}
+	return surface;
+}
+
+ei_surface_t ei_image_cache_load(const char *filename, ei_surface_t channels) {
+	ei_surface_t surface = ei_image_cache_find(filename, channels);
+	ei_bool_t from_disk;
+
+	if (surface != NULL) {
+		return surface;
+	}
+	surface = ei_image_cache_decode(filename, channels, &from_disk);
+	return ei_image_cache_insert(filename, channels, surface, from_disk);
+}
+
+ei_surface_t ei_image_cache_insert(const char *filename, ei_surface_t channels, ei_surface_t surface,
+				   ei_bool_t from_disk) {
+	int key[4];
+	uint32_t h;
+	cache_entry_t *entry;
+	ei_size_t size;
+
+	hw_surface_get_channel_indices(channels, &key[0], &key[1], &key[2], &key[3]);
+	h = name_hash(filename, key);
+	if ((entry = retain_name(filename, key, h)) != NULL) {
+		// Chargée entre-temps (décodage sur un autre thread) : la copie est inutile
+		if (surface != NULL) {
+			hw_surface_free(surface);
+		}
+		return entry->surface;
+	}
+	CACHE_STATS.misses++;
+	if (surface == NULL) {
+		return NULL;
+	}
+	if (from_disk) {
+		CACHE_STATS.disk_hits++;
+	}
+	size = hw_surface_get_size(surface);
+	entry = calloc(1, sizeof(cache_entry_t));
+	entry->filename = malloc(strlen(filename) + 1);
+	strcpy(entry->filename, filename);
+	memcpy(entry->channels, key, sizeof(key));
+	entry->surface = surface;
+	entry->bytes = (size_t) size.width * size.height * 4;
+	entry->refcount = 1;
+	table_insert(&BY_NAME, entry, h);
+	table_insert(&BY_SURFACE, entry, surface_hash(surface));
+	CACHE_STATS.bytes += entry->bytes;
+	CACHE_STATS.images++;
+	CACHE_STATS.referenced++;
+
+	// La nouvelle image peut faire dépasser le budget : place libérée parmi les inutilisées
+	evict();
+	return surface;
+}
+
+void ei_image_cache_retain(ei_surface_t image) {
+	cache_entry_t *entry;
+
+	if (image == NULL || BY_SURFACE.count == 0) {
+		return;
+	}
+	if ((entry = find_surface(image, surface_hash(image))->entry) != NULL) {
+		retain(entry);
+	}
+}
+
+void ei_image_cache_release(ei_surface_t image) {
+	cache_entry_t *entry;
+
+	if (image == NULL || BY_SURFACE.count == 0) {
+		return;
+	}
+	entry = find_surface(image, surface_hash(image))->entry;
+	if (entry == NULL || --entry->refcount > 0) {
+		return;
+	}
+	CACHE_STATS.referenced--;
+	entry->older = NEWEST_UNUSED;
+	if (NEWEST_UNUSED != NULL) {
+		NEWEST_UNUSED->newer = entry;
+	} else {
+		OLDEST_UNUSED = entry;
+	}
+	NEWEST_UNUSED = entry;
+	evict();
+}
+
+/**
+ * \brief	Adds "bytes" to the memory used by "entry".
+ */
+static void grow_entry(cache_entry_t *entry, size_t bytes) {
+	entry->bytes += bytes;
+	CACHE_STATS.bytes += bytes;
+}
+
+/**
+ * \brief	Returns the halved level "level" of the image of "entry" (0 is the image), computed if needed.
+ */
+static const uint32_t *get_level(cache_entry_t *entry, int level, ei_size_t *size, int *stride) {
+	const uint32_t *source;
+	ei_size_t source_size;
+	int source_stride, i;
+
+	while (entry->level_count < level) {
+		i = entry->level_count;
+		if (i == 0) {
+			source = (const uint32_t *) hw_surface_get_buffer(entry->surface);
+			source_size = hw_surface_get_size(entry->surface);
+			source_stride = ei_surface_get_stride(entry->surface) / 4;
+		} else {
+			source = entry->levels[i - 1];
+			source_size = entry->level_sizes[i - 1];
+			source_stride = entry->level_strides[i - 1];
+		}
+		entry->level_sizes[i] = ei_scale_half_size(source_size);
+		entry->levels[i] = ei_surface_alloc_pixels(entry->level_sizes[i], &entry->level_strides[i]);
+		ei_scale_halve(entry->levels[i], entry->level_strides[i] / 4, source, source_stride, source_size);
+		grow_entry(entry, (size_t) entry->level_strides[i] * entry->level_sizes[i].height);
+		entry->level_strides[i] /= 4;
+		entry->level_count++;
+	}
+	if (level == 0) {
+		*size = hw_surface_get_size(entry->surface);
+		*stride = ei_surface_get_stride(entry->surface) / 4;
+		return (const uint32_t *) hw_surface_get_buffer(entry->surface);
+	}
+	*size = entry->level_sizes[level - 1];
+	*stride = entry->level_strides[level - 1];
+	return entry->levels[level - 1];
+}
+
+const uint32_t *ei_image_cache_scaled(ei_surface_t image, ei_rect_t area, ei_size_t size, ei_filter_t filter,
+				      int *stride) {
+	cache_entry_t *entry;
+	cache_scaled_t *scaled, **link;
+	const uint32_t *level;
+	ei_size_t level_size;
+	ei_rect_t level_area;
+	int levels, level_stride;
+
+	if (BY_SURFACE.count == 0 || (entry = find_surface(image, surface_hash(image))->entry) == NULL) {
+		return NULL;
+	}
+	for (link = &entry->scaled; *link != NULL; link = &(*link)->next) {
+		scaled = *link;
+		if (scaled->filter == filter && rect_equal(scaled->area, area) && scaled->size.width == size.width &&
+		    scaled->size.height == size.height) {
+			// Déjà calculé : remis en tête de liste
+			*link = scaled->next;
+			scaled->next = entry->scaled;
+			entry->scaled = scaled;
+			*stride = scaled->stride;
+			return scaled->pixels;
+		}
+	}
+
+	// Rééchantillonnage depuis le niveau le plus petit qui reste assez grand
+	levels = min(ei_scale_levels(area.size, size, filter), CACHE_MAX_LEVELS);
+	level = get_level(entry, levels, &level_size, &level_stride);
+	level_area.top_left = ei_point(area.top_left.x >> levels, area.top_left.y >> levels);
+	level_area.size = ei_size(max(area.size.width >> levels, 1), max(area.size.height >> levels, 1));
+	level_area = rect_intersection(level_area, ei_rect(ei_point_zero(), level_size));
+
+	if (entry->scaled_count == CACHE_MAX_SCALED) {
+		// Le moins récemment utilisé est remplacé
+		for (link = &entry->scaled; (*link)->next != NULL; link = &(*link)->next) {
+		}
+		scaled = *link;
+		*link = NULL;
+		entry->bytes -= (size_t) scaled->stride * scaled->size.height * sizeof(uint32_t);
+		CACHE_STATS.bytes -= (size_t) scaled->stride * scaled->size.height * sizeof(uint32_t);
+		ei_surface_free_pixels(scaled->pixels);
+	} else {
+		scaled = malloc(sizeof(cache_scaled_t));
+		entry->scaled_count++;
+	}
+	scaled->area = area;
+	scaled->size = size;
+	scaled->filter = filter;
+	scaled->pixels = ei_surface_alloc_pixels(size, &scaled->stride);
+	scaled->stride /= 4;
+	ei_scale_pixels(scaled->pixels, scaled->stride, size,
+			level + (size_t) level_area.top_left.y * level_stride + level_area.top_left.x, level_stride,
+			level_area.size, filter);
+	grow_entry(entry, (size_t) scaled->stride * size.height * sizeof(uint32_t));
+	scaled->next = entry->scaled;
+	entry->scaled = scaled;
+	*stride = scaled->stride;
+	return scaled->pixels;
+}
+
+void ei_image_cache_set_budget(size_t bytes) {
+	CACHE_STATS.budget = bytes;
+	evict();
+}
+
+void ei_image_cache_set_directory(const char *directory) {
+	ei_image_disk_set_directory(directory);
+}
+
+void ei_image_cache_get_stats(ei_image_cache_stats_t *stats) {
+	*stats = CACHE_STATS;
+}
+
+void ei_image_cache_free(void) {
+	uint32_t i;
+	for (i = 0; i < BY_NAME.capacity; i++) {
+		if (BY_NAME.slots[i].entry != NULL) {
+			free_entry(BY_NAME.slots[i].entry);
+		}
+	}
+	free(BY_NAME.slots);
+	free(BY_SURFACE.slots);
+	BY_NAME = (cache_table_t) {NULL, 0, 0};
+	BY_SURFACE = (cache_table_t) {NULL, 0, 0};
+	OLDEST_UNUSED = NULL;
+	NEWEST_UNUSED = NULL;
+	CACHE_STATS = (ei_image_cache_stats_t) {0, 0, 0, 0, 0, 0, 0, CACHE_STATS.budget};
+	ei_image_disk_set_directory(NULL);
+}
@@ -0,0 +1,253 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __WIN__
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "hw_interface.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+
+#include "ei_image_disk.h"
+#include "ei_surface.h"
+#include "hash.h"
+
+#define DISK_MAGIC "EIRAW002"
+#define DISK_HEADER_SIZE 4096		///< The pixels start on a page
+
+/**
+ * \brief	The beginning of a file of the cache. The absolute path of the image file follows.
+ */
+typedef struct {
+	char magic[8];
+	int32_t width;
+	int32_t height;
+	int32_t stride;			///< Bytes between the beginning of two rows of pixels.
+	int32_t channels[4];		///< Indices of the red, green, blue and alpha channels.
+	int64_t source_size;		///< Size and modification time of the image file.
+	int64_t source_mtime;
+	int64_t source_mtime_nsec;	///< Nanoseconds of the modification time: a file rewritten in the same second.
+	int32_t path_length;
+} disk_header_t;
+
+
+/** Global variables **/
+/**                  **/
+char *DISK_DIRECTORY = NULL;		///< NULL: no cache on disk. Protected by DISK_LOCK
+#ifndef __WIN__
+pthread_mutex_t DISK_LOCK = PTHREAD_MUTEX_INITIALIZER;	///< The decoding threads read the directory
+#endif
+/**                  **/
+/** ---------------- **/
+
+#ifndef __WIN__
+
+void ei_image_disk_set_directory(const char *directory) {
+	pthread_mutex_lock(&DISK_LOCK);
+	free(DISK_DIRECTORY);
+	DISK_DIRECTORY = NULL;
+	if (directory != NULL) {
+		DISK_DIRECTORY = malloc(strlen(directory) + 1);
+		strcpy(DISK_DIRECTORY, directory);
+		mkdir(directory, 0755); // Échec sans conséquence s'il existe déjà
+	}
+	pthread_mutex_unlock(&DISK_LOCK);
+}
+
+/**
+ * \brief	Finds the absolute path "source" of "filename", its state "info", and the name "path" of
+ * 		its file in the cache for the channel order "channels". Returns false if there is no cache
+ * 		directory or if the image file does not exist.
+ */
+static ei_bool_t cache_file(const char *filename, const int channels[4], char path[PATH_MAX], char source[PATH_MAX],
+			    struct stat *info) {
+	char directory[PATH_MAX];
+	ei_bool_t enabled;
+
+	// Copie : le répertoire peut être changé (et libéré) pendant qu'un thread décode
+	pthread_mutex_lock(&DISK_LOCK);
+	enabled = (ei_bool_t) (DISK_DIRECTORY != NULL && strlen(DISK_DIRECTORY) < PATH_MAX);
+	if (enabled) {
+		strcpy(directory, DISK_DIRECTORY);
+	}
+	pthread_mutex_unlock(&DISK_LOCK);
+
+	if (!enabled || realpath(filename, source) == NULL || stat(source, info) != 0) {
+		return EI_FALSE;
+	}
+	return (ei_bool_t) (snprintf(path, PATH_MAX, "%s/%08x-%d%d%d%d.raw", directory, hash(source), channels[0],
+				     channels[1], channels[2], channels[3]) < PATH_MAX);
+}
+
+/**
+ * \brief	Returns the nanoseconds of the modification time of a file (0 if not available).
+ */
+static int64_t mtime_nsec(const struct stat *info) {
+#if defined(__APPLE__)
+	return (int64_t) info->st_mtimespec.tv_nsec;
+#else
+	return (int64_t) info->st_mtim.tv_nsec;
+#endif
+}
+
+/**
+ * \brief	Returns true if the mapped file of "length" bytes is the image "source" of state "info",
+ * 		with the channel order "channels".
+ */
+static ei_bool_t is_valid(const uint8_t *map, size_t length, const int channels[4], const char *source,
+			  const struct stat *info) {
+	const disk_header_t *header = (const disk_header_t *) map;
+	return (ei_bool_t) (memcmp(header->magic, DISK_MAGIC, sizeof(header->magic)) == 0 &&
+			    header->width > 0 && header->height > 0 && header->stride == 4 * header->width &&
+			    length == DISK_HEADER_SIZE + (size_t) header->stride * header->height &&
+			    memcmp(header->channels, channels, sizeof(header->channels)) == 0 &&
+			    header->source_size == (int64_t) info->st_size &&
+			    header->source_mtime == (int64_t) info->st_mtime &&
+			    header->source_mtime_nsec == mtime_nsec(info) &&
+			    header->path_length == (int32_t) strlen(source) &&
+			    memcmp(map + sizeof(disk_header_t), source, header->path_length) == 0);
+}
+
+ei_surface_t ei_image_disk_load(const char *filename, ei_surface_t channels) {
+	char path[PATH_MAX], source[PATH_MAX];
+	struct stat info, file;
+	const disk_header_t *header;
+	ei_surface_t surface = NULL;
+	uint8_t *map, *pixels;
+	size_t length;
+	int key[4], ir, ig, ib, ia, fd, y, stride;
+
+	hw_surface_get_channel_indices(channels, &key[0], &key[1], &key[2], &key[3]);
+	if (!cache_file(filename, key, path, source, &info) || (fd = open(path, O_RDONLY)) < 0) {
+		return NULL;
+	}
+	if (fstat(fd, &file) != 0 || file.st_size < DISK_HEADER_SIZE) {
+		close(fd);
+		return NULL;
+	}
+	length = (size_t) file.st_size;
+	map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return NULL;
+	}
+
+	header = (const disk_header_t *) map;
+	if (is_valid(map, length, key, source, &info)) {
+		surface = hw_surface_create(channels, ei_size(header->width, header->height), (ei_bool_t) (key[3] != -1));
+		hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+		if (ir != key[0] || ig != key[1] || ib != key[2] || ia != key[3]) {
+			hw_surface_free(surface);
+			surface = NULL;
+		} else {
+			// Copie directe des lignes depuis la projection du fichier
+			hw_surface_lock(surface);
+			pixels = ei_surface_get_buffer(surface);
+			stride = ei_surface_get_stride(surface);
+			for (y = 0; y < header->height; y++) {
+				memcpy(pixels + (size_t) y * stride, map + DISK_HEADER_SIZE + (size_t) y * header->stride,
+				       4 * header->width);
+			}
+			hw_surface_unlock(surface);
+		}
+	}
+	munmap(map, length);
+	return surface;
+}
+
+/**
+ * \brief	Writes "length" bytes of "data" to "fd". Returns false on error.
+ */
+static ei_bool_t write_all(int fd, const uint8_t *data, size_t length) {
+	ssize_t written;
+	while (length > 0) {
+		written = write(fd, data, length);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			return EI_FALSE;
+		}
+		data += written;
+		length -= written;
+	}
+	return EI_TRUE;
+}
+
+void ei_image_disk_store(const char *filename, ei_surface_t channels, ei_surface_t image) {
+	char path[PATH_MAX], source[PATH_MAX], temporary[PATH_MAX + 32];
+	struct stat info;
+	disk_header_t *header;
+	uint8_t *page;
+	ei_size_t size = hw_surface_get_size(image);
+	ei_bool_t written;
+	const uint8_t *pixels;
+	int key[4], image_key[4], fd, stride, y;
+
+	hw_surface_get_channel_indices(channels, &key[0], &key[1], &key[2], &key[3]);
+	hw_surface_get_channel_indices(image, &image_key[0], &image_key[1], &image_key[2], &image_key[3]);
+	// Un fichier relu doit redonner exactement la surface décodée
+	if (memcmp(key, image_key, sizeof(key)) != 0 || !cache_file(filename, key, path, source, &info) ||
+	    sizeof(disk_header_t) + strlen(source) > DISK_HEADER_SIZE) {
+		return;
+	}
+
+	page = calloc(1, DISK_HEADER_SIZE);
+	header = (disk_header_t *) page;
+	memcpy(header->magic, DISK_MAGIC, sizeof(header->magic));
+	header->width = size.width;
+	header->height = size.height;
+	header->stride = 4 * size.width;
+	memcpy(header->channels, key, sizeof(header->channels));
+	header->source_size = (int64_t) info.st_size;
+	header->source_mtime = (int64_t) info.st_mtime;
+	header->source_mtime_nsec = mtime_nsec(&info);
+	header->path_length = (int32_t) strlen(source);
+	memcpy(page + sizeof(disk_header_t), source, header->path_length);
+
+	snprintf(temporary, sizeof(temporary), "%s.%ld.tmp", path, (long) getpid());
+	if ((fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+		free(page);
+		return;
+	}
+	hw_surface_lock(image);
+	pixels = ei_surface_get_buffer(image);
+	stride = ei_surface_get_stride(image);
+	written = write_all(fd, page, DISK_HEADER_SIZE);
+	if (stride == header->stride) {
+		written = (ei_bool_t) (written && write_all(fd, pixels, (size_t) header->stride * size.height));
+	} else { // Lignes de la surface espacées : écrites une à une, sans leur marge
+		for (y = 0; written && y < size.height; y++) {
+			written = write_all(fd, pixels + (size_t) y * stride, (size_t) header->stride);
+		}
+	}
+	hw_surface_unlock(image);
+	written = (ei_bool_t) (close(fd) == 0 && written);
+	if (!written || rename(temporary, path) != 0) {
+		unlink(temporary);
+	}
+	free(page);
+}
+
+#else
+
+void ei_image_disk_set_directory(const char *directory) {
+}
+
+ei_surface_t ei_image_disk_load(const char *filename, ei_surface_t channels) {
+	return NULL;
+}
+
+void ei_image_disk_store(const char *filename, ei_surface_t channels, ei_surface_t image) {
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+
+#include "ei_application_utils.h"
+#include "ei_manager_utils.h"
+#include "ei_placer_utils.h"
+
+ei_manager_t *ei_manager_get(ei_widget_t *container, ei_manager_kind_t kind) {
+	ei_manager_t *manager = container->manager;
+	if (manager == NULL) {
+		manager = calloc(1, sizeof(ei_manager_t));
+		manager->kind = kind;
+		manager->direction = ei_axis_y;
+		manager->first_changed = INT_MAX;
+		container->manager = manager;
+	}
+	assert((manager->kind == kind)); // Un seul gestionnaire par conteneur
+	return manager;
+}
+
+ei_manager_cell_t *ei_manager_attach(ei_widget_t *widget, ei_manager_kind_t kind) {
+	ei_manager_t *manager = ei_manager_get(widget->parent, kind);
+	ei_manager_cell_t *cell;
+
+	if (widget->manager_slot < 0) {
+		if (manager->length == manager->capacity) {
+			manager->capacity = (manager->capacity == 0) ? 16 : 2 * manager->capacity;
+			manager->cells = realloc(manager->cells, manager->capacity * sizeof(ei_manager_cell_t));
+		}
+		widget->manager_slot = manager->length++;
+		cell = &manager->cells[widget->manager_slot];
+		memset(cell, 0, sizeof(ei_manager_cell_t));
+		cell->widget = widget;
+		cell->anchor = ei_anc_center;
+	}
+	cell = &manager->cells[widget->manager_slot];
+	cell->changed = EI_TRUE;
+	if (kind == ei_manager_pack) {
+		manager->first_changed = min(manager->first_changed, widget->manager_slot);
+	}
+	ei_manager_changed(widget->parent, manager);
+	return cell;
+}
+
+void ei_manager_detach(ei_widget_t *widget) {
+	ei_manager_t *manager;
+	int slot = widget->manager_slot;
+	int i;
+
+	if (slot < 0) {
+		return;
+	}
+	manager = widget->parent->manager;
+	widget->manager_slot = -1;
+	manager->length--;
+	if (manager->kind == ei_manager_grid) {
+		// L'ordre des cellules n'importe pas : la dernière prend la place libérée
+		if (slot != manager->length) {
+			manager->cells[slot] = manager->cells[manager->length];
+			manager->cells[slot].widget->manager_slot = slot;
+		}
+	} else {
+		// Ordre d'empilement conservé : les suivants seront replacés
+		memmove(&manager->cells[slot], &manager->cells[slot + 1],
+			(manager->length - slot) * sizeof(ei_manager_cell_t));
+		for (i = slot; i < manager->length; i++) {
+			manager->cells[i].widget->manager_slot = i;
+		}
+		manager->first_changed = min(manager->first_changed, slot);
+	}
+	ei_manager_changed(widget->parent, manager);
+}
+
+void ei_manager_notify(ei_widget_t *widget) {
+	ei_manager_t *manager;
+	if (widget->manager_slot < 0) {
+		return;
+	}
+	manager = widget->parent->manager;
+	manager->cells[widget->manager_slot].changed = EI_TRUE;
+	if (manager->kind == ei_manager_pack) {
+		manager->first_changed = min(manager->first_changed, widget->manager_slot);
+	}
+	ei_manager_changed(widget->parent, manager);
+}
+
+void ei_manager_changed(ei_widget_t *container, ei_manager_t *manager) {
+	if (!manager->dirty) {
+		manager->dirty = EI_TRUE;
+		ei_layout_mark_children(container);
+	}
+}
+
+void ei_manager_free(ei_widget_t *container) {
+	ei_manager_t *manager = container->manager;
+	int i;
+	if (manager == NULL) {
+		return;
+	}
+	for (i = 0; i < manager->length; i++) {
+		manager->cells[i].widget->manager_slot = -1;
+	}
+	free(manager->cells);
+	free(manager->column_width);
+	free(manager->column_x);
+	free(manager->row_height);
+	free(manager->row_y);
+	free(manager);
+	container->manager = NULL;
+}
+
+void ei_manager_layout(ei_widget_t *container) {
+	ei_manager_t *manager = container->manager;
+	if (manager == NULL) {
+		return;
+	}
+	if (manager->kind == ei_manager_grid) {
+		grid_layout(manager);
+	} else {
+		pack_layout(container, manager);
+	}
+}
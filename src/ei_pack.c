@@ -0,0 +1,98 @@
+#include <limits.h>
+
+#include "ei_application.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+#include "ei_pack.h"
+
+#include "ei_application_utils.h"
+#include "ei_manager_utils.h"
+#include "ei_placer_utils.h"
+
+/**
+ * \brief	Configures the geometry of a widget using the "pack" geometry manager: the widgets
+ *		are stacked in their parent's *content_rect*, from top to bottom (or from left to
+ *		right), in the order of their first call to this function.
+ *
+ * @param	widget		The widget to place.
+ * @param	fill		If EI_TRUE, the widget takes the whole width of the container (its
+ *				whole height when stacked from left to right). Defaults to EI_FALSE.
+ */
+void ei_pack(struct ei_widget_t *widget, ei_bool_t *fill) {
+	ei_manager_cell_t *cell = ei_manager_attach(widget, ei_manager_pack);
+	if (fill != NULL) {
+		cell->fill = *fill;
+	}
+}
+
+/**
+ * \brief	Configures the stack of a container.
+ *
+ * @param	container	The parent of the packed widgets.
+ * @param	direction	ei_axis_x to stack from left to right, ei_axis_y to stack from top
+ *				to bottom (defaults to ei_axis_y).
+ * @param	spacing		Space between two widgets (defaults to 0).
+ */
+void ei_pack_configure(struct ei_widget_t *container, ei_axis_set_t *direction, int *spacing) {
+	ei_manager_t *manager = ei_manager_get(container, ei_manager_pack);
+	if (direction != NULL && (*direction == ei_axis_x || *direction == ei_axis_y)) {
+		manager->direction = *direction;
+	}
+	if (spacing != NULL) {
+		manager->spacing = *spacing;
+	}
+	manager->first_changed = 0; // Toute la pile bouge
+	ei_manager_changed(container, manager);
+}
+
+/**
+ * \brief	Removes a widget from the stack of its parent, and from the screen. The next
+ *		widgets move up (or left).
+ *
+ * @param	widget		The widget to remove from screen.
+ */
+void ei_pack_forget(struct ei_widget_t *widget) {
+	if (widget->placer_params != NULL) {
+		ei_app_invalidate_rect(&widget->screen_location);
+	}
+	ei_placer_forget(widget); // Quitte aussi la pile
+}
+
+void pack_layout(ei_widget_t *container, ei_manager_t *manager) {
+	ei_size_t content = container->content_rect->size;
+	ei_bool_t resized = content.width != manager->content_size.width ||
+			    content.height != manager->content_size.height;
+	ei_bool_t horizontal = (manager->direction == ei_axis_x);
+	ei_manager_cell_t *cell;
+	ei_rect_t rect;
+	int pos = 0;
+	int i;
+
+	if (!manager->dirty && !resized) {
+		return;
+	}
+	// Un seul parcours : les positions sont la somme des tailles mesurées qui précèdent
+	for (i = 0; i < manager->length; i++) {
+		cell = &manager->cells[i];
+		if (cell->changed) {
+			cell->measured = cell->widget->requested_size;
+			cell->changed = EI_FALSE;
+		}
+		// Avant le premier changement, rien ne bouge sauf les widgets étirés si le conteneur change de taille
+		if (i >= manager->first_changed || (resized && cell->fill)) {
+			if (horizontal) {
+				rect = ei_rect(ei_point(pos, 0), ei_size(cell->measured.width,
+									 cell->fill ? content.height : cell->measured.height));
+			} else {
+				rect = ei_rect(ei_point(0, pos), ei_size(cell->fill ? content.width : cell->measured.width,
+									 cell->measured.height));
+			}
+			place_in_parent(cell->widget, rect);
+		}
+		pos += (horizontal ? cell->measured.width : cell->measured.height) + manager->spacing;
+	}
+	manager->first_changed = INT_MAX;
+	manager->dirty = EI_FALSE;
+	manager->content_size = content;
+}
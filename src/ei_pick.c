@@ -0,0 +1,179 @@
+#include <stdlib.h>
+
+#include "ei_types.h"
+#include "ei_utils.h"
+
+#include "ei_application_utils.h"
+#include "ei_arena.h"
+#include "ei_draw_utils.h"
+#include "ei_pick.h"
+#include "ei_stats.h"
+
+ei_pick_buffer_t *ei_pick_buffer_create(ei_rect_t rect, int id_bits, ei_bool_t half_resolution) {
+	ei_pick_buffer_t *buffer = malloc(sizeof(ei_pick_buffer_t));
+	buffer->rect = rect;
+	buffer->shift = half_resolution ? 1 : 0;
+	buffer->id_bits = (id_bits == 16) ? 16 : 32;
+	buffer->stride = (rect.size.width + buffer->shift) >> buffer->shift;
+	buffer->rows = (rect.size.height + buffer->shift) >> buffer->shift;
+	buffer->ids = calloc((size_t) buffer->stride * buffer->rows, buffer->id_bits / 8);
+	return buffer;
+}
+
+void ei_pick_buffer_free(ei_pick_buffer_t *buffer) {
+	if (buffer == NULL) {
+		return;
+	}
+	free(buffer->ids);
+	free(buffer);
+}
+
+/**
+ * \brief	Returns the id stored at column "col" and row "row" of the storage.
+ */
+static inline uint32_t stored_id(const ei_pick_buffer_t *buffer, int col, int row) {
+	if (buffer->id_bits == 16) {
+		return ((uint16_t *) buffer->ids)[row * buffer->stride + col];
+	} else {
+		return ((uint32_t *) buffer->ids)[row * buffer->stride + col];
+	}
+}
+
+/**
+ * \brief	Returns true if the pixel (x, y) lies in the buffer's rect.
+ */
+static inline ei_bool_t in_buffer(const ei_pick_buffer_t *buffer, int x, int y) {
+	int col = x - buffer->rect.top_left.x;
+	int row = y - buffer->rect.top_left.y;
+	return (ei_bool_t) (col >= 0 && row >= 0 && col < buffer->rect.size.width && row < buffer->rect.size.height);
+}
+
+uint32_t ei_pick_buffer_get(const ei_pick_buffer_t *buffer, int x, int y) {
+	if (!in_buffer(buffer, x, y)) {
+		return 0;
+	}
+	return stored_id(buffer, (x - buffer->rect.top_left.x) >> buffer->shift,
+			 (y - buffer->rect.top_left.y) >> buffer->shift);
+}
+
+ei_bool_t ei_pick_buffer_is_exact(const ei_pick_buffer_t *buffer, int x, int y) {
+	if (buffer->shift == 0 || !in_buffer(buffer, x, y)) {
+		return EI_TRUE;
+	}
+	// Échantillons qui encadrent le pixel
+	int col = x - buffer->rect.top_left.x;
+	int row = y - buffer->rect.top_left.y;
+	int col0 = col >> 1, col1 = min((col + 1) >> 1, buffer->stride - 1);
+	int row0 = row >> 1, row1 = min((row + 1) >> 1, buffer->rows - 1);
+	uint32_t id = stored_id(buffer, col0, row0);
+	return (ei_bool_t) (stored_id(buffer, col1, row0) == id && stored_id(buffer, col0, row1) == id &&
+			    stored_id(buffer, col1, row1) == id);
+}
+
+ei_rect_t ei_pick_buffer_samples_rect(const ei_pick_buffer_t *buffer, int x, int y) {
+	if (buffer->shift == 0 || !in_buffer(buffer, x, y)) {
+		return ei_rect(ei_point(x, y), ei_size(1, 1));
+	}
+	// Même encadrement que ei_pick_buffer_is_exact, ramené aux pixels des échantillons
+	int col = x - buffer->rect.top_left.x;
+	int row = y - buffer->rect.top_left.y;
+	int col0 = col >> 1, col1 = min((col + 1) >> 1, buffer->stride - 1);
+	int row0 = row >> 1, row1 = min((row + 1) >> 1, buffer->rows - 1);
+	return ei_rect(ei_point(buffer->rect.top_left.x + 2 * col0, buffer->rect.top_left.y + 2 * row0),
+		       ei_size(2 * (col1 - col0) + 1, 2 * (row1 - row0) + 1));
+}
+
+void ei_pick_fill_span(ei_pick_buffer_t *buffer, int y, int x_min, int x_max, uint32_t id) {
+	int row = y - buffer->rect.top_left.y;
+	int col_min = x_min - buffer->rect.top_left.x;
+	int col_max = x_max - buffer->rect.top_left.x;
+	int col;
+	if (buffer->shift) { // Seuls les pixels pairs sont échantillonnés
+		if (row & 1) {
+			return;
+		}
+		row >>= 1;
+		col_min = (col_min + 1) >> 1;
+		col_max = (col_max + 1) >> 1;
+	}
+	if (buffer->id_bits == 16) {
+		uint16_t *ptr = (uint16_t *) buffer->ids + row * buffer->stride;
+		uint16_t value = (uint16_t) id;
+		for (col = col_min; col < col_max; col++) {
+			ptr[col] = value;
+		}
+	} else {
+		uint32_t *ptr = (uint32_t *) buffer->ids + row * buffer->stride;
+		for (col = col_min; col < col_max; col++) {
+			ptr[col] = id;
+		}
+	}
+	ei_stats_add(ei_stats_pick_pixels, col_max - col_min);
+}
+
+/**
+ * \brief	Returns the intersection of the buffer's rect and "clipper".
+ */
+static ei_rect_t clipped_area(const ei_pick_buffer_t *buffer, const ei_rect_t *clipper) {
+	if (clipper == NULL) {
+		return buffer->rect;
+	}
+	return rect_intersection(buffer->rect, *clipper);
+}
+
+void ei_pick_fill_rect(ei_pick_buffer_t *buffer, const ei_rect_t *rect, uint32_t id, const ei_rect_t *clipper) {
+	ei_rect_t area = rect_intersection(clipped_area(buffer, clipper), *rect);
+	int y;
+	if (area.size.width <= 0 || area.size.height <= 0) {
+		return;
+	}
+	for (y = area.top_left.y; y < area.top_left.y + area.size.height; y++) {
+		ei_pick_fill_span(buffer, y, area.top_left.x, area.top_left.x + area.size.width, id);
+	}
+}
+
+void ei_pick_fill_polygon(ei_pick_buffer_t *buffer, const ei_linked_point_t *first_point, uint32_t id,
+			  const ei_rect_t *clipper) {
+	ei_rect_t area = clipped_area(buffer, clipper);
+	int y = 0, x_min, x_max;
+	int y_end = area.top_left.y + area.size.height;
+	ei_side_table tc;
+	ei_side *tca = NULL;
+	ei_side *side;
+	ei_arena_mark_t mark;
+
+	if (first_point == NULL || area.size.width <= 0 || area.size.height <= 0) {
+		return;
+	}
+	mark = ei_arena_mark();
+	tc = construct_side_table(y_end, first_point);
+	while (((tc.length != 0) || (tca != NULL)) && y < y_end) {
+		move_sides_to_tca(&tc, y, &tca);
+		delete_ymax_from_tca(&tca, y);
+		sort_side_table(tca);
+
+		// Intervalles intérieurs au polygone : entre le 1er et le 2e côté, le 3e et le 4e...
+		if (y >= area.top_left.y) {
+			for (side = tca; side != NULL && side->next != NULL; side = side->next->next) {
+				x_min = max(side->x_ymin, area.top_left.x);
+				x_max = min(side->next->x_ymin, area.top_left.x + area.size.width);
+				if (x_min < x_max) {
+					ei_pick_fill_span(buffer, y, x_min, x_max, id);
+				}
+			}
+		}
+
+		y++;
+		update_scanline(tca, y);
+	}
+	ei_arena_rewind(mark);
+}
+
+ei_color_t ei_pick_id_to_color(uint32_t id) {
+	ei_color_t color;
+	color.red = (unsigned char) (id & 0xff);
+	color.green = (unsigned char) ((id >> 8) & 0xff);
+	color.blue = (unsigned char) ((id >> 16) & 0xff);
+	color.alpha = 0xff;
+	return color;
+}
@@ -1,6 +1,7 @@
 #include "ei_types.h"
 #include "ei_widget.h"
 
+#include "ei_manager_utils.h"
 #include "ei_placer_utils.h"
 
 /**
@@ -11,6 +12,10 @@
  * 		If the widget was already managed by the "placer", then this calls simply updates
  *		the placer parameters: arguments that are not NULL replace previous values.
  *
+ *		The geometry is not computed immediately: it is computed for every placed widget at
+ *		once, before the next frame is drawn (see \ref ei_placer_flush). Placing a widget
+ *		several times before a frame costs a single computation.
+ *
  * 		When the arguments are passed as NULL, the placer uses default values (detailed in
  *		the argument descriptions below). If no size is provided (either absolute or
  *		relative), then either the requested size of the widget is used if one was provided,
@@ -44,14 +49,15 @@ void ei_place(struct ei_widget_t *widget,
 	      float *rel_y,
 	      float *rel_width,
 	      float *rel_height) {
+	ei_manager_detach(widget); // Placé explicitement : quitte la grille ou la pile
 	init_placer_params(widget);
 	manage_anchor(widget, anchor);
 	manage_coord_x(widget, x, rel_x);
 	manage_coord_y(widget, y, rel_y);
 	manage_width(widget, width, rel_width);
 	manage_height(widget, height, rel_height);
-	manage_screen_location(widget);
-	widget->wclass->geomnotifyfunc(widget, widget->screen_location);
+	// La géométrie est calculée une seule fois, au prochain dessin (ou par ei_placer_flush)
+	ei_layout_mark(widget);
 }
 
 
@@ -64,6 +70,10 @@ void ei_place(struct ei_widget_t *widget,
  * @param	widget		The widget which geometry must be re-computed.
  */
 void ei_placer_run(struct ei_widget_t *widget) {
+	if (widget->manager_slot >= 0) {
+		ei_manager_notify(widget);
+		return;
+	}
 	ei_place(widget, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
 }
 
@@ -75,5 +85,18 @@ void ei_placer_run(struct ei_widget_t *widget) {
  * @param	widget		The widget to remove from screen.
  */
 void ei_placer_forget(struct ei_widget_t *widget) {
+	ei_manager_detach(widget);
 	forget_placer_params(widget);
 }
+
+
+/**
+ * \brief	Computes now the geometry of every widget placed since the last frame.
+ *
+ *		\ref ei_place only records the placement parameters: the geometry is computed once
+ *		per frame, before drawing. Call this function to read the "screen_location" of a
+ *		widget right after placing it.
+ */
+void ei_placer_flush(void) {
+	ei_layout_update();
+}
@@ -1,45 +1,30 @@
 #include <stdlib.h>
+#include <string.h>
 
+#include "ei_application.h"
 #include "ei_types.h"
 #include "ei_utils.h"
 #include "ei_widget.h"
 
 #include "ei_application_utils.h"
+#include "ei_geometry.h"
+#include "ei_manager_utils.h"
 #include "ei_placer_utils.h"
+#include "ei_slab.h"
+
+/** Global variables **/
+/**                  **/
+ei_slab_t PLACER_SLAB = EI_SLAB_INITIALIZER(sizeof(ei_placer_params_t));
+ei_bool_t LAYOUT_PENDING = EI_FALSE;	///< Some widget is marked for the next layout pass
+/**                  **/
+/** ---------------- **/
 
 void init_placer_params(struct ei_widget_t *widget) {
 	if (widget->placer_params != NULL) {
 		return;
 	}
-	// If not managed by placer, create placer_params
-	ei_placer_params_t *param = malloc(sizeof(ei_placer_params_t));
-	param->anchor = malloc(sizeof(ei_anchor_t));
-	param->anchor = NULL;
-	param->x = malloc(sizeof(int));
-	param->x = NULL;
-	param->x_data = 0;
-	param->y = malloc(sizeof(int));
-	param->y = NULL;
-	param->y_data = 0;
-	param->w = malloc(sizeof(int));
-	param->w = NULL;
-	param->w_data = 0;
-	param->h = malloc(sizeof(int));
-	param->h = NULL;
-	param->h_data = 0;
-	param->rx = malloc(sizeof(float));
-	param->rx = NULL;
-	param->rx_data = 0;
-	param->ry = malloc(sizeof(float));
-	param->ry = NULL;
-	param->ry_data = 0;
-	param->rw = malloc(sizeof(float));
-	param->rw = NULL;
-	param->rw_data = 0;
-	param->rh = malloc(sizeof(float));
-	param->rh = NULL;
-	param->rh_data = 0;
-
+	// If not managed by placer, create placer_params (tous les champs à NULL ou 0)
+	ei_placer_params_t *param = ei_slab_alloc(&PLACER_SLAB);
 	widget->placer_params = param;
 }
 
@@ -49,6 +34,11 @@ void forget_placer_params(ei_widget_t *widget) {
 		return;
 	}
 	widget->placer_params = NULL;
+	ei_slab_free(&PLACER_SLAB, param);
+}
+
+void free_placer_slab(void) {
+	ei_slab_release(&PLACER_SLAB);
 }
 
 void manage_anchor(ei_widget_t *widget, ei_anchor_t *anchor) {
@@ -183,7 +173,8 @@ void manage_width(ei_widget_t *widget, int *width, float *rel_width) {
 	// 1. valeur par default (placer_params)
 	// 2. requested_size
 	// 3. = 0
-	int w = 0, rw = 0;
+	int w = 0;
+	float rw = 0;
 
 	if (rel_width != NULL) {
 		// rel_width
@@ -220,7 +211,8 @@ void manage_height(ei_widget_t *widget, int *height, float *rel_height) {
 	// 1. valeur default (placer_params)
 	// 2. requested_size
 	// 3. = 0
-	int h = 0, rh = 0;
+	int h = 0;
+	float rh = 0;
 
 	if (rel_height != NULL) {
 		// rel_height
@@ -254,21 +246,24 @@ void manage_height(ei_widget_t *widget, int *height, float *rel_height) {
 struct double_int
 get_direction_most(int parent_dimension, int parent_c, float *rel_dimension, int *dimension, float *rel_c, int *c,
 		   float left, float right) {
-	int pos_c;
+	// Position dans le parent : origine + position relative + décalage absolu
+	int pos_c = parent_c;
+	int size = 0;
 	struct double_int lr;
+	if (rel_c != NULL) {
+		pos_c += (*rel_c) * parent_dimension;
+	}
 	if (c != NULL) {
-		pos_c = *c;
-	} else {
-		pos_c = parent_c + (*rel_c) * parent_dimension;
+		pos_c += *c;
 	}
 
 	if (dimension != NULL) {
-		lr.left = pos_c + (left * (*dimension));
-		lr.right = pos_c + (right * (*dimension));
+		size = *dimension;
 	} else if (rel_dimension != NULL) {
-		lr.left = pos_c + (left * (*rel_dimension) * parent_dimension);
-		lr.right = pos_c + (right * (*rel_dimension) * parent_dimension);
+		size = (*rel_dimension) * parent_dimension;
 	}
+	lr.left = pos_c + (left * size);
+	lr.right = pos_c + (right * size);
 	return lr;
 }
 
@@ -297,8 +292,172 @@ void manage_screen_location(ei_widget_t *widget) {
 	screen_location.top_left.y = y_coord.left;
 	screen_location.size.height = y_coord.right - y_coord.left;
 
+	// Pas d'intersection avec le parent : les enfants sont découpés au dessin
+	widget->screen_location = screen_location;
+	widget->layout_parent = parent_rect;
+}
+
+/**
+ * \brief	Sets "flag" on "widget", and ei_layout_descendants on its ancestors.
+ */
+static void layout_mark(ei_widget_t *widget, int flag) {
+	ei_widget_t *ptr;
+	widget->layout_flags |= flag;
+	for (ptr = widget->parent; ptr != NULL && !(ptr->layout_flags & ei_layout_descendants); ptr = ptr->parent) {
+		ptr->layout_flags |= ei_layout_descendants;
+	}
+	LAYOUT_PENDING = EI_TRUE;
+}
+
+void ei_layout_mark(ei_widget_t *widget) {
+	layout_mark(widget, ei_layout_self);
+}
+
+void ei_layout_mark_children(ei_widget_t *widget) {
+	layout_mark(widget, ei_layout_children);
+}
+
+void place_in_parent(ei_widget_t *widget, ei_rect_t rect) {
+	ei_placer_params_t *params;
+	init_placer_params(widget);
+	params = widget->placer_params;
+	if (params->x == &params->x_data && params->y == &params->y_data && params->w == &params->w_data &&
+	    params->h == &params->h_data && params->rx == NULL && params->ry == NULL && params->rw == NULL &&
+	    params->rh == NULL && params->anchor_data == ei_anc_northwest && params->x_data == rect.top_left.x &&
+	    params->y_data == rect.top_left.y && params->w_data == rect.size.width &&
+	    params->h_data == rect.size.height) {
+		return; // Déjà à cette place
+	}
+	memset(params, 0, sizeof(ei_placer_params_t));
+	params->anchor_data = ei_anc_northwest;
+	params->anchor = &params->anchor_data;
+	params->x_data = rect.top_left.x;
+	params->x = &params->x_data;
+	params->y_data = rect.top_left.y;
+	params->y = &params->y_data;
+	params->w_data = rect.size.width;
+	params->w = &params->w_data;
+	params->h_data = rect.size.height;
+	params->h = &params->h_data;
+	widget->layout_flags |= ei_layout_self;
+}
+
+ei_bool_t ei_layout_is_pending(void) {
+	return LAYOUT_PENDING;
+}
+
+/**
+ * \brief	Tells if the geometry of "widget" depends on the size of its parent.
+ */
+static ei_bool_t has_relative_params(const ei_placer_params_t *params) {
+	return (ei_bool_t) (params->rx != NULL || params->ry != NULL || params->rw != NULL || params->rh != NULL);
+}
+
+/**
+ * \brief	Invalidates the union of the old and new locations of a widget, within the content_rect
+ * 		of its parent. An empty location (widget never displayed) is ignored.
+ */
+static void invalidate_move(ei_widget_t *widget, ei_rect_t old) {
+	ei_rect_t new = widget->screen_location;
+	ei_rect_t damage;
+	if (old.size.width <= 0 || old.size.height <= 0) {
+		damage = new;
+	} else if (new.size.width <= 0 || new.size.height <= 0) {
+		damage = old;
+	} else {
+		damage = rect_union(old, new);
+	}
 	if (widget->parent != NULL) {
-		screen_location = rect_intersection(screen_location, parent_rect);
+		damage = rect_intersection(damage, *widget->parent->content_rect);
+	}
+	if (damage.size.width > 0 && damage.size.height > 0) {
+		ei_app_invalidate_rect(&damage);
+	}
+}
+
+/**
+ * \brief	Computes the geometry of "widget" if it was placed since the last pass, or if the
+ * 		content_rect of its parent changed since it was computed. Marks "widget" if its own
+ * 		content_rect changed, so that the pass places its children again.
+ *
+ * @param	widget
+ * @param	parent_damaged	If true, the area of an ancestor is already invalidated.
+ */
+static void layout_widget(ei_widget_t *widget, ei_bool_t parent_damaged) {
+	const ei_geometry_table_t *table = ei_geometry_table();
+	ei_rect_t parent_rect = ei_geometry_rect(&table->content, table->parent[widget->pick_id]); // Entrée 0 pour la racine
+	ei_bool_t placed = (ei_bool_t) ((widget->layout_flags & ei_layout_self) != 0);
+	ei_rect_t old, content;
+	int dx, dy;
+
+	widget->layout_flags &= ~ei_layout_self;
+	if (widget->placer_params == NULL || (!placed && rect_equal(parent_rect, widget->layout_parent))) {
+		return;
+	}
+	old = widget->screen_location;
+	content = *widget->content_rect;
+	if (!placed && ((parent_rect.size.width == widget->layout_parent.size.width &&
+			 parent_rect.size.height == widget->layout_parent.size.height) ||
+			!has_relative_params(widget->placer_params))) {
+		// Translation seule : pas de nouveau calcul
+		dx = parent_rect.top_left.x - widget->layout_parent.top_left.x;
+		dy = parent_rect.top_left.y - widget->layout_parent.top_left.y;
+		widget->screen_location.top_left.x += dx;
+		widget->screen_location.top_left.y += dy;
+		if (widget->content_rect != &widget->screen_location) {
+			widget->content_rect->top_left.x += dx;
+			widget->content_rect->top_left.y += dy;
+		}
+		widget->layout_parent = parent_rect;
+	} else {
+		manage_screen_location(widget);
+	}
+	widget->wclass->geomnotifyfunc(widget, widget->screen_location);
+	ei_geometry_sync(widget);
+
+	if (!rect_equal(old, widget->screen_location)) {
+		// Un seul rectangle par widget déplacé, s'il n'est pas déjà dans la zone d'un ancêtre
+		if (!parent_damaged) {
+			invalidate_move(widget, old);
+		}
+		widget->layout_flags |= ei_layout_damaged;
+	}
+	if (!rect_equal(content, *widget->content_rect)) {
+		widget->layout_flags |= ei_layout_children;
+	}
+}
+
+void ei_layout_update(void) {
+	ei_widget_t *root = ei_app_root_widget();
+	ei_widget_t *widget = root;
+	ei_widget_t *child;
+	ei_bool_t damaged;
+
+	if (!LAYOUT_PENDING) {
+		return;
+	}
+	LAYOUT_PENDING = EI_FALSE;
+	layout_widget(root, EI_FALSE);
+
+	// Parcours préfixe sans récursion, limité aux widgets marqués
+	while (widget != NULL) {
+		if (widget->layout_flags != 0 && widget->children_head != NULL) {
+			damaged = (ei_bool_t) ((widget->layout_flags & ei_layout_damaged) != 0);
+			widget->layout_flags = 0;
+			ei_manager_layout(widget); // Grille ou empilement : place les enfants qui ont changé
+			for (child = widget->children_head; child != NULL; child = child->next_sibling) {
+				layout_widget(child, damaged);
+				if (damaged && child->layout_flags != 0) {
+					child->layout_flags |= ei_layout_damaged;
+				}
+			}
+			widget = widget->children_head;
+			continue;
+		}
+		widget->layout_flags = 0;
+		while (widget != root && widget->next_sibling == NULL) {
+			widget = widget->parent;
+		}
+		widget = (widget == root) ? NULL : widget->next_sibling;
 	}
-	widget->screen_location = screen_location;
 }
@@ -0,0 +1,330 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __WIN__
+#include <pthread.h>
+#endif
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_event.h"
+#include "ei_types.h"
+
+#include "ei_application_utils.h"
+#include "ei_record.h"
+
+/*
+ * Format du fichier : "EIRC", un octet de version, puis pour chaque évènement :
+ * délai depuis le précédent (u32, en microsecondes), type (u8), puis selon le type
+ *	- clavier : key_code (i32), modifier_mask (u32)
+ *	- souris : x (i32), y (i32), button (u8), modifier_mask (u32)
+ * Les entiers sont écrits en little-endian.
+ */
+#define RECORD_MAGIC		"EIRC"
+#define RECORD_VERSION		1
+#define REPLAY_TAIL		1.0	///< Durée (virtuelle) rejouée après le dernier évènement
+
+typedef struct {
+	double	due;
+	void	*user_param;
+} replay_timer_t;
+
+typedef struct {
+	unsigned long	count;
+	double		sum;
+	double		max;
+} replay_stat_t;
+
+/** Global variables **/
+/**                  **/
+FILE *RECORD_FILE = NULL;
+double RECORD_LAST;			///< Date of the last recorded event
+FILE *REPLAY_FILE = NULL;
+ei_bool_t REPLAY_ACTIVE = EI_FALSE;
+double VIRTUAL_NOW = 0;
+ei_event_t REPLAY_NEXT;			///< Next recorded event, read in advance
+double REPLAY_NEXT_DATE;
+ei_bool_t REPLAY_HAS_NEXT = EI_FALSE;
+double REPLAY_END;			///< Date after which the replay quits
+void **REPLAY_POSTED = NULL;		///< Queue of the application events posted during the replay
+size_t REPLAY_POSTED_HEAD = 0;
+size_t REPLAY_POSTED_TAIL = 0;
+size_t REPLAY_POSTED_CAPACITY = 0;
+#ifndef __WIN__
+pthread_mutex_t REPLAY_POSTED_LOCK = PTHREAD_MUTEX_INITIALIZER;	///< Posted from the decoding threads too
+#endif
+replay_timer_t *REPLAY_TIMERS = NULL;
+size_t REPLAY_TIMERS_LENGTH = 0;
+size_t REPLAY_TIMERS_CAPACITY = 0;
+replay_stat_t REPLAY_STATS[ei_ev_last + 1];
+/**                  **/
+/** ---------------- **/
+
+static void put_u32(FILE *file, uint32_t value) {
+	unsigned char bytes[4] = {value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, (value >> 24) & 0xff};
+	fwrite(bytes, 1, 4, file);
+}
+
+static ei_bool_t get_u32(FILE *file, uint32_t *value) {
+	unsigned char bytes[4];
+	if (fread(bytes, 1, 4, file) != 4) {
+		return EI_FALSE;
+	}
+	*value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+	return EI_TRUE;
+}
+
+static void write_event(FILE *file, double delay, const ei_event_t *event) {
+	put_u32(file, (uint32_t) (delay * 1e6));
+	fputc(event->type, file);
+	if (event->type == ei_ev_keydown || event->type == ei_ev_keyup) {
+		put_u32(file, (uint32_t) event->param.key.key_code);
+		put_u32(file, event->param.key.modifier_mask);
+	} else if (event->type >= ei_ev_mouse_buttondown) {
+		put_u32(file, (uint32_t) event->param.mouse.where.x);
+		put_u32(file, (uint32_t) event->param.mouse.where.y);
+		fputc(event->param.mouse.button, file);
+		put_u32(file, event->param.mouse.modifier_mask);
+	}
+}
+
+static ei_bool_t read_event(FILE *file, double *delay, ei_event_t *event) {
+	uint32_t delay_us, a, b, c;
+	int type, button;
+	memset(event, 0, sizeof(ei_event_t));
+	if (!get_u32(file, &delay_us) || (type = fgetc(file)) == EOF || type >= ei_ev_last) {
+		return EI_FALSE;
+	}
+	*delay = delay_us * 1e-6;
+	event->type = (ei_eventtype_t) type;
+	if (event->type == ei_ev_keydown || event->type == ei_ev_keyup) {
+		if (!get_u32(file, &a) || !get_u32(file, &b)) {
+			return EI_FALSE;
+		}
+		event->param.key.key_code = (SDL_Keycode) (int32_t) a;
+		event->param.key.modifier_mask = b;
+	} else if (event->type >= ei_ev_mouse_buttondown) {
+		if (!get_u32(file, &a) || !get_u32(file, &b) || (button = fgetc(file)) == EOF || !get_u32(file, &c)) {
+			return EI_FALSE;
+		}
+		event->param.mouse.where.x = (int32_t) a;
+		event->param.mouse.where.y = (int32_t) b;
+		event->param.mouse.button = (ei_mouse_button_t) button;
+		event->param.mouse.modifier_mask = c;
+	}
+	return EI_TRUE;
+}
+
+static void posted_lock(void) {
+#ifndef __WIN__
+	pthread_mutex_lock(&REPLAY_POSTED_LOCK);
+#endif
+}
+
+static void posted_unlock(void) {
+#ifndef __WIN__
+	pthread_mutex_unlock(&REPLAY_POSTED_LOCK);
+#endif
+}
+
+/**
+ * \brief	Reads the next recorded event in REPLAY_NEXT.
+ */
+static void read_next(void) {
+	double delay;
+	REPLAY_HAS_NEXT = read_event(REPLAY_FILE, &delay, &REPLAY_NEXT);
+	if (REPLAY_HAS_NEXT) {
+		REPLAY_NEXT_DATE += delay;
+		REPLAY_END = REPLAY_NEXT_DATE + REPLAY_TAIL;
+	}
+}
+
+ei_bool_t ei_record_start(const char *filename) {
+	char header[sizeof(RECORD_MAGIC)] = RECORD_MAGIC;
+	ei_record_stop();
+	RECORD_FILE = fopen(filename, "wb");
+	if (RECORD_FILE == NULL) {
+		return EI_FALSE;
+	}
+	fwrite(header, 1, 4, RECORD_FILE);
+	fputc(RECORD_VERSION, RECORD_FILE);
+	RECORD_LAST = hw_now();
+	return EI_TRUE;
+}
+
+ei_bool_t ei_replay_start(const char *filename) {
+	char header[5];
+	ei_record_stop();
+	REPLAY_FILE = fopen(filename, "rb");
+	if (REPLAY_FILE == NULL) {
+		return EI_FALSE;
+	}
+	if (fread(header, 1, 5, REPLAY_FILE) != 5 || memcmp(header, RECORD_MAGIC, 4) != 0 ||
+	    header[4] != RECORD_VERSION) {
+		fclose(REPLAY_FILE);
+		REPLAY_FILE = NULL;
+		return EI_FALSE;
+	}
+	memset(REPLAY_STATS, 0, sizeof(REPLAY_STATS));
+	VIRTUAL_NOW = 0;
+	REPLAY_NEXT_DATE = 0;
+	REPLAY_END = REPLAY_TAIL;
+	REPLAY_ACTIVE = EI_TRUE;
+	read_next();
+	return EI_TRUE;
+}
+
+void ei_record_stop(void) {
+	if (RECORD_FILE != NULL) {
+		fclose(RECORD_FILE);
+		RECORD_FILE = NULL;
+	}
+	if (REPLAY_ACTIVE) {
+		fclose(REPLAY_FILE);
+		REPLAY_FILE = NULL;
+		REPLAY_ACTIVE = EI_FALSE;
+		ei_replay_report(stdout);
+		posted_lock();
+		free(REPLAY_POSTED);
+		REPLAY_POSTED = NULL;
+		REPLAY_POSTED_HEAD = REPLAY_POSTED_TAIL = REPLAY_POSTED_CAPACITY = 0;
+		posted_unlock();
+		free(REPLAY_TIMERS);
+		REPLAY_TIMERS = NULL;
+		REPLAY_TIMERS_LENGTH = REPLAY_TIMERS_CAPACITY = 0;
+	}
+}
+
+void ei_replay_report(FILE *out) {
+	static const char *names[ei_ev_last + 1] = {"none", "app", "exposed", "keydown", "keyup",
+						    "mouse_buttondown", "mouse_buttonup", "mouse_move", "frame"};
+	int type;
+	fprintf(out, "%-18s %8s %12s %12s\n", "replay", "count", "mean (ms)", "max (ms)");
+	for (type = 0; type <= ei_ev_last; type++) {
+		replay_stat_t *stat = &REPLAY_STATS[type];
+		if (stat->count == 0) {
+			continue;
+		}
+		fprintf(out, "%-18s %8lu %12.3f %12.3f\n", names[type], stat->count, 1000 * stat->sum / stat->count,
+			1000 * stat->max);
+	}
+}
+
+ei_bool_t ei_replay_is_active(void) {
+	return REPLAY_ACTIVE;
+}
+
+void ei_replay_account(ei_eventtype_t type, double seconds) {
+	if (!REPLAY_ACTIVE) {
+		return;
+	}
+	replay_stat_t *stat = &REPLAY_STATS[type];
+	stat->count++;
+	stat->sum += seconds;
+	if (seconds > stat->max) {
+		stat->max = seconds;
+	}
+}
+
+/**
+ * \brief	Returns the index of the first timer of the replay, or -1 if there is none.
+ */
+static int first_timer(void) {
+	int first = -1;
+	size_t i;
+	for (i = 0; i < REPLAY_TIMERS_LENGTH; i++) {
+		if (first == -1 || REPLAY_TIMERS[i].due < REPLAY_TIMERS[first].due) {
+			first = (int) i;
+		}
+	}
+	return first;
+}
+
+void ei_event_wait_next(ei_event_t *event) {
+	int timer;
+	if (!REPLAY_ACTIVE) {
+		hw_event_wait_next(event);
+		if (RECORD_FILE != NULL && event->type != ei_ev_app) {
+			double now = hw_now();
+			write_event(RECORD_FILE, now - RECORD_LAST, event);
+			RECORD_LAST = now;
+		}
+		return;
+	}
+
+	memset(event, 0, sizeof(ei_event_t));
+	// Évènements déjà arrivés d'abord, puis évènements postés, puis le plus proche dans le temps
+	if (REPLAY_HAS_NEXT && REPLAY_NEXT_DATE <= VIRTUAL_NOW) {
+		*event = REPLAY_NEXT;
+		read_next();
+		return;
+	}
+	posted_lock();
+	if (REPLAY_POSTED_HEAD != REPLAY_POSTED_TAIL) {
+		event->type = ei_ev_app;
+		event->param.application.user_param = REPLAY_POSTED[REPLAY_POSTED_HEAD++ % REPLAY_POSTED_CAPACITY];
+		posted_unlock();
+		return;
+	}
+	posted_unlock();
+	timer = first_timer();
+	if (timer != -1 && (!REPLAY_HAS_NEXT || REPLAY_TIMERS[timer].due < REPLAY_NEXT_DATE) &&
+	    REPLAY_TIMERS[timer].due <= REPLAY_END) {
+		VIRTUAL_NOW = max(VIRTUAL_NOW, REPLAY_TIMERS[timer].due);
+		event->type = ei_ev_app;
+		event->param.application.user_param = REPLAY_TIMERS[timer].user_param;
+		REPLAY_TIMERS[timer] = REPLAY_TIMERS[--REPLAY_TIMERS_LENGTH];
+		return;
+	}
+	if (REPLAY_HAS_NEXT) {
+		VIRTUAL_NOW = REPLAY_NEXT_DATE;
+		*event = REPLAY_NEXT;
+		read_next();
+		return;
+	}
+	// Fin de la trace
+	ei_app_quit_request();
+	event->type = ei_ev_none;
+}
+
+void ei_event_post_app(void *user_param) {
+	if (!REPLAY_ACTIVE) {
+		hw_event_post_app(user_param);
+		return;
+	}
+	posted_lock();
+	if (REPLAY_POSTED_TAIL - REPLAY_POSTED_HEAD == REPLAY_POSTED_CAPACITY) { // File pleine : agrandie
+		size_t capacity = (REPLAY_POSTED_CAPACITY == 0) ? 16 : 2 * REPLAY_POSTED_CAPACITY;
+		void **posted = malloc(capacity * sizeof(void *));
+		size_t i, length = REPLAY_POSTED_TAIL - REPLAY_POSTED_HEAD;
+		for (i = 0; i < length; i++) {
+			posted[i] = REPLAY_POSTED[(REPLAY_POSTED_HEAD + i) % REPLAY_POSTED_CAPACITY];
+		}
+		free(REPLAY_POSTED);
+		REPLAY_POSTED = posted;
+		REPLAY_POSTED_HEAD = 0;
+		REPLAY_POSTED_TAIL = length;
+		REPLAY_POSTED_CAPACITY = capacity;
+	}
+	REPLAY_POSTED[REPLAY_POSTED_TAIL++ % REPLAY_POSTED_CAPACITY] = user_param;
+	posted_unlock();
+}
+
+void ei_event_schedule_app(int ms_delay, void *user_param) {
+	if (!REPLAY_ACTIVE) {
+		hw_event_schedule_app(ms_delay, user_param);
+		return;
+	}
+	if (REPLAY_TIMERS_LENGTH == REPLAY_TIMERS_CAPACITY) {
+		REPLAY_TIMERS_CAPACITY = (REPLAY_TIMERS_CAPACITY == 0) ? 8 : 2 * REPLAY_TIMERS_CAPACITY;
+		REPLAY_TIMERS = realloc(REPLAY_TIMERS, REPLAY_TIMERS_CAPACITY * sizeof(replay_timer_t));
+	}
+	REPLAY_TIMERS[REPLAY_TIMERS_LENGTH].due = VIRTUAL_NOW + ms_delay / 1000.0;
+	REPLAY_TIMERS[REPLAY_TIMERS_LENGTH].user_param = user_param;
+	REPLAY_TIMERS_LENGTH++;
+}
+
+double ei_now(void) {
+	return REPLAY_ACTIVE ? VIRTUAL_NOW : hw_now();
+}
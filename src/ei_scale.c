@@ -0,0 +1,345 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "ei_types.h"
+#include "ei_utils.h"
+
+#include "ei_application_utils.h"
+#include "ei_arena.h"
+#include "ei_scale.h"
+#include "ei_surface.h"
+
+/** Global variables **/
+/**                  **/
+ei_bool_t SCALE_SIMD = EI_TRUE;		///< The SSE2/AVX2 loops are used (see ei_scale_set_simd)
+/**                  **/
+/** ---------------- **/
+
+void ei_scale_set_simd(ei_bool_t enabled) {
+	SCALE_SIMD = enabled;
+}
+
+ei_size_t ei_scale_half_size(ei_size_t size) {
+	return ei_size(max(size.width / 2, 1), max(size.height / 2, 1));
+}
+
+int ei_scale_levels(ei_size_t src_size, ei_size_t dst_size, ei_filter_t filter) {
+	int levels = 0;
+	if (filter != ei_filter_bilinear) {
+		return 0;
+	}
+	while (src_size.width >= 2 * dst_size.width && src_size.height >= 2 * dst_size.height) {
+		src_size = ei_scale_half_size(src_size);
+		levels++;
+	}
+	return levels;
+}
+
+/**
+ * \brief	Returns the average of 4 pixels, byte by byte (two bytes at once in each 32 bits integer).
+ */
+static uint32_t average4(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+	uint32_t rb = (a & 0x00ff00ff) + (b & 0x00ff00ff) + (c & 0x00ff00ff) + (d & 0x00ff00ff) + 0x00020002;
+	uint32_t ga = ((a >> 8) & 0x00ff00ff) + ((b >> 8) & 0x00ff00ff) + ((c >> 8) & 0x00ff00ff) +
+		      ((d >> 8) & 0x00ff00ff) + 0x00020002;
+	return ((rb >> 2) & 0x00ff00ff) | ((ga << 6) & 0xff00ff00);
+}
+
+/**
+ * \brief	Returns (a * (256 - f) + b * f) / 256, byte by byte, for f in [0, 256].
+ */
+static uint32_t lerp(uint32_t a, uint32_t b, uint32_t f) {
+	uint32_t rb = ((a & 0x00ff00ff) * (256 - f) + (b & 0x00ff00ff) * f + 0x00800080) >> 8;
+	uint32_t ga = ((a >> 8) & 0x00ff00ff) * (256 - f) + ((b >> 8) & 0x00ff00ff) * f + 0x00800080;
+	return (rb & 0x00ff00ff) | (ga & 0xff00ff00);
+}
+
+void ei_scale_halve(uint32_t *dst, int dst_stride, const uint32_t *src, int src_stride, ei_size_t src_size) {
+	ei_size_t size = ei_scale_half_size(src_size);
+	int dx = (src_size.width > 1) ? 1 : 0;			// Une seule colonne : elle compte double
+	int dy = (src_size.height > 1) ? src_stride : 0;
+	const uint32_t *row0, *row1;
+	int x, y;
+
+	for (y = 0; y < size.height; y++) {
+		row0 = src + (size_t) 2 * y * src_stride;
+		row1 = row0 + dy;
+		x = 0;
+#if defined(__SSE2__)
+		if (dx == 1 && SCALE_SIMD) {
+			__m128i zero = _mm_setzero_si128();
+			__m128i round = _mm_set1_epi16(2);
+			for (; x + 2 <= size.width; x += 2) {
+				// Même arrondi que average4 : (a + b + c + d + 2) / 4, octet par octet sur 16 bits
+				__m128i r0 = _mm_loadu_si128((const __m128i *) (row0 + 2 * x));
+				__m128i r1 = _mm_loadu_si128((const __m128i *) (row1 + 2 * x));
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+				// lo : colonnes 0 et 1, hi : colonnes 2 et 3 -> sommes des paires (0, 1) et (2, 3)
+				__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+				sum = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+				_mm_storel_epi64((__m128i *) (dst + x), _mm_packus_epi16(sum, zero));
+			}
+		}
+#endif
+		for (; x < size.width; x++) {
+			dst[x] = average4(row0[2 * x], row0[2 * x + dx], row1[2 * x], row1[2 * x + dx]);
+		}
+		dst += dst_stride;
+	}
+}
+
+/**
+ * \brief	Adds the bytes of "width" pixels of "row" to "sums" (4 sums per pixel).
+ */
+static void accumulate_row(uint32_t *sums, const uint32_t *row, int width) {
+	int x = 0;
+#if defined(__AVX2__)
+	for (; SCALE_SIMD && x + 2 <= width; x += 2) {
+		__m256i *s = (__m256i *) (sums + 4 * x);
+		__m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (row + x)));
+		_mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s), bytes));
+	}
+#elif defined(__SSE2__)
+	__m128i zero = _mm_setzero_si128();
+	for (; SCALE_SIMD && x + 4 <= width; x += 4) {
+		__m128i *s = (__m128i *) (sums + 4 * x);
+		__m128i p = _mm_loadu_si128((const __m128i *) (row + x));
+		__m128i lo = _mm_unpacklo_epi8(p, zero);
+		__m128i hi = _mm_unpackhi_epi8(p, zero);
+		_mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), _mm_unpacklo_epi16(lo, zero)));
+		_mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1), _mm_unpackhi_epi16(lo, zero)));
+		_mm_storeu_si128(s + 2, _mm_add_epi32(_mm_loadu_si128(s + 2), _mm_unpacklo_epi16(hi, zero)));
+		_mm_storeu_si128(s + 3, _mm_add_epi32(_mm_loadu_si128(s + 3), _mm_unpackhi_epi16(hi, zero)));
+	}
+#endif
+	for (; x < width; x++) {
+		sums[4 * x] += row[x] & 0xff;
+		sums[4 * x + 1] += (row[x] >> 8) & 0xff;
+		sums[4 * x + 2] += (row[x] >> 16) & 0xff;
+		sums[4 * x + 3] += row[x] >> 24;
+	}
+}
+
+/**
+ * \brief	Box filter: each pixel of the result is the average of the block of source pixels that
+ * 		it covers (a single pixel when enlarging).
+ */
+static void box_scale(uint32_t *dst, int dst_stride, ei_size_t dst_size, const uint32_t *src, int src_stride,
+		      ei_size_t src_size) {
+	uint32_t *sums = ei_arena_alloc((size_t) src_size.width * 4 * sizeof(uint32_t));
+	int *columns = ei_arena_alloc((size_t) (dst_size.width + 1) * sizeof(int));
+	int x, y, c, i, y0, y1, previous_y0 = -1;
+	uint64_t total[4], count;	// 64 bits : un pixel du résultat peut couvrir plus de 2^24 pixels
+
+	for (x = 0; x <= dst_size.width; x++) {
+		columns[x] = (int) ((int64_t) x * src_size.width / dst_size.width);
+	}
+	for (y = 0; y < dst_size.height; y++, dst += dst_stride) {
+		y0 = (int) ((int64_t) y * src_size.height / dst_size.height);
+		y1 = max((int) ((int64_t) (y + 1) * src_size.height / dst_size.height), y0 + 1);
+		if (y0 == previous_y0) {
+			// Agrandissement : même bloc de lignes que la ligne précédente
+			memcpy(dst, dst - dst_stride, dst_size.width * sizeof(uint32_t));
+			continue;
+		}
+		previous_y0 = y0;
+		memset(sums, 0, (size_t) src_size.width * 4 * sizeof(uint32_t));
+		for (i = y0; i < y1; i++) {
+			accumulate_row(sums, src + (size_t) i * src_stride, src_size.width);
+		}
+		for (x = 0; x < dst_size.width; x++) {
+			int x0 = columns[x];
+			int x1 = max(columns[x + 1], x0 + 1);
+			total[0] = total[1] = total[2] = total[3] = 0;
+			for (i = x0; i < x1; i++) {
+				for (c = 0; c < 4; c++) {
+					total[c] += sums[4 * i + c];
+				}
+			}
+			count = (uint64_t) (x1 - x0) * (y1 - y0);
+			dst[x] = 0;
+			for (c = 0; c < 4; c++) {
+				dst[x] |= (uint32_t) ((total[c] + count / 2) / count) << (8 * c);
+			}
+		}
+	}
+}
+
+/**
+ * \brief	Computes, for each pixel of the result, the two source pixels that surround its center
+ * 		and the weight of the second one in [0, 256].
+ */
+static void bilinear_positions(int *first, int *second, int *weight, int dst_length, int src_length) {
+	int64_t position;
+	int i;
+	for (i = 0; i < dst_length; i++) {
+		// Centre du pixel i dans la source, en virgule fixe 16.16
+		position = ((int64_t) (2 * i + 1) * src_length << 16) / (2 * dst_length) - 32768;
+		position = max(position, 0);
+		first[i] = (int) (position >> 16);
+		weight[i] = (int) (position >> 8) & 0xff;
+		if (first[i] >= src_length - 1) {
+			first[i] = src_length - 1;
+			weight[i] = 0;
+		}
+		second[i] = min(first[i] + 1, src_length - 1);
+	}
+}
+
+/**
+ * \brief	Interpolates a source row at the horizontal positions of the result.
+ */
+static void interpolate_row(uint32_t *out, const uint32_t *row, const int *first, const int *second,
+			    const int *weight, int width) {
+	int x = 0;
+#if defined(__SSE2__)
+	__m128i zero = _mm_setzero_si128();
+	__m128i round = _mm_set1_epi16(128);
+	for (; SCALE_SIMD && x + 2 <= width; x += 2) {
+		// Deux pixels du résultat : (a, b) pour le premier, (c, d) pour le second
+		__m128i p0 = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int) row[first[x]]),
+								  _mm_cvtsi32_si128((int) row[second[x]])), zero);
+		__m128i p1 = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int) row[first[x + 1]]),
+								  _mm_cvtsi32_si128((int) row[second[x + 1]])), zero);
+		short f0 = (short) weight[x], f1 = (short) weight[x + 1];
+		p0 = _mm_mullo_epi16(p0, _mm_set_epi16(f0, f0, f0, f0, 256 - f0, 256 - f0, 256 - f0, 256 - f0));
+		p1 = _mm_mullo_epi16(p1, _mm_set_epi16(f1, f1, f1, f1, 256 - f1, 256 - f1, 256 - f1, 256 - f1));
+		p0 = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi64(p0, p1), _mm_unpackhi_epi64(p0, p1)), round);
+		_mm_storel_epi64((__m128i *) (out + x), _mm_packus_epi16(_mm_srli_epi16(p0, 8), zero));
+	}
+#endif
+	for (; x < width; x++) {
+		out[x] = lerp(row[first[x]], row[second[x]], (uint32_t) weight[x]);
+	}
+}
+
+/**
+ * \brief	Interpolates two rows: out = (row0 * (256 - f) + row1 * f) / 256.
+ */
+static void blend_rows(uint32_t *out, const uint32_t *row0, const uint32_t *row1, int f, int width) {
+	int x = 0;
+	if (f == 0) {
+		memcpy(out, row0, width * sizeof(uint32_t));
+		return;
+	}
+#if defined(__AVX2__)
+	{
+		__m256i zero = _mm256_setzero_si256();
+		__m256i round = _mm256_set1_epi16(128);
+		__m256i w0 = _mm256_set1_epi16((short) (256 - f));
+		__m256i w1 = _mm256_set1_epi16((short) f);
+		for (; SCALE_SIMD && x + 8 <= width; x += 8) {
+			__m256i a = _mm256_loadu_si256((const __m256i *) (row0 + x));
+			__m256i b = _mm256_loadu_si256((const __m256i *) (row1 + x));
+			__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), w0),
+						      _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), w1));
+			__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), w0),
+						      _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), w1));
+			lo = _mm256_srli_epi16(_mm256_add_epi16(lo, round), 8);
+			hi = _mm256_srli_epi16(_mm256_add_epi16(hi, round), 8);
+			_mm256_storeu_si256((__m256i *) (out + x), _mm256_packus_epi16(lo, hi));
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i round = _mm_set1_epi16(128);
+		__m128i w0 = _mm_set1_epi16((short) (256 - f));
+		__m128i w1 = _mm_set1_epi16((short) f);
+		for (; SCALE_SIMD && x + 4 <= width; x += 4) {
+			__m128i a = _mm_loadu_si128((const __m128i *) (row0 + x));
+			__m128i b = _mm_loadu_si128((const __m128i *) (row1 + x));
+			__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0),
+						   _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1));
+			__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0),
+						   _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1));
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+			_mm_storeu_si128((__m128i *) (out + x), _mm_packus_epi16(lo, hi));
+		}
+	}
+#endif
+	for (; x < width; x++) {
+		out[x] = lerp(row0[x], row1[x], (uint32_t) f);
+	}
+}
+
+/**
+ * \brief	Bilinear filter, separable: the source rows are interpolated horizontally once (two rows
+ * 		are kept, as consecutive rows of the result usually read the same source rows), then
+ * 		interpolated vertically.
+ */
+static void bilinear_scale(uint32_t *dst, int dst_stride, ei_size_t dst_size, const uint32_t *src, int src_stride,
+			   ei_size_t src_size) {
+	int *columns = ei_arena_alloc((size_t) dst_size.width * 3 * sizeof(int));
+	int *rows = ei_arena_alloc((size_t) dst_size.height * 3 * sizeof(int));
+	uint32_t *interpolated[2], *swap;
+	int cached[2] = {-1, -1};
+	int y, y0, y1, tmp;
+
+	interpolated[0] = ei_arena_alloc((size_t) dst_size.width * sizeof(uint32_t));
+	interpolated[1] = ei_arena_alloc((size_t) dst_size.width * sizeof(uint32_t));
+	bilinear_positions(columns, columns + dst_size.width, columns + 2 * dst_size.width, dst_size.width,
+			   src_size.width);
+	bilinear_positions(rows, rows + dst_size.height, rows + 2 * dst_size.height, dst_size.height,
+			   src_size.height);
+
+	for (y = 0; y < dst_size.height; y++, dst += dst_stride) {
+		y0 = rows[y];
+		y1 = rows[dst_size.height + y];
+		if (cached[0] != y0) {
+			if (cached[1] == y0) {
+				swap = interpolated[0], interpolated[0] = interpolated[1], interpolated[1] = swap;
+				tmp = cached[0], cached[0] = cached[1], cached[1] = tmp;
+			} else {
+				interpolate_row(interpolated[0], src + (size_t) y0 * src_stride, columns,
+						columns + dst_size.width, columns + 2 * dst_size.width, dst_size.width);
+				cached[0] = y0;
+			}
+		}
+		if (cached[1] != y1) {
+			interpolate_row(interpolated[1], src + (size_t) y1 * src_stride, columns, columns + dst_size.width,
+					columns + 2 * dst_size.width, dst_size.width);
+			cached[1] = y1;
+		}
+		blend_rows(dst, interpolated[0], interpolated[1], rows[2 * dst_size.height + y], dst_size.width);
+	}
+}
+
+void ei_scale_pixels(uint32_t *dst, int dst_stride, ei_size_t dst_size, const uint32_t *src, int src_stride,
+		     ei_size_t src_size, ei_filter_t filter) {
+	ei_arena_mark_t mark = ei_arena_mark();
+	int levels = ei_scale_levels(src_size, dst_size, filter);
+	uint32_t *half = NULL, *previous = NULL;
+	ei_size_t half_size;
+	int half_stride;
+
+	// Réduction préalable par moitiés (hors de l'arène : les niveaux peuvent être grands)
+	while (levels-- > 0) {
+		half_size = ei_scale_half_size(src_size);
+		half = ei_surface_alloc_pixels(half_size, &half_stride);
+		ei_scale_halve(half, half_stride / 4, src, src_stride, src_size);
+		ei_surface_free_pixels(previous);
+		previous = half;
+		src = half;
+		src_stride = half_stride / 4;
+		src_size = half_size;
+	}
+	if (filter == ei_filter_box) {
+		box_scale(dst, dst_stride, dst_size, src, src_stride, src_size);
+	} else {
+		bilinear_scale(dst, dst_stride, dst_size, src, src_stride, src_size);
+	}
+	ei_surface_free_pixels(half);
+	ei_arena_rewind(mark);
+}
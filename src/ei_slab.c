@@ -0,0 +1,65 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "ei_slab.h"
+
+/**
+ * \brief	Size of the header of a chunk, which chains the chunks: keeps the blocks aligned.
+ */
+#define CHUNK_HEADER_SIZE	16
+
+/**
+ * \brief	Rounds the block size so that blocks can hold the free list link and stay aligned.
+ */
+static size_t aligned_block_size(size_t size) {
+	if (size < sizeof(void *)) {
+		size = sizeof(void *);
+	}
+	return (size + 15) & ~((size_t) 15);
+}
+
+void *ei_slab_alloc(ei_slab_t *slab) {
+	size_t size = aligned_block_size(slab->block_size);
+	void *block;
+	if (slab->free_list != NULL) { // Réutilisation d'un bloc libéré
+		block = slab->free_list;
+		slab->free_list = *(void **) block;
+	} else {
+		if (slab->next_block == slab->end_block) { // Nouveau chunk
+			char *chunk = malloc(CHUNK_HEADER_SIZE + size * slab->blocks_per_chunk);
+			*(void **) chunk = slab->chunks;
+			slab->chunks = chunk;
+			slab->next_block = chunk + CHUNK_HEADER_SIZE;
+			slab->end_block = slab->next_block + size * slab->blocks_per_chunk;
+		}
+		block = slab->next_block;
+		slab->next_block += size;
+	}
+	memset(block, 0, size);
+	slab->live++;
+	return block;
+}
+
+void ei_slab_free(ei_slab_t *slab, void *block) {
+	if (block == NULL) {
+		return;
+	}
+	*(void **) block = slab->free_list;
+	slab->free_list = block;
+	slab->live--;
+}
+
+void ei_slab_release(ei_slab_t *slab) {
+	void *chunk = slab->chunks;
+	void *next;
+	while (chunk != NULL) {
+		next = *(void **) chunk;
+		free(chunk);
+		chunk = next;
+	}
+	slab->free_list = NULL;
+	slab->chunks = NULL;
+	slab->next_block = NULL;
+	slab->end_block = NULL;
+	slab->live = 0;
+}
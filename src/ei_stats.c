@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_types.h"
+
+#include "ei_stats.h"
+
+/** Global variables **/
+/**                  **/
+FILE *STATS_FILE = NULL;
+ei_bool_t STATS_JSON = EI_FALSE;
+unsigned long STATS_ITERATION = 0;
+double STATS_START;			///< Date of ei_stats_start
+ei_eventtype_t STATS_EVENT = ei_ev_none;
+long STATS_COUNTERS[ei_stats_counter_last];
+double STATS_TIMERS[ei_stats_timer_last];
+/**                  **/
+/** ---------------- **/
+
+static const char *EVENT_NAMES[ei_ev_last] = {"none", "app", "exposed", "keydown", "keyup",
+					      "mouse_buttondown", "mouse_buttonup", "mouse_move"};
+static const char *COUNTER_NAMES[ei_stats_counter_last] = {"events", "rects", "damage_area", "visited", "drawn",
+							   "culled", "window_pixels", "pick_pixels", "polygons",
+							   "texts"};
+static const char *TIMER_NAMES[ei_stats_timer_last] = {"draw_ms", "pick_ms", "update_ms"};
+
+ei_bool_t ei_stats_start(const char *filename) {
+	size_t length = strlen(filename);
+	int i;
+	ei_stats_stop();
+	if ((STATS_FILE = fopen(filename, "w")) == NULL) {
+		return EI_FALSE;
+	}
+	STATS_JSON = (ei_bool_t) (length >= 5 && strcmp(filename + length - 5, ".json") == 0);
+	STATS_ITERATION = 0;
+	STATS_START = hw_now();
+	STATS_EVENT = ei_ev_none;
+	memset(STATS_COUNTERS, 0, sizeof(STATS_COUNTERS));
+	memset(STATS_TIMERS, 0, sizeof(STATS_TIMERS));
+
+	// En-tête : tableau JSON d'objets, ou noms des colonnes CSV
+	if (STATS_JSON) {
+		fputs("[\n", STATS_FILE);
+	} else {
+		fputs("iteration,time,event", STATS_FILE);
+		for (i = 0; i < ei_stats_counter_last; i++) {
+			fprintf(STATS_FILE, ",%s", COUNTER_NAMES[i]);
+		}
+		for (i = 0; i < ei_stats_timer_last; i++) {
+			fprintf(STATS_FILE, ",%s", TIMER_NAMES[i]);
+		}
+		fputc('\n', STATS_FILE);
+	}
+	return EI_TRUE;
+}
+
+void ei_stats_stop(void) {
+	if (STATS_FILE == NULL) {
+		return;
+	}
+	ei_stats_end_iteration();
+	if (STATS_JSON) {
+		fputs("\n]\n", STATS_FILE);
+	}
+	fclose(STATS_FILE);
+	STATS_FILE = NULL;
+}
+
+ei_bool_t ei_stats_is_active(void) {
+	return (ei_bool_t) (STATS_FILE != NULL);
+}
+
+void ei_stats_set_event(ei_eventtype_t type) {
+	STATS_EVENT = type;
+}
+
+void ei_stats_add(ei_stats_counter_t counter, long count) {
+	if (STATS_FILE != NULL) {
+		STATS_COUNTERS[counter] += count;
+	}
+}
+
+void ei_stats_add_pixels(ei_surface_t surface, long count) {
+	if (STATS_FILE != NULL && surface == ei_app_root_surface()) {
+		STATS_COUNTERS[ei_stats_window_pixels] += count;
+	}
+}
+
+double ei_stats_clock(void) {
+	return (STATS_FILE != NULL) ? hw_now() : 0;
+}
+
+void ei_stats_add_time(ei_stats_timer_t timer, double start) {
+	if (STATS_FILE != NULL) {
+		STATS_TIMERS[timer] += hw_now() - start;
+	}
+}
+
+void ei_stats_end_iteration(void) {
+	int i;
+	if (STATS_FILE == NULL) {
+		return;
+	}
+	if (STATS_JSON) {
+		fprintf(STATS_FILE, "%s{\"iteration\": %lu, \"time\": %.6f, \"event\": \"%s\"",
+			(STATS_ITERATION > 0) ? ",\n" : "", STATS_ITERATION, hw_now() - STATS_START,
+			EVENT_NAMES[STATS_EVENT]);
+		for (i = 0; i < ei_stats_counter_last; i++) {
+			fprintf(STATS_FILE, ", \"%s\": %ld", COUNTER_NAMES[i], STATS_COUNTERS[i]);
+		}
+		for (i = 0; i < ei_stats_timer_last; i++) {
+			fprintf(STATS_FILE, ", \"%s\": %.3f", TIMER_NAMES[i], 1000 * STATS_TIMERS[i]);
+		}
+		fputc('}', STATS_FILE);
+	} else {
+		fprintf(STATS_FILE, "%lu,%.6f,%s", STATS_ITERATION, hw_now() - STATS_START, EVENT_NAMES[STATS_EVENT]);
+		for (i = 0; i < ei_stats_counter_last; i++) {
+			fprintf(STATS_FILE, ",%ld", STATS_COUNTERS[i]);
+		}
+		for (i = 0; i < ei_stats_timer_last; i++) {
+			fprintf(STATS_FILE, ",%.3f", 1000 * STATS_TIMERS[i]);
+		}
+		fputc('\n', STATS_FILE);
+	}
+	STATS_ITERATION++;
+	STATS_EVENT = ei_ev_none;
+	memset(STATS_COUNTERS, 0, sizeof(STATS_COUNTERS));
+	memset(STATS_TIMERS, 0, sizeof(STATS_TIMERS));
+}
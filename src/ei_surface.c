@@ -0,0 +1,267 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __WIN__
+#include <malloc.h>
+#endif
+
+#include "hw_interface.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+
+#include "ei_application_utils.h"
+#include "ei_surface.h"
+
+#define VIEW_SET_MIN_CAPACITY 16
+
+/**
+ * \brief	A view: a rectangle of the pixels of a surface of \ref hw_interface.h.
+ */
+typedef struct ei_view_t {
+	ei_surface_t root;		///< The surface that owns the pixels.
+	struct ei_view_t *parent;	///< The parent, referenced by the view. NULL if the parent is "root".
+	ei_point_t offset;		///< Position of the view in "root".
+	ei_size_t size;
+	int refcount;
+	struct ei_view_t *previous;	///< Chain of the views (for freeing every view).
+	struct ei_view_t *next;
+} ei_view_t;
+
+
+/** Global variables **/
+/**                  **/
+ei_view_t **VIEW_SET = NULL;		///< Open addressing (linear probing), capacity is a power of 2
+uint32_t VIEW_SET_CAPACITY = 0;
+uint32_t VIEW_COUNT = 0;
+ei_view_t *FIRST_VIEW = NULL;
+ei_surface_t LAST_SURFACE = NULL;	///< Last lookup: the drawing functions query the same surface for every pixel
+ei_view_t *LAST_VIEW = NULL;
+/**                  **/
+/** ---------------- **/
+
+static uint32_t view_slot(const void *pointer, uint32_t capacity) {
+	uintptr_t p = (uintptr_t) pointer;
+	return ((uint32_t) ((p >> 4) ^ (p >> 20)) * 2654435761u) & (capacity - 1);
+}
+
+/**
+ * \brief	Returns the view "surface", or NULL if "surface" is not a view.
+ */
+static ei_view_t *find_view(ei_surface_t surface) {
+	uint32_t i;
+	if (VIEW_COUNT == 0) {
+		return NULL;
+	}
+	if (surface == LAST_SURFACE) {
+		return LAST_VIEW;
+	}
+	i = view_slot(surface, VIEW_SET_CAPACITY);
+	while (VIEW_SET[i] != NULL && VIEW_SET[i] != surface) {
+		i = (i + 1) & (VIEW_SET_CAPACITY - 1);
+	}
+	LAST_SURFACE = surface;
+	LAST_VIEW = VIEW_SET[i];
+	return VIEW_SET[i];
+}
+
+static void set_insert(ei_view_t **set, uint32_t capacity, ei_view_t *view) {
+	uint32_t i = view_slot(view, capacity);
+	while (set[i] != NULL) {
+		i = (i + 1) & (capacity - 1);
+	}
+	set[i] = view;
+}
+
+static void set_remove(ei_view_t *view) {
+	uint32_t mask = VIEW_SET_CAPACITY - 1;
+	uint32_t hole = view_slot(view, VIEW_SET_CAPACITY);
+	uint32_t i, home;
+
+	while (VIEW_SET[hole] != view) {
+		hole = (hole + 1) & mask;
+	}
+	// Les suivants de la même séquence reculent : pas de marqueur de suppression
+	for (i = (hole + 1) & mask; VIEW_SET[i] != NULL; i = (i + 1) & mask) {
+		home = view_slot(VIEW_SET[i], VIEW_SET_CAPACITY);
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			VIEW_SET[hole] = VIEW_SET[i];
+			hole = i;
+		}
+	}
+	VIEW_SET[hole] = NULL;
+	VIEW_COUNT--;
+}
+
+ei_surface_t ei_surface_create_view(ei_surface_t parent, const ei_rect_t *rect) {
+	ei_view_t *parent_view = find_view(parent);
+	ei_view_t *view = malloc(sizeof(ei_view_t));
+	ei_rect_t area = ei_rect(ei_point_zero(), ei_surface_get_size(parent));
+	ei_view_t **set;
+	uint32_t capacity, i;
+
+	if (rect != NULL) {
+		area = rect_intersection(area, *rect);
+		area.size = ei_size(max(area.size.width, 0), max(area.size.height, 0));
+	}
+	view->root = (parent_view != NULL) ? parent_view->root : parent;
+	view->parent = parent_view;
+	view->offset = (parent_view != NULL) ? ei_point_add(parent_view->offset, area.top_left) : area.top_left;
+	view->size = area.size;
+	view->refcount = 1;
+	if (parent_view != NULL) {
+		parent_view->refcount++;
+	}
+
+	// Taux de remplissage maximal : 1/2
+	if (2 * (VIEW_COUNT + 1) > VIEW_SET_CAPACITY) {
+		capacity = (VIEW_SET_CAPACITY == 0) ? VIEW_SET_MIN_CAPACITY : 2 * VIEW_SET_CAPACITY;
+		set = calloc(capacity, sizeof(ei_view_t *));
+		for (i = 0; i < VIEW_SET_CAPACITY; i++) {
+			if (VIEW_SET[i] != NULL) {
+				set_insert(set, capacity, VIEW_SET[i]);
+			}
+		}
+		free(VIEW_SET);
+		VIEW_SET = set;
+		VIEW_SET_CAPACITY = capacity;
+	}
+	set_insert(VIEW_SET, VIEW_SET_CAPACITY, view);
+	VIEW_COUNT++;
+	view->previous = NULL;
+	view->next = FIRST_VIEW;
+	if (FIRST_VIEW != NULL) {
+		FIRST_VIEW->previous = view;
+	}
+	FIRST_VIEW = view;
+	LAST_SURFACE = NULL; // L'adresse de la vue a pu être celle d'une surface déjà cherchée
+	return view;
+}
+
+void ei_surface_retain(ei_surface_t surface) {
+	ei_view_t *view = find_view(surface);
+	if (view != NULL) {
+		view->refcount++;
+	}
+}
+
+void ei_surface_release(ei_surface_t surface) {
+	ei_view_t *view = find_view(surface);
+	ei_view_t *parent;
+
+	while (view != NULL && --view->refcount == 0) {
+		parent = view->parent;
+		set_remove(view);
+		if (view->previous != NULL) {
+			view->previous->next = view->next;
+		} else {
+			FIRST_VIEW = view->next;
+		}
+		if (view->next != NULL) {
+			view->next->previous = view->previous;
+		}
+		free(view);
+		LAST_SURFACE = NULL;
+		view = parent;
+	}
+}
+
+ei_bool_t ei_surface_is_view(ei_surface_t surface) {
+	return (ei_bool_t) (find_view(surface) != NULL);
+}
+
+ei_surface_t ei_surface_get_root(ei_surface_t surface) {
+	ei_view_t *view = find_view(surface);
+	return (view != NULL) ? view->root : surface;
+}
+
+uint8_t *ei_surface_get_buffer(ei_surface_t surface) {
+	ei_view_t *view = find_view(surface);
+	if (view == NULL) {
+		return hw_surface_get_buffer(surface);
+	}
+	return hw_surface_get_buffer(view->root) + (size_t) view->offset.y * ei_surface_get_stride(view->root) +
+	       4 * view->offset.x;
+}
+
+int ei_surface_get_stride(ei_surface_t surface) {
+	// La couche matérielle n'expose pas le pas de ses surfaces : elles sont supposées compactes
+	return 4 * hw_surface_get_size(ei_surface_get_root(surface)).width;
+}
+
+ei_size_t ei_surface_get_size(ei_surface_t surface) {
+	ei_view_t *view = find_view(surface);
+	return (view != NULL) ? view->size : hw_surface_get_size(surface);
+}
+
+ei_rect_t ei_surface_get_rect(ei_surface_t surface) {
+	ei_view_t *view = find_view(surface);
+	return (view != NULL) ? ei_rect(ei_point_zero(), view->size) : hw_surface_get_rect(surface);
+}
+
+const ei_rect_t *ei_surface_clipper(ei_surface_t surface, const ei_rect_t *clipper, ei_rect_t *storage) {
+	ei_view_t *view = find_view(surface);
+	if (view == NULL) {
+		return clipper;
+	}
+	*storage = ei_rect(ei_point_zero(), view->size);
+	if (clipper != NULL) {
+		*storage = rect_intersection(*storage, *clipper);
+	}
+	return storage;
+}
+
+void ei_surface_get_channel_indices(ei_surface_t surface, int *ir, int *ig, int *ib, int *ia) {
+	hw_surface_get_channel_indices(ei_surface_get_root(surface), ir, ig, ib, ia);
+}
+
+ei_bool_t ei_surface_has_alpha(ei_surface_t surface) {
+	return hw_surface_has_alpha(ei_surface_get_root(surface));
+}
+
+void ei_surface_lock(ei_surface_t surface) {
+	hw_surface_lock(ei_surface_get_root(surface));
+}
+
+void ei_surface_unlock(ei_surface_t surface) {
+	hw_surface_unlock(ei_surface_get_root(surface));
+}
+
+uint32_t *ei_surface_alloc_pixels(ei_size_t size, int *stride) {
+	size_t bytes;
+	void *pixels = NULL;
+
+	// Lignes arrondies au multiple de l'alignement supérieur
+	*stride = (4 * max(size.width, 1) + EI_SURFACE_ALIGNMENT - 1) & ~(EI_SURFACE_ALIGNMENT - 1);
+	bytes = (size_t) *stride * max(size.height, 1);
+#ifdef __WIN__
+	pixels = _aligned_malloc(bytes, EI_SURFACE_ALIGNMENT);
+#else
+	if (posix_memalign(&pixels, EI_SURFACE_ALIGNMENT, bytes) != 0) {
+		pixels = NULL;
+	}
+#endif
+	return pixels;
+}
+
+void ei_surface_free_pixels(uint32_t *pixels) {
+#ifdef __WIN__
+	_aligned_free(pixels);
+#else
+	free(pixels);
+#endif
+}
+
+void ei_surface_free_views(void) {
+	ei_view_t *view;
+	while (FIRST_VIEW != NULL) {
+		view = FIRST_VIEW;
+		FIRST_VIEW = view->next;
+		free(view);
+	}
+	free(VIEW_SET);
+	VIEW_SET = NULL;
+	VIEW_SET_CAPACITY = 0;
+	VIEW_COUNT = 0;
+	LAST_SURFACE = NULL;
+	LAST_VIEW = NULL;
+}
@@ -8,6 +8,10 @@
 #include "ei_widgetclass.h"
 
 #include "ei_draw_utils.h"
+#include "ei_geometry.h"
+#include "ei_image.h"
+#include "ei_image_async.h"
+#include "ei_manager_utils.h"
 #include "ei_widget_utils.h"
 #include "ei_application_utils.h"
 
@@ -29,48 +33,63 @@ ei_widget_t *ei_widget_create(ei_widgetclass_name_t class_name,
 			      ei_widget_t *parent,
 			      void *user_data,
 			      ei_widget_destructor_t destructor) {
+	return ei_widget_create_from_handle(ei_widgetclass_get_handle(class_name), parent, user_data, destructor);
+}
+
+
+/**
+ * @brief	Same as \ref ei_widget_create, but the class is given by a handle returned by
+ *		\ref ei_widgetclass_get_handle: no lookup of the class name is done.
+ *
+ * @param	wclass		The handle of the class of the widget that is to be created.
+ * @param	parent 		A pointer to the parent widget. Can not be NULL.
+ * @param	user_data	A pointer provided by the programmer for private use. May be NULL.
+ * @param	destructor	A pointer to a function to call before destroying a widget structure. May be NULL.
+ *
+ * @return			The newly created widget, or NULL if "wclass" is NULL.
+ */
+ei_widget_t *ei_widget_create_from_handle(ei_widgetclass_handle_t wclass,
+					  ei_widget_t *parent,
+					  void *user_data,
+					  ei_widget_destructor_t destructor) {
 	ei_widget_t *widget;
-	ei_widgetclass_t *wclass = ei_widgetclass_from_name(class_name);
 
 	if (wclass != NULL) {
 		widget = wclass->allocfunc();
 		widget->wclass = wclass;
 		widget->wclass->setdefaultsfunc(widget);
 	} else {
-		return NULL; // class_name not recognized
+		return NULL; // class not registered
 	}
 
 	// Initialisation des attributs communs à tous les widgets
-	widget->pick_id = ei_get_widget_id();
-	widget->pick_color = malloc(sizeof(ei_color_t));
-	*widget->pick_color = pixel_to_rgba(ei_get_pick_surface(), widget->pick_id);
+	widget->pick_id = ei_register_widget_id(widget);
+	widget->pick_color = ei_pick_id_to_color(widget->pick_id);
 	widget->user_data = user_data;
 	widget->destructor = destructor;
 
 	// Widget Hierachy Management
-	widget->parent = parent;
-	widget->next_sibling = NULL;
 	widget->children_head = NULL;
 	widget->children_tail = NULL;
+	widget->parent = parent;
+	widget->next_sibling = NULL;
+	widget->prev_sibling = NULL;
 
 	// Add widget as last child of parent
 	if (widget->parent != NULL) {
-		if (widget->parent->children_tail != NULL) {
-			assert((widget->parent->children_tail->next_sibling == NULL));
-			widget->parent->children_tail->next_sibling = widget;
-			widget->parent->children_tail = widget;
-		} else {
-			assert((widget->parent->children_head == NULL));
-			widget->parent->children_head = widget;
-			widget->parent->children_tail = widget;
-		}
+		ei_widget_link_last(widget, widget->parent);
 	}
 
 	// Widget geometry
 	widget->placer_params = NULL;
+	widget->manager = NULL;
+	widget->manager_slot = -1;
 	widget->requested_size = ei_size_zero();
 	widget->screen_location = ei_rect_zero();
 	widget->content_rect = &(widget->screen_location);
+	widget->layout_flags = 0;
+	widget->layout_parent = ei_rect_zero();
+	ei_geometry_attach(widget);
 
 	return widget;
 }
@@ -94,39 +113,60 @@ void ei_widget_destroy(ei_widget_t *widget) {
 		ei_app_invalidate_rect(&widget->screen_location); // Includes content_rect
 		ei_placer_forget(widget);
 	}
+	// Quitte la grille ou la pile de son parent, même si elle ne l'a pas encore placé
+	ei_manager_detach(widget);
+	ei_manager_free(widget);
 
 	// Destroys its descendants
-	ei_widget_t *ptr = widget->children_head;
-	ei_widget_t *old = widget->children_head;
-	while (ptr != NULL) {
-		ptr = ptr->next_sibling;
-		ei_widget_destroy_child(old);
-		old = ptr;
+	ei_widget_t *ptr;
+	while (widget->children_head != NULL) {
+		ptr = widget->children_head;
+		widget->children_head = ptr->next_sibling;
+		ei_widget_destroy_child(ptr);
 	}
+	widget->children_tail = NULL;
 
-	// Link correctly between siblings and parent (parcours linéaire)
-	// Link between siblings
-	if (widget->parent != NULL) {
-		ptr = widget->parent->children_head;
-		if (ptr == widget) {
-			widget->parent->children_head = widget->next_sibling;
-			if (widget->parent->children_tail == widget) {
-				widget->parent->children_tail = widget->next_sibling;
-			}
-		} else {
-			while (ptr->next_sibling != widget) {
-				ptr = ptr->next_sibling;
-			}
-			ptr->next_sibling = widget->next_sibling;
-			if (widget->next_sibling == NULL) {
-				widget->parent->children_tail = ptr;
-			}
-		}
-	}
+	// Link correctly between siblings and parent, en temps constant
+	ei_widget_unlink(widget);
 
 	// Frees memory
+	ei_release_widget_id(widget->pick_id);
 	widget->wclass->releasefunc(widget);
-	free(widget);
+	ei_widget_free_memory(widget);
+}
+
+
+/**
+ * @brief	Destroys all the descendants of a widget, but not the widget itself. Calls the
+ *		destructors that were provided. The area of the children that are managed by the
+ *		placer is redrawn at once.
+ *
+ * @param	widget		The widget whose children are to be destroyed.
+ */
+void ei_widget_destroy_children(ei_widget_t *widget) {
+	ei_widget_t *ptr;
+	ei_rect_t damage = ei_rect_zero();
+	ei_bool_t damaged = EI_FALSE;
+
+	// Un seul rectangle invalidé pour tous les enfants affichés
+	for (ptr = widget->children_head; ptr != NULL; ptr = ptr->next_sibling) {
+		if (ptr->placer_params != NULL) {
+			damage = damaged ? rect_union(damage, ptr->screen_location) : ptr->screen_location;
+			damaged = EI_TRUE;
+		}
+	}
+	if (damaged) {
+		ei_app_invalidate_rect(&damage);
+	}
+	ei_manager_free(widget);
+
+	// Toute la liste est libérée : pas besoin de défaire les liens un par un
+	while (widget->children_head != NULL) {
+		ptr = widget->children_head;
+		widget->children_head = ptr->next_sibling;
+		ei_widget_destroy_child(ptr);
+	}
+	widget->children_tail = NULL;
 }
 
 
@@ -139,12 +179,12 @@ void ei_widget_destroy(ei_widget_t *widget) {
  *				at this location (except for the root widget).
  */
 ei_widget_t *ei_widget_pick(ei_point_t *where) {
-	ei_surface_t pick_surface = ei_get_pick_surface();
-	hw_surface_lock(pick_surface);
-	uint32_t *pixel_ptr = (uint32_t *) hw_surface_get_buffer(pick_surface);
-	pixel_ptr += where->x + where->y * hw_surface_get_size(pick_surface).width;
-	hw_surface_unlock(pick_surface);
-	return ei_find_widget_by_id(*pixel_ptr);
+	ei_rect_t rect = ei_get_pick_buffer()->rect;
+	if (where->x < rect.top_left.x || where->y < rect.top_left.y ||
+	    where->x >= rect.top_left.x + rect.size.width || where->y >= rect.top_left.y + rect.size.height) {
+		return NULL;
+	}
+	return ei_find_widget_by_id(ei_pick_id_at(where)); // Accès direct au registre, en O(1)
 }
 
 
@@ -172,10 +212,13 @@ void ei_frame_configure(ei_widget_t *widget,
 	if (relief != NULL) {
 		frame->relief = *relief;
 	}
+	if (text != NULL || img != NULL) {
+		ei_widget_cancel_image_async(widget); // Remplace l'image en attente
+	}
 	if (text != NULL) {
 		frame->text = *text;
+		ei_image_free(frame->img);
 		frame->img = NULL;
-		frame->img_rect = NULL;
 	}
 	if (text_font != NULL) {
 		frame->text_font = *text_font;
@@ -187,12 +230,12 @@ void ei_frame_configure(ei_widget_t *widget,
 		frame->text_anchor = *text_anchor;
 	}
 	if (img != NULL) {
-		frame->img = img;
+		// Convertie tout de suite : la surface peut être libérée après l'appel
+		ei_image_free(frame->img);
+		frame->img = (*img != NULL) ? ei_image_create(*img, (img_rect != NULL) ? *img_rect : NULL,
+							       ei_app_root_surface()) : NULL;
 		frame->text = NULL;
 	}
-	if (img_rect != NULL) {
-		frame->img_rect = *img_rect;
-	}
 	if (img_anchor != NULL) {
 		frame->img_anchor = *img_anchor;
 	}
@@ -201,8 +244,9 @@ void ei_frame_configure(ei_widget_t *widget,
 		frame->requested_bool = EI_TRUE;
 	} else if (!frame->requested_bool) {
 		widget->requested_size = ei_widget_natural_size(frame->border_width, frame->text, frame->text_font,
-								frame->img_rect);
+								frame->img);
 	}
+	ei_manager_notify(widget); // Grille ou empilement du parent : nouvelle mesure
 }
 
 
@@ -236,10 +280,13 @@ void ei_button_configure(ei_widget_t *widget,
 	if (relief != NULL) {
 		button->relief = *relief;
 	}
+	if (text != NULL || img != NULL) {
+		ei_widget_cancel_image_async(widget); // Remplace l'image en attente
+	}
 	if (text != NULL) {
 		button->text = *text;
+		ei_image_free(button->img);
 		button->img = NULL;
-		button->img_rect = NULL;
 	}
 	if (text_font != NULL) {
 		button->text_font = *text_font;
@@ -251,12 +298,12 @@ void ei_button_configure(ei_widget_t *widget,
 		button->text_anchor = *text_anchor;
 	}
 	if (img != NULL) {
-		button->img = img;
+		// Convertie tout de suite : la surface peut être libérée après l'appel
+		ei_image_free(button->img);
+		button->img = (*img != NULL) ? ei_image_create(*img, (img_rect != NULL) ? *img_rect : NULL,
+							       ei_app_root_surface()) : NULL;
 		button->text = NULL;
 	}
-	if (img_rect != NULL) {
-		button->img_rect = *img_rect;
-	}
 	if (img_anchor != NULL) {
 		button->img_anchor = *img_anchor;
 	}
@@ -271,8 +318,9 @@ void ei_button_configure(ei_widget_t *widget,
 		button->requested_bool = EI_TRUE;
 	} else if (!button->requested_bool) {
 		widget->requested_size = ei_widget_natural_size(button->border_width, button->text, button->text_font,
-								button->img_rect);
+								button->img);
 	}
+	ei_manager_notify(widget); // Grille ou empilement du parent : nouvelle mesure
 }
 
 
@@ -289,6 +337,7 @@ void ei_toplevel_configure(ei_widget_t *widget,
 
 	if (requested_size != NULL) {
 		widget->requested_size = *requested_size;
+		ei_manager_notify(widget); // Grille ou empilement du parent : nouvelle mesure
 	}
 	if (color != NULL) {
 		toplevel->color = *color;
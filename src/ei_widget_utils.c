@@ -10,12 +10,25 @@
 
 #include "ei_button.h"
 #include "ei_draw_utils.h"
+#include "ei_image.h"
+#include "ei_image_async.h"
+#include "ei_geometry.h"
+#include "ei_manager_utils.h"
+#include "ei_pick.h"
+#include "ei_slab.h"
 #include "ei_widget_utils.h"
 #include "ei_application_utils.h"
 
 /** Global variables **/
 /**                  **/
-uint32_t general_id = 0xff000000;
+ei_widget_t **WIDGET_REGISTRY = NULL;	///< Widgets indexed by their pick_id (index 0 is never used)
+uint32_t REGISTRY_LENGTH = 1;		///< First pick_id that has never been given
+uint32_t REGISTRY_CAPACITY = 0;
+uint32_t *FREE_IDS = NULL;		///< Stack of the pick_ids released by destroyed widgets
+uint32_t FREE_IDS_LENGTH = 0;
+ei_slab_t FRAME_SLAB = EI_SLAB_INITIALIZER(sizeof(ei_frame_t));		///< Memory of the widgets of each class
+ei_slab_t BUTTON_SLAB = EI_SLAB_INITIALIZER(sizeof(ei_button_t));
+ei_slab_t TOPLEVEL_SLAB = EI_SLAB_INITIALIZER(sizeof(ei_toplevel_t));
 /**                  **/
 /** ---------------- **/
 
@@ -23,68 +36,148 @@ void empty_callback(ei_widget_t *widget, struct ei_event_t *event, void *user_pa
 	return;
 }
 
-void ei_widget_destroy_child(ei_widget_t *widget) {
-	// Call destructor if provided
-	if (widget->destructor != NULL) {
-		widget->destructor(widget);
+void ei_widget_link_last(ei_widget_t *widget, ei_widget_t *parent) {
+	widget->parent = parent;
+	widget->next_sibling = NULL;
+	widget->prev_sibling = parent->children_tail;
+	if (parent->children_tail != NULL) {
+		parent->children_tail->next_sibling = widget;
+	} else {
+		parent->children_head = widget;
 	}
+	parent->children_tail = widget;
+}
 
-	// Destroys its descendants
-	ei_widget_t *ptr = widget->children_head;
-	ei_widget_t *old = widget->children_head;
-	while (ptr != NULL) {
-		ptr = ptr->next_sibling;
-		ei_widget_destroy_child(old);
-		old = ptr;
+void ei_widget_unlink(ei_widget_t *widget) {
+	ei_widget_t *parent = widget->parent;
+	if (parent == NULL) {
+		return;
+	}
+	if (widget->prev_sibling != NULL) {
+		widget->prev_sibling->next_sibling = widget->next_sibling;
+	} else {
+		parent->children_head = widget->next_sibling;
 	}
+	if (widget->next_sibling != NULL) {
+		widget->next_sibling->prev_sibling = widget->prev_sibling;
+	} else {
+		parent->children_tail = widget->prev_sibling;
+	}
+	widget->next_sibling = NULL;
+	widget->prev_sibling = NULL;
+}
+
+void ei_widget_destroy_child(ei_widget_t *widget) {
+	ei_widget_t *ptr = widget;
+	ei_widget_t *parent;
 
-	// No need to link correctly between siblings and parent
+	// Sans récursion, pour les arbres profonds : destructeurs dans l'ordre préfixe (parent avant enfants)
+	while (ptr != NULL) {
+		if (ptr->destructor != NULL) {
+			ptr->destructor(ptr);
+		}
+		ei_manager_free(ptr); // Ses enfants sont libérés sans quitter sa grille
+		if (ptr->children_head != NULL) {
+			ptr = ptr->children_head;
+			continue;
+		}
+		while (ptr != widget && ptr->next_sibling == NULL) {
+			ptr = ptr->parent;
+		}
+		ptr = (ptr == widget) ? NULL : ptr->next_sibling;
+	}
 
-	// Frees memory
-	widget->wclass->releasefunc(widget);
-	free(widget);
+	// Puis libération depuis les feuilles : une feuille est toujours le premier enfant de son parent
+	ptr = widget;
+	while (ptr != NULL) {
+		if (ptr->children_head != NULL) {
+			ptr = ptr->children_head;
+			continue;
+		}
+		parent = (ptr == widget) ? NULL : ptr->parent;
+		if (parent != NULL) {
+			parent->children_head = ptr->next_sibling;
+		}
+		ei_release_widget_id(ptr->pick_id);
+		ptr->wclass->releasefunc(ptr);
+		ei_widget_free_memory(ptr);
+		ptr = parent;
+	}
 }
 
-uint32_t ei_get_widget_id(void) {
-	general_id += 0x2277cc45;
-	return general_id;
+void ei_widget_free_memory(ei_widget_t *widget) {
+	// Les classes de la bibliothèque allouent dans leur pool, les autres avec malloc
+	if (widget->wclass->allocfunc == &frame_allocfunc) {
+		ei_slab_free(&FRAME_SLAB, widget);
+	} else if (widget->wclass->allocfunc == &button_allocfunc) {
+		ei_slab_free(&BUTTON_SLAB, widget);
+	} else if (widget->wclass->allocfunc == &toplevel_allocfunc) {
+		ei_slab_free(&TOPLEVEL_SLAB, widget);
+	} else {
+		free(widget);
+	}
 }
 
-ei_widget_t *ei_find_widget_by_id(uint32_t id) {
-	return search_widget(ei_app_root_widget(), id);
+void free_widget_slabs(void) {
+	ei_slab_release(&FRAME_SLAB);
+	ei_slab_release(&BUTTON_SLAB);
+	ei_slab_release(&TOPLEVEL_SLAB);
 }
 
-ei_widget_t *search_widget(ei_widget_t *widget, uint32_t id) {
-	if (widget->pick_id == id) {
-		return widget;
+uint32_t ei_register_widget_id(ei_widget_t *widget) {
+	uint32_t id;
+	if (FREE_IDS_LENGTH > 0) { // Réutilisation d'un id libéré
+		id = FREE_IDS[--FREE_IDS_LENGTH];
 	} else {
-		if (widget->next_sibling == NULL && widget->children_head == NULL) {
-			return NULL;
-		} else if (widget->next_sibling != NULL && widget->children_head == NULL) {
-			return search_widget(widget->next_sibling, id);
-		} else if (widget->next_sibling == NULL && widget->children_head != NULL) {
-			return search_widget(widget->children_head, id);
-		} else {
-			ei_widget_t *wsibling = search_widget(widget->next_sibling, id);
-			if (wsibling != NULL) {
-				return wsibling;
-			}
-			ei_widget_t *wchild = search_widget(widget->children_head, id);
-			if (wchild != NULL) {
-				return wchild;
-			}
-			return NULL;
+		if (REGISTRY_LENGTH >= REGISTRY_CAPACITY) {
+			REGISTRY_CAPACITY = (REGISTRY_CAPACITY == 0) ? 64 : 2 * REGISTRY_CAPACITY;
+			WIDGET_REGISTRY = realloc(WIDGET_REGISTRY, REGISTRY_CAPACITY * sizeof(ei_widget_t *));
+			FREE_IDS = realloc(FREE_IDS, REGISTRY_CAPACITY * sizeof(uint32_t));
+			ei_geometry_reserve(REGISTRY_CAPACITY);
 		}
+		id = REGISTRY_LENGTH++;
+	}
+	WIDGET_REGISTRY[id] = widget;
+	return id;
+}
 
+void ei_release_widget_id(uint32_t id) {
+	if (id == 0 || id >= REGISTRY_LENGTH || WIDGET_REGISTRY[id] == NULL) {
+		return;
 	}
+	WIDGET_REGISTRY[id] = NULL;
+	FREE_IDS[FREE_IDS_LENGTH++] = id;
+	ei_geometry_release(id);
 }
 
-ei_size_t ei_widget_natural_size(int border_width, char *text, ei_font_t text_font, ei_rect_t *img_rect) {
+ei_widget_t *ei_find_widget_by_id(uint32_t id) {
+	if (id >= REGISTRY_LENGTH) {
+		return NULL;
+	}
+	return WIDGET_REGISTRY[id];
+}
+
+uint32_t ei_widget_id_bound(void) {
+	return REGISTRY_LENGTH;
+}
+
+void free_widget_registry(void) {
+	free(WIDGET_REGISTRY);
+	free(FREE_IDS);
+	WIDGET_REGISTRY = NULL;
+	FREE_IDS = NULL;
+	REGISTRY_LENGTH = 1;
+	REGISTRY_CAPACITY = 0;
+	FREE_IDS_LENGTH = 0;
+	ei_geometry_free();
+}
+
+ei_size_t ei_widget_natural_size(int border_width, char *text, ei_font_t text_font, const ei_image_t *img) {
 	ei_size_t requested_size;
 	if (text != NULL) {
 		hw_text_compute_size(text, text_font, &requested_size.width, &requested_size.height);
-	} else if (img_rect != NULL) {
-		requested_size = img_rect->size;
+	} else if (img != NULL) {
+		requested_size = img->size;
 	} else {
 		requested_size = ei_size_zero();
 	}
@@ -104,7 +197,6 @@ ei_frame_t ei_init_default_frame(void) {
 	frame.text_color = ei_font_default_color;
 	frame.text_anchor = ei_anc_center;
 	frame.img = NULL;
-	frame.img_rect = NULL;
 	frame.img_anchor = ei_anc_center;
 	frame.requested_bool = EI_FALSE;
 	return frame;
@@ -124,8 +216,7 @@ ei_widgetclass_t ei_init_frame_class(void) {
 }
 
 ei_widget_t *frame_allocfunc(void) {
-	ei_widget_t *widget = malloc(sizeof(ei_frame_t));
-	return widget;
+	return ei_slab_alloc(&FRAME_SLAB);
 }
 
 void frame_releasefunc(ei_widget_t *widget) {
@@ -133,18 +224,21 @@ void frame_releasefunc(ei_widget_t *widget) {
 
 	// Free widget fields allocated by library
 	ei_placer_forget(widget);
-	free(widget->pick_color);
+	ei_image_free(frame->img);
+	ei_widget_cancel_image_async(widget);
 }
 
 void
 frame_drawfunc(ei_widget_t *widget, ei_surface_t surface, ei_surface_t pick_surface, ei_rect_t *clipper) {
 	ei_frame_t *frame = (ei_frame_t *) widget;
-	draw_frame(surface, frame->text, frame->text_font, frame->text_color, clipper, widget->screen_location,
-		   frame->color,
-		   frame->relief, EI_FALSE);
-	draw_frame(pick_surface, NULL, frame->text_font, frame->text_color, clipper, widget->screen_location,
-		   *widget->pick_color,
-		   ei_relief_none, EI_TRUE);
+	if (surface != NULL) {
+		draw_frame(surface, frame->text, frame->text_font, frame->text_color, clipper, widget->screen_location,
+			   frame->color,
+			   frame->relief, frame->img, frame->img_anchor);
+	}
+	if (pick_surface != NULL) {
+		ei_pick_fill_rect((ei_pick_buffer_t *) pick_surface, &widget->screen_location, widget->pick_id, clipper);
+	}
 
 }
 
@@ -154,8 +248,7 @@ void frame_setdefaultsfunc(ei_widget_t *widget) {
 	*frame = ei_init_default_frame();
 	widget->wclass = wclass;
 	widget->requested_size = ei_widget_natural_size(frame->border_width, frame->text, frame->text_font,
-							frame->img_rect);
-	widget->content_rect = malloc(sizeof(ei_rect_t));
+							frame->img);
 }
 
 void frame_geomnotifyfunc(ei_widget_t *widget, ei_rect_t rect) {
@@ -194,7 +287,6 @@ ei_button_t ei_init_default_button(void) {
 	button.text_color = ei_font_default_color;
 	button.text_anchor = ei_anc_center;
 	button.img = NULL;
-	button.img_rect = NULL;
 	button.img_anchor = ei_anc_center;
 	button.callback = empty_callback;
 	button.user_param = NULL;
@@ -216,8 +308,7 @@ ei_widgetclass_t ei_init_button_class(void) {
 }
 
 ei_widget_t *button_allocfunc(void) {
-	ei_widget_t *widget = malloc(sizeof(ei_button_t));
-	return widget;
+	return ei_slab_alloc(&BUTTON_SLAB);
 }
 
 void button_releasefunc(ei_widget_t *widget) {
@@ -225,16 +316,22 @@ void button_releasefunc(ei_widget_t *widget) {
 
 	// Free widget fields allocated by library
 	ei_placer_forget(widget);
-	free(widget->pick_color);
+	ei_image_free(button->img);
+	ei_widget_cancel_image_async(widget);
 }
 
 void
 button_drawfunc(ei_widget_t *widget, ei_surface_t surface, ei_surface_t pick_surface, ei_rect_t *clipper) {
 	struct ei_button_t *button = (ei_button_t *) widget;
-	draw_button(surface, button->text, button->text_font, button->text_color, clipper, widget->screen_location,
-		    button->color, button->corner_radius, button->relief, EI_FALSE);
-	draw_button(pick_surface, NULL, button->text_font, button->text_color, clipper, widget->screen_location,
-		    *widget->pick_color, button->corner_radius, ei_relief_none, EI_TRUE);
+	if (surface != NULL) {
+		draw_button(surface, button->text, button->text_font, button->text_color, clipper,
+			    widget->screen_location, button->color, button->corner_radius, button->relief, button->img,
+			    button->img_anchor);
+	}
+	if (pick_surface != NULL) {
+		ei_linked_point_t *pts = rounded_frame(widget->screen_location, button->corner_radius, EI_TRUE, EI_TRUE);
+		ei_pick_fill_polygon((ei_pick_buffer_t *) pick_surface, pts, widget->pick_id, clipper);
+	}
 }
 
 void button_setdefaultsfunc(ei_widget_t *widget) {
@@ -243,8 +340,7 @@ void button_setdefaultsfunc(ei_widget_t *widget) {
 	*button = ei_init_default_button();
 	widget->wclass = wclass;
 	widget->requested_size = ei_widget_natural_size(button->border_width, button->text, button->text_font,
-							button->img_rect);
-	widget->content_rect = malloc(sizeof(ei_rect_t));
+							button->img);
 }
 
 void button_geomnotifyfunc(ei_widget_t *widget, ei_rect_t rect) {
@@ -319,8 +415,7 @@ ei_widgetclass_t ei_init_toplevel_class(void) {
 }
 
 ei_widget_t *toplevel_allocfunc(void) {
-	ei_widget_t *widget = malloc(sizeof(ei_toplevel_t));
-	return widget;
+	return ei_slab_alloc(&TOPLEVEL_SLAB);
 }
 
 void toplevel_releasefunc(ei_widget_t *widget) {
@@ -328,17 +423,19 @@ void toplevel_releasefunc(ei_widget_t *widget) {
 
 	// Free widget fields allocated by library
 	ei_placer_forget(widget);
-	free(widget->pick_color);
 }
 
 void
 toplevel_drawfunc(ei_widget_t *widget, ei_surface_t surface, ei_surface_t pick_surface, ei_rect_t *clipper) {
 	struct ei_toplevel_t *toplevel = (ei_toplevel_t *) widget;
 	ei_color_t blanc = {255, 255, 255, 255};
-	draw_toplevel(surface, toplevel->title, ei_default_font, blanc, clipper, widget->screen_location,
-		      toplevel->color, EI_FALSE, toplevel->border_width);
-	draw_toplevel(pick_surface, NULL, ei_default_font, blanc, clipper, widget->screen_location,
-		      *widget->pick_color, EI_TRUE, toplevel->border_width);
+	if (surface != NULL) {
+		draw_toplevel(surface, toplevel->title, ei_default_font, blanc, clipper, widget->screen_location,
+			      toplevel->color, toplevel->border_width);
+	}
+	if (pick_surface != NULL) {
+		ei_pick_fill_rect((ei_pick_buffer_t *) pick_surface, &widget->screen_location, widget->pick_id, clipper);
+	}
 }
 
 void toplevel_setdefaultsfunc(ei_widget_t *widget) {
@@ -347,7 +444,6 @@ void toplevel_setdefaultsfunc(ei_widget_t *widget) {
 	*toplevel = ei_init_default_toplevel();
 	widget->wclass = wclass;
 	widget->requested_size = ei_size(320, 240);
-	widget->content_rect = malloc(sizeof(ei_rect_t));
 }
 
 void toplevel_geomnotifyfunc(ei_widget_t *widget, ei_rect_t rect) {
@@ -398,11 +494,12 @@ ei_bool_t toplevel_handlefunc(ei_widget_t *widget, ei_event_t *event) {
 		if (event->type == ei_ev_mouse_move && toplevel->move_mode.move_mode_bool) {
 			int dx = x_mouse - toplevel->move_mode.last_location.x;
 			int dy = y_mouse - toplevel->move_mode.last_location.y;
-			int new_x = widget->screen_location.top_left.x + dx;
-			int new_y = widget->screen_location.top_left.y + dy;
-			ei_app_invalidate_rect(&widget->screen_location);
-			ei_place(widget, NULL, &new_x, &new_y, NULL, NULL, NULL, NULL, NULL, NULL);
-			ei_app_invalidate_rect(&widget->screen_location);
+			// Décalage absolu dans le parent, la position relative est conservée
+			int new_x = widget->placer_params->x_data + dx;
+			int new_y = widget->placer_params->y_data + dy;
+			// Zones à redessiner (ancienne et nouvelle position) données par le placeur
+			ei_place(widget, NULL, &new_x, &new_y, NULL, NULL, widget->placer_params->rx,
+				 widget->placer_params->ry, NULL, NULL);
 			toplevel->move_mode.last_location = ei_point(x_mouse, y_mouse);
 			return EI_TRUE;
 		} else if (event->type == ei_ev_mouse_buttonup && toplevel->move_mode.move_mode_bool) {
@@ -435,23 +532,26 @@ ei_bool_t toplevel_handlefunc(ei_widget_t *widget, ei_event_t *event) {
                                 dy = y_mouse - toplevel->resize_mode.last_location.y;
                         }
 
-			int new_width = widget->screen_location.size.width + dx;
-			int new_height = widget->screen_location.size.height + dy;
+			// Taille demandée au placeur, qui peut être plus récente que screen_location
+			int width = (widget->placer_params->w != NULL) ? widget->placer_params->w_data
+								       : widget->screen_location.size.width;
+			int height = (widget->placer_params->h != NULL) ? widget->placer_params->h_data
+									: widget->screen_location.size.height;
+			int new_width = width + dx;
+			int new_height = height + dy;
 			toplevel->resize_mode.last_location = ei_point(x_mouse, y_mouse);
 			//Respect de la taille minimale
 			if (new_width < toplevel->min_size.width && new_height < toplevel->min_size.height) {
 				return EI_FALSE;
 			} else {
 				if (new_width < toplevel->min_size.width) {
-					new_width = widget->screen_location.size.width;
+					new_width = width;
 				}
 				if (new_height < toplevel->min_size.height) {
-					new_height = widget->screen_location.size.height;
+					new_height = height;
 				}
 			}
-			ei_app_invalidate_rect(&widget->screen_location);
 			ei_place(widget, NULL, NULL, NULL, &new_width, &new_height, NULL, NULL, NULL, NULL);
-			ei_app_invalidate_rect(&widget->screen_location);
 			return EI_TRUE;
 		} else if (event->type == ei_ev_mouse_buttonup && toplevel->resize_mode.resize_mode_bool) {
 		        //On sort du mode redimensionnement
@@ -470,52 +570,40 @@ void draw_toplevel(ei_surface_t surface,
 		   const ei_rect_t *clipper,
 		   ei_rect_t rect,
 		   ei_color_t toplevel_color,
-		   ei_bool_t pick,
 		   int border_width) {
-	is_pick_surface = pick;
-	if (pick) {
-		ei_linked_point_t *pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, toplevel_color, clipper);
-		free_points(pts);
-	} else {
-		ei_size_t size;
-		hw_text_compute_size(text, font, &(size.width), &(size.height));
-		ei_rect_t bot_right_corner; //carré de redimensionnement
-		bot_right_corner.size.width = 0.1 * rect.size.height;
-		bot_right_corner.size.height = 0.1 * rect.size.height;
-		bot_right_corner.top_left.x = rect.top_left.x + rect.size.width - bot_right_corner.size.width;
-		bot_right_corner.top_left.y = rect.top_left.y + rect.size.height - bot_right_corner.size.height;
-
-		//dessin de la partie extérieure
-		ei_linked_point_t *pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
-		ei_color_t frame_color = {toplevel_color.red * 0.5, toplevel_color.green * 0.5,
-					  toplevel_color.blue * 0.5, toplevel_color.alpha};
-		ei_draw_polygon(surface, pts, frame_color, clipper);
-		free_points(pts);
-
-		//position du texte en fonction du rectangle de départ
-		ei_point_t where;
-		where.x = rect.top_left.x + rect.size.width * 0.05;
-		where.y = rect.top_left.y + border_width;
-
-		//rectangle intérieur
-		rect.top_left.x += border_width;
-		rect.top_left.y += 2 * border_width + size.height;
-		rect.size.width -= 2 * border_width;
-		rect.size.height = rect.size.height - size.height - 3 * border_width;
-
-		//dessin de la partie intérieure
-		pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, toplevel_color, clipper);
-		free_points(pts);
-
-		//dessin du carré de redimensionnement
-		pts = rounded_frame(bot_right_corner, 0, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, frame_color, clipper);
-		free_points(pts);
-		ei_draw_text(surface, &where, text, font, text_color, clipper);
-	}
-
+	ei_size_t size;
+	hw_text_compute_size(text, font, &(size.width), &(size.height));
+	ei_rect_t bot_right_corner; //carré de redimensionnement
+	bot_right_corner.size.width = 0.1 * rect.size.height;
+	bot_right_corner.size.height = 0.1 * rect.size.height;
+	bot_right_corner.top_left.x = rect.top_left.x + rect.size.width - bot_right_corner.size.width;
+	bot_right_corner.top_left.y = rect.top_left.y + rect.size.height - bot_right_corner.size.height;
+
+	//dessin de la partie extérieure
+	ei_linked_point_t *pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
+	ei_color_t frame_color = {toplevel_color.red * 0.5, toplevel_color.green * 0.5,
+				  toplevel_color.blue * 0.5, toplevel_color.alpha};
+	ei_draw_polygon(surface, pts, frame_color, clipper);
+
+	//position du texte en fonction du rectangle de départ
+	ei_point_t where;
+	where.x = rect.top_left.x + rect.size.width * 0.05;
+	where.y = rect.top_left.y + border_width;
+
+	//rectangle intérieur
+	rect.top_left.x += border_width;
+	rect.top_left.y += 2 * border_width + size.height;
+	rect.size.width -= 2 * border_width;
+	rect.size.height = rect.size.height - size.height - 3 * border_width;
+
+	//dessin de la partie intérieure
+	pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(surface, pts, toplevel_color, clipper);
+
+	//dessin du carré de redimensionnement
+	pts = rounded_frame(bot_right_corner, 0, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(surface, pts, frame_color, clipper);
+	ei_draw_text(surface, &where, text, font, text_color, clipper);
 }
 
 void draw_frame(ei_surface_t surface,
@@ -526,78 +614,67 @@ void draw_frame(ei_surface_t surface,
 		ei_rect_t rect,
 		ei_color_t frame_color,
 		ei_relief_t relief,
-		ei_bool_t pick) {
+		const ei_image_t *img,
+		ei_anchor_t img_anchor) {
 	ei_color_t top_color;
 	ei_color_t bot_color;
-	is_pick_surface = pick;
-	if (pick) {
-		ei_linked_point_t *pts;
-		pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, frame_color, clipper);
-		free_points(pts);
-		ei_point_t where;
-		where.x = rect.top_left.x + rect.size.width * 1.5 / 10;
-		where.y = rect.top_left.y + rect.size.height * 3 / 10;
-		ei_draw_text(surface, &where, text, font, text_color, clipper);
-		return;
+	if (relief == ei_relief_sunken) {
+		top_color.red = frame_color.red * 0.9;
+		top_color.green = frame_color.green * 0.9;
+		top_color.blue = frame_color.blue * 0.9, top_color.alpha = frame_color.alpha;
+                if (frame_color.red * 1.1 <= 255) {
+                        bot_color.red = frame_color.red * 1.1;
+                } else {
+                        bot_color.red = 255;
+                }
+                if (frame_color.green * 1.1 <= 255) {
+                        bot_color.green = frame_color.green * 1.1;
+                } else {
+                        bot_color.green = 255;
+                }
+                if (frame_color.blue * 1.1 <= 255) {
+                        bot_color.blue = frame_color.blue * 1.1;
+                } else {
+                        bot_color.blue = 255;
+                }
+		bot_color.alpha = frame_color.alpha;
 	} else {
-		if (relief == ei_relief_sunken) {
-			top_color.red = frame_color.red * 0.9;
-			top_color.green = frame_color.green * 0.9;
-			top_color.blue = frame_color.blue * 0.9, top_color.alpha = frame_color.alpha;
-                        if (frame_color.red * 1.1 <= 255) {
-                                bot_color.red = frame_color.red * 1.1;
-                        } else {
-                                bot_color.red = 255;
-                        }
-                        if (frame_color.green * 1.1 <= 255) {
-                                bot_color.green = frame_color.green * 1.1;
-                        } else {
-                                bot_color.red = 255;
-                        }
-                        if (frame_color.blue * 1.1 <= 255) {
-                                bot_color.blue = frame_color.blue * 1.1;
-                        } else {
-                                bot_color.red = 255;
-                        }
-			bot_color.alpha = frame_color.alpha;
-		} else {
-                        if (frame_color.red * 1.1 <= 255) {
-                                top_color.red = frame_color.red * 1.1;
-                        } else {
-                                top_color.red = 255;
-                        }
-                        if (frame_color.green * 1.1 <= 255) {
-                                top_color.green = frame_color.green * 1.1;
-                        } else {
-                                top_color.red = 255;
-                        }
-                        if (frame_color.blue * 1.1 <= 255) {
-                                top_color.blue = frame_color.blue * 1.1;
-                        } else {
-                                top_color.red = 255;
-                        }
-			top_color.alpha = frame_color.alpha;
-			bot_color.red = frame_color.red * 0.9;
-			bot_color.green = frame_color.green * 0.9;
-			bot_color.blue = frame_color.blue * 0.9, bot_color.alpha = frame_color.alpha;
-		}
-		ei_linked_point_t *pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, top_color, clipper);
-		free_points(pts);
-		pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, bot_color, clipper);
-		free_points(pts);
-		rect.top_left.x += rect.size.width / 20;
-		rect.top_left.y += rect.size.height / 20;
-		rect.size.width -= rect.size.width * 2 / 20;
-		rect.size.height -= rect.size.width * 2 / 20;
-		pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
-		ei_draw_polygon(surface, pts, frame_color, clipper);
-		free_points(pts);
-		ei_point_t where;
-		where.x = rect.top_left.x + rect.size.width * 1.5 / 10;
-		where.y = rect.top_left.y + rect.size.height * 3 / 10;
-		ei_draw_text(surface, &where, text, font, text_color, clipper);
+                if (frame_color.red * 1.1 <= 255) {
+                        top_color.red = frame_color.red * 1.1;
+                } else {
+                        top_color.red = 255;
+                }
+                if (frame_color.green * 1.1 <= 255) {
+                        top_color.green = frame_color.green * 1.1;
+                } else {
+                        top_color.green = 255;
+                }
+                if (frame_color.blue * 1.1 <= 255) {
+                        top_color.blue = frame_color.blue * 1.1;
+                } else {
+                        top_color.blue = 255;
+                }
+		top_color.alpha = frame_color.alpha;
+		bot_color.red = frame_color.red * 0.9;
+		bot_color.green = frame_color.green * 0.9;
+		bot_color.blue = frame_color.blue * 0.9, bot_color.alpha = frame_color.alpha;
+	}
+	ei_linked_point_t *pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(surface, pts, top_color, clipper);
+	pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(surface, pts, bot_color, clipper);
+	rect.top_left.x += rect.size.width / 20;
+	rect.top_left.y += rect.size.height / 20;
+	rect.size.width -= rect.size.width * 2 / 20;
+	rect.size.height -= rect.size.width * 2 / 20;
+	pts = rounded_frame(rect, 0, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(surface, pts, frame_color, clipper);
+	if (img != NULL) {
+		ei_image_draw(surface, img, rect, img_anchor, clipper);
+		return;
 	}
+	ei_point_t where;
+	where.x = rect.top_left.x + rect.size.width * 1.5 / 10;
+	where.y = rect.top_left.y + rect.size.height * 3 / 10;
+	ei_draw_text(surface, &where, text, font, text_color, clipper);
 }
\ No newline at end of file
@@ -3,15 +3,8 @@
 #include "ei_widgetclass.h"
 
 #include "ei_widgetclass_utils.h"
-#include "directory.h"
 
 
-/** Global variables **/
-/**                  **/
-ei_widgetclass_t *previous_class = NULL;
-/**                  **/
-/** ---------------- **/
-
 /**
  * @brief	Registers a class to the program so that widgets of this class can be created.
  *		This must be done only once per widged class in the application.
@@ -19,15 +12,7 @@ ei_widgetclass_t *previous_class = NULL;
  * @param	widgetclass	The structure describing the class.
  */
 void ei_widgetclass_register(ei_widgetclass_t *widgetclass) {
-	if (previous_class != NULL) {
-		previous_class->next = widgetclass;
-		previous_class = widgetclass;
-	} else {
-		set_first_widgetclass(widgetclass);
-		previous_class = widgetclass;
-	}
-	struct dir* widget_dir = get_widget_dir();
-	dir_insert(widget_dir, ei_widgetclass_stringname(widgetclass->name), widgetclass);
+	ei_class_registry_insert(widgetclass);
 }
 
 /**
@@ -38,5 +23,16 @@ void ei_widgetclass_register(ei_widgetclass_t *widgetclass) {
  * @return			The structure describing the class.
  */
 ei_widgetclass_t *ei_widgetclass_from_name(ei_widgetclass_name_t name) {
-	return dir_lookup_num(get_widget_dir(), ei_widgetclass_stringname(name));
-}
\ No newline at end of file
+	return ei_class_registry_lookup(ei_widgetclass_stringname(name));
+}
+
+/**
+ * @brief	Returns a handle on a registered class, from its name.
+ *
+ * @param	name		The name of the class of widget.
+ *
+ * @return			The handle, or NULL if no class of this name was registered.
+ */
+ei_widgetclass_handle_t ei_widgetclass_get_handle(ei_widgetclass_name_t name) {
+	return ei_class_registry_lookup(ei_widgetclass_stringname(name));
+}
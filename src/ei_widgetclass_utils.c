@@ -1,33 +1,107 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "ei_widgetclass_utils.h"
-#include "directory.h"
+#include "hash.h"
+
+#define CLASS_TABLE_MIN_CAPACITY 16
+
+/**
+ * \brief	An entry of the registry: the class and the hash of its name. Empty if "wclass" is NULL.
+ */
+typedef struct {
+	uint32_t hash;
+	ei_widgetclass_t *wclass;
+} class_slot_t;
 
 
 /** Global variables **/
 /**                  **/
-ei_widgetclass_t *first_class = NULL;
-struct dir* widget_dir = NULL;
+class_slot_t *CLASS_TABLE = NULL;	///< Open addressing (linear probing), capacity is a power of 2
+uint32_t CLASS_TABLE_CAPACITY = 0;
+uint32_t CLASS_COUNT = 0;
+ei_widgetclass_t *FIRST_CLASS = NULL;	///< Chain of the registered classes (used for freeing every widget class)
+ei_widgetclass_t *LAST_CLASS = NULL;
 /**                  **/
 /** ---------------- **/
 
-struct dir* get_widget_dir(void) {
-	if (widget_dir == NULL) {
-		widget_dir = dir_create(10);
+/**
+ * \brief	Returns the slot of the class named "name" of hash "h", or the empty slot where it would be inserted.
+ */
+static class_slot_t *find_slot(class_slot_t *table, uint32_t capacity, const char *name, uint32_t h) {
+	uint32_t i = h & (capacity - 1);
+	while (table[i].wclass != NULL) {
+		// Le nom interné (celui de la classe) évite la comparaison de chaînes
+		if (table[i].hash == h && (table[i].wclass->name == name ||
+					   strncmp(table[i].wclass->name, name, sizeof(ei_widgetclass_name_t)) == 0)) {
+			return &table[i];
+		}
+		i = (i + 1) & (capacity - 1);
+	}
+	return &table[i];
+}
+
+/**
+ * \brief	Moves every entry to a table twice as large, without computing the hashes again.
+ */
+static void grow_table(void) {
+	uint32_t capacity = (CLASS_TABLE_CAPACITY == 0) ? CLASS_TABLE_MIN_CAPACITY : 2 * CLASS_TABLE_CAPACITY;
+	class_slot_t *table = calloc(capacity, sizeof(class_slot_t));
+	uint32_t i;
+	for (i = 0; i < CLASS_TABLE_CAPACITY; i++) {
+		if (CLASS_TABLE[i].wclass != NULL) {
+			*find_slot(table, capacity, CLASS_TABLE[i].wclass->name, CLASS_TABLE[i].hash) = CLASS_TABLE[i];
+		}
 	}
-	return widget_dir;
+	free(CLASS_TABLE);
+	CLASS_TABLE = table;
+	CLASS_TABLE_CAPACITY = capacity;
 }
 
-void  free_widget_dir(void) {
+void ei_class_registry_insert(ei_widgetclass_t *wclass) {
+	uint32_t h = hash(wclass->name);
+	class_slot_t *slot;
+
+	// Taux de remplissage maximal : 1/2
+	if (2 * (CLASS_COUNT + 1) > CLASS_TABLE_CAPACITY) {
+		grow_table();
+	}
+	slot = find_slot(CLASS_TABLE, CLASS_TABLE_CAPACITY, wclass->name, h);
+	if (slot->wclass == wclass) {
+		return; // Déjà enregistrée
+	}
+	if (slot->wclass == NULL) {
+		CLASS_COUNT++;
+	}
+	slot->hash = h;
+	slot->wclass = wclass;
+
+	wclass->next = NULL;
+	if (LAST_CLASS != NULL) {
+		LAST_CLASS->next = wclass;
+	} else {
+		FIRST_CLASS = wclass;
+	}
+	LAST_CLASS = wclass;
+}
+
+ei_widgetclass_t *ei_class_registry_lookup(const char *name) {
+	if (CLASS_COUNT == 0) {
+		return NULL;
+	}
+	return find_slot(CLASS_TABLE, CLASS_TABLE_CAPACITY, name, hash(name))->wclass;
+}
+
+void free_widgetclass_registry(void) {
 	ei_widgetclass_t *to_free;
-	dir_free(widget_dir);
-	while (first_class != NULL) {
-		to_free = first_class;
-		first_class = first_class->next;
+	free(CLASS_TABLE);
+	CLASS_TABLE = NULL;
+	CLASS_TABLE_CAPACITY = 0;
+	CLASS_COUNT = 0;
+	while (FIRST_CLASS != NULL) {
+		to_free = FIRST_CLASS;
+		FIRST_CLASS = FIRST_CLASS->next;
 		free(to_free);
 	}
+	LAST_CLASS = NULL;
 }
-
-void set_first_widgetclass(ei_widgetclass_t *widgetclass) {
-	first_class = widgetclass;
-}
\ No newline at end of file
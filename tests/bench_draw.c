@@ -0,0 +1,331 @@
+//
+//  bench_draw.c
+//  Micro-benchmarks of the drawing primitives, on the headless backend.
+//
+//  Usage:	ei_bench_draw [--quick] [--json report.json] [--compare baseline.json] [--threshold 0.1]
+//
+//  With --compare, the program exits with status 1 if a case is slower than the baseline by more
+//  than the threshold, or allocates more.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "hw_interface.h"
+#include "ei_draw.h"
+#include "ei_button.h"
+#include "ei_arena.h"
+
+#include "bench_utils.h"
+
+#define MAX_RESULTS	64
+#define STAR_BRANCHES	12
+
+/**
+ * @brief	The parameters of a benchmark case.
+ */
+typedef struct {
+	ei_surface_t			surface;
+	ei_surface_t			source;
+	ei_rect_t			rect;
+	ei_rect_t			clipper;
+	ei_bool_t			clipped;
+	ei_bool_t			alpha;
+	ei_linked_point_t*		points;
+	const char*			text;
+} draw_ctx_t;
+
+static const ei_color_t		g_color			= {0x40, 0x80, 0xc0, 0xff};
+static const ei_color_t		g_transparent_color	= {0x40, 0x80, 0xc0, 0x80};
+
+
+
+/* Liste chaînée de "count" points, dans un tableau alloué d'un seul bloc. */
+static ei_linked_point_t* make_points(const ei_point_t* coords, int count)
+{
+	ei_linked_point_t*		points		= malloc(count * sizeof(ei_linked_point_t));
+	int				i;
+
+	for (i = 0; i < count; i++) {
+		points[i].point		= coords[i];
+		points[i].next		= (i + 1 < count) ? &points[i + 1] : NULL;
+	}
+	return points;
+}
+
+static ei_linked_point_t* make_rect_points(ei_rect_t rect)
+{
+	ei_point_t			coords[4];
+
+	coords[0]			= rect.top_left;
+	coords[1].x			= rect.top_left.x + rect.size.width;
+	coords[1].y			= rect.top_left.y;
+	coords[2].x			= rect.top_left.x + rect.size.width;
+	coords[2].y			= rect.top_left.y + rect.size.height;
+	coords[3].x			= rect.top_left.x;
+	coords[3].y			= rect.top_left.y + rect.size.height;
+	return make_points(coords, 4);
+}
+
+/* Étoile concave inscrite dans "rect". */
+static ei_linked_point_t* make_star_points(ei_rect_t rect)
+{
+	ei_point_t			coords[2 * STAR_BRANCHES];
+	double				cx		= rect.top_left.x + rect.size.width / 2.0;
+	double				cy		= rect.top_left.y + rect.size.height / 2.0;
+	double				r;
+	double				angle;
+	int				i;
+
+	for (i = 0; i < 2 * STAR_BRANCHES; i++) {
+		r			= (i % 2 == 0) ? rect.size.width / 2.0 : rect.size.width / 5.0;
+		angle			= i * M_PI / STAR_BRANCHES;
+		coords[i].x		= (int)(cx + r * cos(angle));
+		coords[i].y		= (int)(cy + r * sin(angle));
+	}
+	return make_points(coords, 2 * STAR_BRANCHES);
+}
+
+/* Ligne brisée en zigzag de "count" segments sur toute la largeur de "rect". */
+static ei_linked_point_t* make_zigzag_points(ei_rect_t rect, int count)
+{
+	ei_point_t*			coords		= malloc((count + 1) * sizeof(ei_point_t));
+	ei_linked_point_t*		points;
+	int				i;
+
+	for (i = 0; i <= count; i++) {
+		coords[i].x		= rect.top_left.x + i * (rect.size.width - 1) / count;
+		coords[i].y		= rect.top_left.y + ((i % 2) ? rect.size.height - 1 : 0);
+	}
+	points				= make_points(coords, count + 1);
+	free(coords);
+	return points;
+}
+
+static const ei_rect_t* ctx_clipper(const draw_ctx_t* ctx)
+{
+	return ctx->clipped ? &ctx->clipper : NULL;
+}
+
+
+
+static void bench_fill(void* param)
+{
+	draw_ctx_t*			ctx		= param;
+
+	ei_fill(ctx->surface, &g_color, &ctx->rect);
+}
+
+static void bench_copy(void* param)
+{
+	draw_ctx_t*			ctx		= param;
+
+	ei_copy_surface(ctx->surface, &ctx->rect, ctx->source, &ctx->rect, ctx->alpha);
+}
+
+static void bench_polygon(void* param)
+{
+	draw_ctx_t*			ctx		= param;
+
+	ei_draw_polygon(ctx->surface, ctx->points, g_color, ctx_clipper(ctx));
+}
+
+static void bench_polyline(void* param)
+{
+	draw_ctx_t*			ctx		= param;
+
+	ei_draw_polyline(ctx->surface, ctx->points, g_color, ctx_clipper(ctx));
+}
+
+static void bench_text(void* param)
+{
+	draw_ctx_t*			ctx		= param;
+
+	ei_draw_text(ctx->surface, &ctx->rect.top_left, ctx->text, NULL, g_transparent_color, ctx_clipper(ctx));
+}
+
+static void bench_rounded_frame(void* param)
+{
+	draw_ctx_t*			ctx		= param;
+	ei_arena_mark_t			mark		= ei_arena_mark();
+	ei_linked_point_t*		points;
+
+	points				= rounded_frame(ctx->rect, ctx->rect.size.width / 8.0f, EI_TRUE, EI_TRUE);
+	ei_draw_polygon(ctx->surface, points, g_color, ctx_clipper(ctx));
+	ei_arena_rewind(mark);
+}
+
+
+
+static void usage(const char* program)
+{
+	fprintf(stderr, "usage: %s [--quick] [--json report.json] [--compare baseline.json] [--threshold 0.1]\n",
+		program);
+}
+
+/*
+ * main --
+ *
+ *	Runs every case for every size, prints the results, and optionally writes and compares them.
+ */
+int main(int argc, char** argv)
+{
+	static const int		sizes[]		= {64, 256, 1024};
+	ei_size_t			surface_size	= {1024, 1024};
+	ei_size_t			window_size	= {64, 64};
+	bench_result_t			results[MAX_RESULTS];
+	int				count		= 0;
+	const char*			json_name	= NULL;
+	const char*			baseline_name	= NULL;
+	double				threshold	= 0.10;
+	double				min_time	= 0.2;
+	ei_surface_t			root;
+	ei_surface_t			source;
+	ei_surface_t			alpha_source;
+	draw_ctx_t			ctx;
+	char				name[64];
+	int				i, s, size;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0)
+			min_time	= 0.02;
+		else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			json_name	= argv[++i];
+		else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+			baseline_name	= argv[++i];
+		else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+			threshold	= atof(argv[++i]);
+		else {
+			usage(argv[0]);
+			return (EXIT_FAILURE);
+		}
+	}
+
+	bench_set_headless();
+	hw_init();
+	root				= hw_create_window(window_size, EI_FALSE);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.surface			= hw_surface_create(root, surface_size, EI_FALSE);
+	source				= hw_surface_create(root, surface_size, EI_FALSE);
+	alpha_source			= hw_surface_create(root, surface_size, EI_TRUE);
+	hw_surface_lock(ctx.surface);
+	hw_surface_lock(source);
+	hw_surface_lock(alpha_source);
+	ei_fill(source, &g_color, NULL);
+	ei_fill(alpha_source, &g_transparent_color, NULL);
+
+	for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+		size			= sizes[s];
+		ctx.rect.top_left.x	= 0;
+		ctx.rect.top_left.y	= 0;
+		ctx.rect.size.width	= size;
+		ctx.rect.size.height	= size;
+		ctx.clipped		= EI_FALSE;
+
+		sprintf(name, "fill_%d", size);
+		bench_run(&results[count++], name, (long)size * size, min_time, bench_fill, &ctx);
+
+		// La source est plus grande que la destination : on copie la partie de même taille.
+		ctx.alpha		= EI_FALSE;
+		ctx.source		= source;
+		sprintf(name, "copy_%d", size);
+		bench_run(&results[count++], name, (long)size * size, min_time, bench_copy, &ctx);
+		ctx.alpha		= EI_TRUE;
+		ctx.source		= alpha_source;
+		sprintf(name, "copy_alpha_%d", size);
+		bench_run(&results[count++], name, (long)size * size, min_time, bench_copy, &ctx);
+
+		ctx.points		= make_rect_points(ctx.rect);
+		sprintf(name, "polygon_rect_%d", size);
+		bench_run(&results[count++], name, (long)size * size, min_time, bench_polygon, &ctx);
+		free(ctx.points);
+
+		sprintf(name, "polygon_rounded_%d", size);
+		bench_run(&results[count++], name, (long)size * size, min_time, bench_rounded_frame, &ctx);
+
+		ctx.points		= make_star_points(ctx.rect);
+		sprintf(name, "polygon_concave_%d", size);
+		bench_run(&results[count++], name, (long)size * size, min_time, bench_polygon, &ctx);
+		free(ctx.points);
+
+		ctx.points		= make_zigzag_points(ctx.rect, 4);
+		sprintf(name, "polyline_short_%d", size);
+		bench_run(&results[count++], name, 4L * size, min_time, bench_polyline, &ctx);
+		free(ctx.points);
+
+		ctx.points		= make_zigzag_points(ctx.rect, 256);
+		sprintf(name, "polyline_long_%d", size);
+		bench_run(&results[count++], name, 256L * size, min_time, bench_polyline, &ctx);
+
+		// Même ligne, dont seul le quart central est visible.
+		ctx.clipped		= EI_TRUE;
+		ctx.clipper.top_left.x	= size / 4;
+		ctx.clipper.top_left.y	= size / 4;
+		ctx.clipper.size.width	= size / 2;
+		ctx.clipper.size.height	= size / 2;
+		sprintf(name, "polyline_clipped_%d", size);
+		bench_run(&results[count++], name, 256L * size, min_time, bench_polyline, &ctx);
+		free(ctx.points);
+		ctx.clipped		= EI_FALSE;
+	}
+
+	// Polygone plus grand que la surface : le remplissage est limité par le clipper.
+	ctx.rect.top_left.x		= -surface_size.width / 2;
+	ctx.rect.top_left.y		= -surface_size.height / 2;
+	ctx.rect.size.width		= 2 * surface_size.width;
+	ctx.rect.size.height		= 2 * surface_size.height;
+	ctx.clipped			= EI_TRUE;
+	ctx.clipper.top_left.x		= 0;
+	ctx.clipper.top_left.y		= 0;
+	ctx.clipper.size		= surface_size;
+	ctx.points			= make_star_points(ctx.rect);
+	bench_run(&results[count++], "polygon_large", (long)surface_size.width * surface_size.height, min_time,
+		  bench_polygon, &ctx);
+	free(ctx.points);
+
+	ctx.rect.top_left.x		= 10;
+	ctx.rect.top_left.y		= 10;
+	ctx.text			= "The quick brown fox jumps over the lazy dog";
+	bench_run(&results[count++], "text", 0, min_time, bench_text, &ctx);
+
+	hw_surface_unlock(alpha_source);
+	hw_surface_unlock(source);
+	hw_surface_unlock(ctx.surface);
+
+	bench_print(stdout, results, count);
+
+	if (json_name != NULL) {
+		FILE*			file		= fopen(json_name, "w");
+
+		if (file == NULL) {
+			perror(json_name);
+			return (EXIT_FAILURE);
+		}
+		bench_write_json(file, "draw", results, count);
+		fclose(file);
+	}
+
+	i				= 0;
+	if (baseline_name != NULL) {
+		int			baseline_count;
+		bench_result_t*		baseline	= bench_read_json(baseline_name, &baseline_count);
+
+		if (baseline == NULL) {
+			perror(baseline_name);
+			return (EXIT_FAILURE);
+		}
+		i			= bench_compare(stdout, results, count, baseline, baseline_count, threshold);
+		printf("%d regression(s) (threshold %.0f%%)\n", i, 100 * threshold);
+		free(baseline);
+	}
+
+	hw_surface_free(alpha_source);
+	hw_surface_free(source);
+	hw_surface_free(ctx.surface);
+	hw_quit();
+
+	return (i == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
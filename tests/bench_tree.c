@@ -0,0 +1,379 @@
+//
+//  bench_tree.c
+//  Scaling benchmark of the widget tree: builds wide, deep and nested trees of 10 to 100k
+//  widgets and measures each phase of their life (creation, placement, redraws, picking,
+//  destruction), with the peak resident memory after each phase.
+//
+//  The peak resident memory of a process is never reset: each (shape, widgets) case runs in its
+//  own child process, so that its peaks do not include those of the previous cases. Without
+//  fork (Windows), the cases run in the benchmark process and the peaks are cumulative.
+//
+//  Usage:	ei_bench_tree [--max 100000] [--csv results.csv]
+//
+//  The CSV has one line per (shape, widgets, phase); the standard output shows one table per
+//  shape, with a column per number of widgets, ready to be charted.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __WIN__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+
+#include "ei_application_utils.h"
+
+#include "bench_utils.h"
+
+#define MAX_SIZES	5
+#define SMALL_REDRAWS	100
+#define PICKS		1000
+#define NESTED_FANOUT	100
+
+/**
+ * @brief	The shapes of tree.
+ */
+typedef enum {
+	shape_wide	= 0,		///< Every widget is a child of the root widget.
+	shape_deep,			///< Every widget is the child of the previous one.
+	shape_nested,			///< Toplevels with NESTED_FANOUT - 1 buttons each.
+	shape_last
+} tree_shape_t;
+
+/**
+ * @brief	The classes of the created widgets.
+ */
+typedef enum {
+	class_frame	= 0,
+	class_button,
+	class_toplevel,
+	class_last
+} tree_class_t;
+
+/**
+ * @brief	The measured phases.
+ */
+typedef enum {
+	phase_create	= 0,
+	phase_place,
+	phase_redraw_full,
+	phase_redraw_small,
+	phase_pick_rebuild,
+	phase_pick,
+	phase_destroy,
+	phase_destroy_all,
+	phase_last
+} tree_phase_t;
+
+/**
+ * @brief	The measure of a phase.
+ */
+typedef struct {
+	long				ops;		///< Number of operations of the phase.
+	double				ms;		///< Total time of the phase, in milliseconds.
+	long				peak_rss_kb;	///< Peak resident memory of the case at the end of the phase.
+} phase_result_t;
+
+static const char*		g_shape_names[shape_last]	= {"wide", "deep", "nested"};
+static const char*		g_phase_names[phase_last]	= {"create", "place", "redraw_full", "redraw_small",
+								   "pick_rebuild", "pick", "destroy", "destroy_all"};
+static const ei_size_t		g_screen_size			= {800, 600};
+static ei_widgetclass_name_t	g_class_names[class_last]	= {"frame", "button", "toplevel"};
+static ei_widgetclass_handle_t	g_handles[class_last];
+
+static phase_result_t		g_results[shape_last][MAX_SIZES][phase_last];
+
+
+
+/* Type du i-ème widget, et son parent selon la forme de l'arbre. */
+static ei_widget_t* create_widget(tree_shape_t shape, int i, ei_widget_t** widgets)
+{
+	ei_widget_t*			parent			= ei_app_root_widget();
+	tree_class_t			wclass			= i % 3;
+	ei_widget_t*			widget;
+	ei_color_t			color;
+	int				border			= 1;
+
+	if (shape == shape_deep && i > 0) {
+		parent			= widgets[i - 1];
+		wclass			= i % 2;
+	} else if (shape == shape_nested) {
+		if (i % NESTED_FANOUT == 0) {
+			wclass		= class_toplevel;
+		} else {
+			parent		= widgets[i - i % NESTED_FANOUT];
+			wclass		= class_button;
+		}
+	}
+
+	widget				= ei_widget_create_from_handle(g_handles[wclass], parent, NULL, NULL);
+	color				= (ei_color_t){(unsigned char)(i * 37), (unsigned char)(i * 11), 0x80, 0xff};
+	if (wclass == class_frame)
+		ei_frame_configure(widget, NULL, &color, &border, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+	else if (wclass == class_button)
+		ei_button_configure(widget, NULL, &color, &border, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+				    NULL, NULL, NULL);
+	else
+		ei_toplevel_configure(widget, NULL, &color, &border, NULL, NULL, NULL, NULL);
+	return widget;
+}
+
+/* Position du i-ème widget : une grille de petites cases, ou une marge de 1 pixel dans le parent. */
+static void place_widget(tree_shape_t shape, int i, ei_widget_t* widget)
+{
+	int				x, y, width, height;
+	float				rel_size		= 1.0f;
+
+	if (shape == shape_deep && i > 0) {
+		x			= 1;
+		y			= 1;
+		width			= -2;
+		height			= -2;
+		ei_place(widget, NULL, &x, &y, &width, &height, NULL, NULL, &rel_size, &rel_size);
+		return;
+	}
+	if (shape == shape_nested && i % NESTED_FANOUT != 0) {
+		x			= 4 + 20 * ((i % NESTED_FANOUT) % 10);
+		y			= 24 + 20 * ((i % NESTED_FANOUT) / 10);
+		width			= 16;
+		height			= 16;
+	} else if (shape == shape_nested) {
+		x			= (7 * (i / NESTED_FANOUT)) % (g_screen_size.width - 200);
+		y			= (5 * (i / NESTED_FANOUT)) % (g_screen_size.height - 230);
+		width			= 208;
+		height			= 228;
+	} else {
+		x			= (24 * i) % g_screen_size.width;
+		y			= (24 * (24 * i / g_screen_size.width)) % g_screen_size.height;
+		width			= 20;
+		height			= 20;
+	}
+	ei_place(widget, NULL, &x, &y, &width, &height, NULL, NULL, NULL, NULL);
+}
+
+/* Redessine "damage" sur la fenêtre, comme une frame de ei_app_run. */
+static void redraw(ei_rect_t damage)
+{
+	ei_surface_t			root			= ei_app_root_surface();
+
+	hw_surface_lock(root);
+	draw_widget_recursively(ei_app_root_widget(), root, NULL, &damage);
+	hw_surface_unlock(root);
+}
+
+/* Dessine ce qui est en attente et rend la mémoire de la frame (arène), hors mesure. */
+static void flush(void)
+{
+	ei_app_quit_request();
+	ei_app_run();
+}
+
+static void end_phase(phase_result_t* result, long ops, double start)
+{
+	result->ops			= ops;
+	result->ms			= 1000 * (hw_now() - start);
+	result->peak_rss_kb		= bench_peak_rss_kb();
+}
+
+static void run_tree(tree_shape_t shape, int count, phase_result_t* results)
+{
+	ei_widget_t**			widgets			= malloc(count * sizeof(ei_widget_t*));
+	ei_widget_t*			root			= ei_app_root_widget();
+	ei_rect_t			full			= hw_surface_get_rect(ei_app_root_surface());
+	ei_rect_t			damage;
+	ei_point_t			where;
+	int				destroyed		= count / 10;
+	double				start;
+	int				i;
+
+	start				= hw_now();
+	for (i = 0; i < count; i++)
+		widgets[i]		= create_widget(shape, i, widgets);
+	end_phase(&results[phase_create], count, start);
+
+	start				= hw_now();
+	for (i = 0; i < count; i++)
+		place_widget(shape, i, widgets[i]);
+	ei_placer_flush();
+	end_phase(&results[phase_place], count, start);
+	flush();
+
+	start				= hw_now();
+	redraw(full);
+	end_phase(&results[phase_redraw_full], 1, start);
+
+	start				= hw_now();
+	for (i = 0; i < SMALL_REDRAWS; i++) {
+		damage			= ei_rect(ei_point((37 * i) % (full.size.width - 16),
+							   (53 * i) % (full.size.height - 16)), ei_size(16, 16));
+		redraw(damage);
+	}
+	end_phase(&results[phase_redraw_small], SMALL_REDRAWS, start);
+
+	// Le premier pick après une invalidation complète redessine la surface de picking.
+	ei_invalidate_pick_rect(full);
+	where				= ei_point(full.size.width / 2, full.size.height / 2);
+	start				= hw_now();
+	ei_widget_pick(&where);
+	end_phase(&results[phase_pick_rebuild], 1, start);
+
+	start				= hw_now();
+	for (i = 0; i < PICKS; i++) {
+		where			= ei_point((97 * i) % full.size.width, (61 * i) % full.size.height);
+		ei_widget_pick(&where);
+	}
+	end_phase(&results[phase_pick], PICKS, start);
+
+	// Les derniers widgets créés, un par un en commençant par le dernier : des feuilles.
+	start				= hw_now();
+	for (i = count - 1; i >= count - destroyed; i--)
+		ei_widget_destroy(widgets[i]);
+	end_phase(&results[phase_destroy], destroyed, start);
+
+	start				= hw_now();
+	ei_widget_destroy_children(root);
+	end_phase(&results[phase_destroy_all], count - destroyed, start);
+
+	flush();
+	free(widgets);
+}
+
+
+/* Crée l'application du benchmark et retrouve les classes des widgets. */
+static void start_app(void)
+{
+	int				i;
+
+	ei_app_create(g_screen_size, EI_FALSE);
+	ei_app_set_max_fps(0);
+	for (i = 0; i < class_last; i++)
+		g_handles[i]		= ei_widgetclass_get_handle(g_class_names[i]);
+}
+
+/*
+ * Mesure un cas dans un processus fils, qui a sa propre application et son propre pic de
+ * mémoire, et renvoie ses résultats par un tube. Retourne 0 si le cas n'a pas pu être mesuré.
+ */
+static int run_case(tree_shape_t shape, int count, phase_result_t* results)
+{
+#ifdef __WIN__
+	run_tree(shape, count, results);
+	return 1;
+#else
+	int				fds[2];
+	int				status;
+	size_t				length			= phase_last * sizeof(phase_result_t);
+	size_t				done			= 0;
+	ssize_t				n;
+	pid_t				child;
+
+	if (pipe(fds) != 0 || (child = fork()) < 0) {
+		perror("fork");
+		return 0;
+	}
+	if (child == 0) {
+		close(fds[0]);
+		start_app();
+		run_tree(shape, count, results);
+		ei_app_free();
+		while (done < length && (n = write(fds[1], (char*)results + done, length - done)) > 0)
+			done		+= (size_t)n;
+		_exit((done == length) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	close(fds[1]);
+	while (done < length && (n = read(fds[0], (char*)results + done, length - done)) > 0)
+		done			+= (size_t)n;
+	close(fds[0]);
+	if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS
+	    || done != length) {
+		fprintf(stderr, "%s tree of %d widgets: the measuring process failed\n", g_shape_names[shape], count);
+		return 0;
+	}
+	return 1;
+#endif
+}
+
+
+
+/*
+ * main --
+ *
+ *	Runs every phase for every shape and size, writes the CSV and prints the scaling tables.
+ */
+int main(int argc, char** argv)
+{
+	int				sizes[MAX_SIZES];
+	int				nb_sizes		= 0;
+	int				max_widgets		= 100000;
+	const char*			csv_name		= NULL;
+	FILE*				csv			= NULL;
+	phase_result_t*			r;
+	int				shape, s, phase, n, i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--max") == 0 && i + 1 < argc)
+			max_widgets	= atoi(argv[++i]);
+		else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+			csv_name	= argv[++i];
+		else {
+			fprintf(stderr, "usage: %s [--max 100000] [--csv results.csv]\n", argv[0]);
+			return (EXIT_FAILURE);
+		}
+	}
+	for (n = 10; n <= max_widgets && nb_sizes < MAX_SIZES; n *= 10)
+		sizes[nb_sizes++]	= n;
+
+	bench_set_headless();
+#ifdef __WIN__
+	start_app();
+#endif
+
+	for (shape = 0; shape < shape_last; shape++)
+		for (s = 0; s < nb_sizes; s++)
+			if (!run_case(shape, sizes[s], g_results[shape][s]))
+				return (EXIT_FAILURE);
+
+	if (csv_name != NULL && (csv = fopen(csv_name, "w")) == NULL)
+		perror(csv_name);
+	if (csv != NULL)
+		fprintf(csv, "shape,widgets,phase,ops,total_ms,us_per_op,peak_rss_kb\n");
+
+	for (shape = 0; shape < shape_last; shape++) {
+		printf("\n%s tree: total time in ms (peak RSS in kB on the last line)\n%-14s", g_shape_names[shape],
+		       "phase");
+		for (s = 0; s < nb_sizes; s++)
+			printf(" %12d", sizes[s]);
+		printf("\n");
+		for (phase = 0; phase < phase_last; phase++) {
+			printf("%-14s", g_phase_names[phase]);
+			for (s = 0; s < nb_sizes; s++) {
+				r		= &g_results[shape][s][phase];
+				printf(" %12.3f", r->ms);
+				if (csv != NULL)
+					fprintf(csv, "%s,%d,%s,%ld,%.3f,%.3f,%ld\n", g_shape_names[shape], sizes[s],
+						g_phase_names[phase], r->ops, r->ms,
+						(r->ops > 0) ? 1000 * r->ms / r->ops : 0.0, r->peak_rss_kb);
+			}
+			printf("\n");
+		}
+		printf("%-14s", "peak_rss_kb");
+		for (s = 0; s < nb_sizes; s++)
+			printf(" %12ld", g_results[shape][s][phase_last - 1].peak_rss_kb);
+		printf("\n");
+	}
+	if (csv != NULL)
+		fclose(csv);
+
+#ifdef __WIN__
+	ei_app_free();
+#endif
+
+	return (EXIT_SUCCESS);
+}
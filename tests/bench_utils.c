@@ -0,0 +1,195 @@
+//
+//  bench_utils.c
+//  Tools shared by the benchmark targets.
+//
+
+#include "bench_utils.h"
+
+#include "hw_interface.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __WIN__
+#include <sys/resource.h>
+#endif
+
+#ifdef BENCH_WRAP_MALLOC
+
+static long			g_alloc_count		= 0;
+
+void*	__real_malloc	(size_t size);
+void*	__real_calloc	(size_t count, size_t size);
+void*	__real_realloc	(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+	g_alloc_count++;
+	return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+	g_alloc_count++;
+	return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+	g_alloc_count++;
+	return __real_realloc(ptr, size);
+}
+
+long bench_alloc_count(void)
+{
+	return g_alloc_count;
+}
+
+#else
+
+long bench_alloc_count(void)
+{
+	return -1;
+}
+
+#endif
+
+
+
+void bench_set_headless(void)
+{
+	if (getenv("SDL_VIDEODRIVER") != NULL)
+		return;
+#ifdef __WIN__
+	_putenv("SDL_VIDEODRIVER=dummy");
+#else
+	setenv("SDL_VIDEODRIVER", "dummy", 0);
+#endif
+}
+
+long bench_peak_rss_kb(void)
+{
+#ifdef __WIN__
+	return -1;
+#else
+	struct rusage			usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;	// en octets sous macOS
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+void bench_run(bench_result_t* result, const char* name, long pixels, double min_time, bench_func_t func, void* ctx)
+{
+	long				calls		= 0;
+	long				batch		= 1;
+	long				i;
+	long				allocs;
+	double				start;
+	double				elapsed		= 0.0;
+
+	func(ctx);	// warm-up: caches, lazy allocations
+
+	allocs				= bench_alloc_count();
+	start				= hw_now();
+	while (elapsed < min_time) {
+		for (i = 0; i < batch; i++)
+			func(ctx);
+		calls			+= batch;
+		batch			*= 2;
+		elapsed			= hw_now() - start;
+	}
+
+	memset(result, 0, sizeof(*result));
+	strncpy(result->name, name, sizeof(result->name) - 1);
+	result->pixels			= pixels;
+	result->calls			= calls;
+	result->ns_per_call		= 1e9 * elapsed / calls;
+	result->ns_per_pixel		= (pixels > 0) ? result->ns_per_call / pixels : 0.0;
+	result->allocs_per_call		= (allocs < 0) ? -1.0 : (double)(bench_alloc_count() - allocs) / calls;
+}
+
+void bench_print(FILE* out, const bench_result_t* results, int count)
+{
+	int				i;
+
+	fprintf(out, "%-28s %10s %14s %12s %10s\n", "case", "pixels", "ns/call", "ns/pixel", "allocs");
+	for (i = 0; i < count; i++)
+		fprintf(out, "%-28s %10ld %14.1f %12.3f %10.2f\n", results[i].name, results[i].pixels,
+			results[i].ns_per_call, results[i].ns_per_pixel, results[i].allocs_per_call);
+}
+
+void bench_write_json(FILE* out, const char* benchmark, const bench_result_t* results, int count)
+{
+	int				i;
+
+	fprintf(out, "{\"benchmark\": \"%s\", \"results\": [\n", benchmark);
+	for (i = 0; i < count; i++)
+		fprintf(out, "{\"name\": \"%s\", \"pixels\": %ld, \"calls\": %ld, \"ns_per_call\": %.3f, "
+			"\"ns_per_pixel\": %.6f, \"allocs_per_call\": %.3f}%s\n",
+			results[i].name, results[i].pixels, results[i].calls, results[i].ns_per_call,
+			results[i].ns_per_pixel, results[i].allocs_per_call, (i + 1 < count) ? "," : "");
+	fprintf(out, "]}\n");
+}
+
+bench_result_t* bench_read_json(const char* filename, int* count)
+{
+	FILE*				file		= fopen(filename, "r");
+	char				line[512];
+	int				capacity	= 64;
+	bench_result_t*			results;
+	bench_result_t			r;
+
+	if (file == NULL)
+		return NULL;
+	results				= malloc(capacity * sizeof(bench_result_t));
+	*count				= 0;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		memset(&r, 0, sizeof(r));
+		if (sscanf(line, "{\"name\": \"%63[^\"]\", \"pixels\": %ld, \"calls\": %ld, \"ns_per_call\": %lf, "
+			   "\"ns_per_pixel\": %lf, \"allocs_per_call\": %lf", r.name, &r.pixels, &r.calls,
+			   &r.ns_per_call, &r.ns_per_pixel, &r.allocs_per_call) != 6)
+			continue;
+		if (*count == capacity) {
+			capacity		*= 2;
+			results			= realloc(results, capacity * sizeof(bench_result_t));
+		}
+		results[(*count)++]		= r;
+	}
+	fclose(file);
+	return results;
+}
+
+int bench_compare(FILE* out, const bench_result_t* results, int count, const bench_result_t* baseline,
+		  int baseline_count, double threshold)
+{
+	int				i, j;
+	int				regressions	= 0;
+	double				ratio;
+
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < baseline_count && strcmp(results[i].name, baseline[j].name) != 0; j++)
+			;
+		if (j == baseline_count) {
+			fprintf(out, "%-28s new case\n", results[i].name);
+			continue;
+		}
+		ratio			= (baseline[j].ns_per_call > 0) ? results[i].ns_per_call / baseline[j].ns_per_call : 1.0;
+		if (ratio > 1.0 + threshold) {
+			fprintf(out, "%-28s REGRESSION time x%.2f (%.1f -> %.1f ns/call)\n", results[i].name, ratio,
+				baseline[j].ns_per_call, results[i].ns_per_call);
+			regressions++;
+		} else if (baseline[j].allocs_per_call >= 0 && results[i].allocs_per_call > baseline[j].allocs_per_call + 0.01) {
+			fprintf(out, "%-28s REGRESSION allocs %.2f -> %.2f per call\n", results[i].name,
+				baseline[j].allocs_per_call, results[i].allocs_per_call);
+			regressions++;
+		} else {
+			fprintf(out, "%-28s ok (time x%.2f)\n", results[i].name, ratio);
+		}
+	}
+	return regressions;
+}
@@ -0,0 +1,97 @@
+//
+//  bench_utils.h
+//  Tools shared by the benchmark targets: timing, allocation counting, JSON reports and
+//  comparison against a saved baseline.
+//
+
+#ifndef EI_BENCH_UTILS
+#define EI_BENCH_UTILS
+
+#include <stdio.h>
+
+#include "ei_types.h"
+
+/**
+ * @brief	The measures of one benchmark case.
+ */
+typedef struct {
+	char				name[64];	///< Name of the case, unique in a report.
+	long				pixels;		///< Number of pixels touched by one call (0 if not relevant).
+	long				calls;		///< Number of calls that were timed.
+	double				ns_per_call;	///< Mean time of a call, in nanoseconds.
+	double				ns_per_pixel;	///< ns_per_call / pixels (0 if pixels is 0).
+	double				allocs_per_call;///< Mean number of malloc/calloc/realloc per call, -1 if not counted.
+} bench_result_t;
+
+/**
+ * @brief	A function measured by \ref bench_run.
+ *
+ * @param	ctx		The context given to \ref bench_run.
+ */
+typedef void			(*bench_func_t)		(void* ctx);
+
+/**
+ * @brief	Sets the headless video driver (SDL "dummy") unless SDL_VIDEODRIVER is already set.
+ *		Must be called before \ref hw_init or \ref ei_app_create.
+ */
+void				bench_set_headless	(void);
+
+/**
+ * @brief	Returns the number of calls to malloc, calloc and realloc since the beginning of the
+ *		program, or -1 if the allocations are not counted (the benchmark must be linked with
+ *		-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc and BENCH_WRAP_MALLOC defined).
+ */
+long				bench_alloc_count	(void);
+
+/**
+ * @brief	Returns the peak resident set size of the process, in kilobytes, or -1 if it is not
+ *		available on this platform.
+ */
+long				bench_peak_rss_kb	(void);
+
+/**
+ * @brief	Calls "func" repeatedly for at least "min_time" seconds (after a warm-up call)
+ *		and fills "result" with the measures.
+ *
+ * @param	result		Where to store the measures.
+ * @param	name		The name of the case.
+ * @param	pixels		The number of pixels touched by one call.
+ * @param	min_time	The minimum duration of the measure, in seconds.
+ * @param	func		The function to measure.
+ * @param	ctx		The parameter of "func".
+ */
+void				bench_run		(bench_result_t* result, const char* name, long pixels,
+							 double min_time, bench_func_t func, void* ctx);
+
+/**
+ * @brief	Prints a human readable table of the results.
+ */
+void				bench_print		(FILE* out, const bench_result_t* results, int count);
+
+/**
+ * @brief	Writes the results as JSON: {"benchmark": name, "results": [{...}, ...]}, one result per line.
+ */
+void				bench_write_json	(FILE* out, const char* benchmark,
+							 const bench_result_t* results, int count);
+
+/**
+ * @brief	Reads a report written by \ref bench_write_json.
+ *
+ * @param	filename	The report.
+ * @param	count		Where to store the number of results.
+ *
+ * @return			The results (to be freed), or NULL if the file could not be read.
+ */
+bench_result_t*			bench_read_json		(const char* filename, int* count);
+
+/**
+ * @brief	Compares the results with a baseline and prints every case that is slower by more
+ *		than "threshold" (0.1 means 10%) or that allocates more.
+ *
+ * @return			The number of regressions.
+ */
+int				bench_compare		(FILE* out, const bench_result_t* results, int count,
+							 const bench_result_t* baseline, int baseline_count,
+							 double threshold);
+
+#endif
@@ -0,0 +1,528 @@
+//
+//  golden.c
+//  Golden-image tests: renders a fixed corpus of scenes on the headless backend, compares each
+//  image to a reference (tests/golden/<scene>.ppm) with a per-channel tolerance, and times the
+//  rendering of each scene in the same run.
+//
+//  Usage:	ei_golden [--refs dir] [--update] [--tolerance 2] [--repeat 5] [--scene name]...
+//
+//  --update writes the references instead of comparing. A scene without reference fails.
+//  --scene limits the run to the named scenes (all of them by default).
+//  When a scene differs, its image is written to <scene>.actual.ppm in the current directory.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_draw.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+
+#include "bench_utils.h"
+
+#define STAR_BRANCHES	9
+#define MAX_SELECTED	16
+
+/**
+ * @brief	A scene: builds the widgets of a layout, or draws primitives on the root surface.
+ */
+typedef struct {
+	const char*			name;
+	void				(*build)	(void);		///< Creates the widgets, or NULL.
+	void				(*draw)		(ei_surface_t surface);	///< Draws on the locked root surface, or NULL.
+} golden_scene_t;
+
+static const ei_size_t		g_screen_size		= {1024, 768};
+static const ei_color_t		g_root_bgcol		= {0x52, 0x7f, 0xb4, 0xff};
+
+
+
+/* Layout de tests/frame.c */
+static void build_frame(void)
+{
+	ei_widget_t*			frame;
+	ei_size_t			frame_size		= {300, 200};
+	int				frame_x			= 150;
+	int				frame_y			= 200;
+	ei_color_t			frame_color		= {0x88, 0x88, 0x88, 0xff};
+	ei_relief_t			frame_relief		= ei_relief_raised;
+	int				frame_border_width	= 6;
+	char*				frame_text		= "je suis un frame";
+
+	frame				= ei_widget_create("frame", ei_app_root_widget(), NULL, NULL);
+	ei_frame_configure(frame, &frame_size, &frame_color, &frame_border_width, &frame_relief, &frame_text, NULL,
+			   NULL, NULL, NULL, NULL, NULL);
+	ei_place(frame, NULL, &frame_x, &frame_y, NULL, NULL, NULL, NULL, NULL, NULL);
+}
+
+/* Layout de tests/button.c */
+static void build_button(void)
+{
+	ei_widget_t*			button;
+	ei_widget_t*			button2;
+	ei_size_t			button_size		= {300, 200};
+	ei_size_t			button_size2		= {300, 100};
+	int				button_corner_radius	= 40;
+	int				button_corner_radius2	= 10;
+	int				button_x		= 150;
+	int				button_x2		= 0;
+	int				button_y		= 200;
+	int				button_y2		= 50;
+	ei_color_t			button_color		= {0x00, 0xab, 0x88, 0xaf};
+	ei_color_t			button_color2		= {0xba, 0x88, 0x88, 0xff};
+	char*				button_title		= "Mon premier Bouton !";
+	char*				button_title2		= "Mon deuxième Bouton !";
+	ei_color_t			button_text_color	= {0x00, 0x00, 0x00, 0xff};
+	ei_relief_t			button_relief		= ei_relief_raised;
+	int				button_border_width	= 60;
+	int				button_border_width2	= 30;
+
+	button				= ei_widget_create("button", ei_app_root_widget(), NULL, NULL);
+	button2				= ei_widget_create("button", ei_app_root_widget(), NULL, NULL);
+	ei_button_configure(button, &button_size, &button_color, &button_border_width, &button_corner_radius,
+			    &button_relief, &button_title, NULL, &button_text_color, NULL, NULL, NULL, NULL, NULL, NULL);
+	ei_button_configure(button2, &button_size2, &button_color2, &button_border_width2, &button_corner_radius2,
+			    &button_relief, &button_title2, NULL, &button_text_color, NULL, NULL, NULL, NULL, NULL, NULL);
+	ei_place(button, NULL, &button_x, &button_y, NULL, NULL, NULL, NULL, NULL, NULL);
+	ei_place(button2, NULL, &button_x2, &button_y2, NULL, NULL, NULL, NULL, NULL, NULL);
+}
+
+/* Layout de tests/hello_world.c */
+static void build_hello_world(void)
+{
+	ei_widget_t*			button;
+	ei_anchor_t			button_anchor		= ei_anc_southeast;
+	int				button_x		= -20;
+	int				button_y		= -20;
+	float				button_rel_x		= 1.0;
+	float				button_rel_y		= 1.0;
+	float				button_rel_width	= 0.5;
+	ei_color_t			button_color		= {0x88, 0x88, 0x88, 0xff};
+	char*				button_title		= "click";
+	ei_color_t			button_text_color	= {0x00, 0x00, 0x00, 0xff};
+	ei_relief_t			button_relief		= ei_relief_raised;
+	int				button_border_width	= 2;
+	ei_widget_t*			window;
+	ei_size_t			window_size		= {320, 240};
+	char*				window_title		= "Hello World";
+	ei_color_t			window_color		= {0xA0, 0xA0, 0xA0, 0xff};
+	int				window_border_width	= 2;
+	ei_bool_t			window_closable		= EI_TRUE;
+	ei_axis_set_t			window_resizable	= ei_axis_both;
+	ei_point_t			window_position		= {30, 10};
+
+	window				= ei_widget_create("toplevel", ei_app_root_widget(), NULL, NULL);
+	ei_toplevel_configure(window, &window_size, &window_color, &window_border_width, &window_title,
+			      &window_closable, &window_resizable, NULL);
+	ei_place(window, NULL, &window_position.x, &window_position.y, NULL, NULL, NULL, NULL, NULL, NULL);
+
+	button				= ei_widget_create("button", window, NULL, NULL);
+	ei_button_configure(button, NULL, &button_color, &button_border_width, NULL, &button_relief, &button_title,
+			    NULL, &button_text_color, NULL, NULL, NULL, NULL, NULL, NULL);
+	ei_place(button, &button_anchor, &button_x, &button_y, NULL, NULL, &button_rel_x, &button_rel_y,
+		 &button_rel_width, NULL);
+}
+
+/* Le frame garde le pointeur du texte : les libellés doivent survivre à la construction de la scène. */
+static char*			g_two048_labels[12]	= {"1", "2", "4", "8", "16", "32", "64", "128", "256", "512",
+							   "1024", "2048"};
+
+/* Layout de tests/two048.c : deux plateaux 4x4, avec des tuiles fixes au lieu de tuiles aléatoires. */
+static void build_two048_game(ei_point_t position, int tile_size, int tile_bd, ei_font_t font)
+{
+	static const int		values[16]		= {1, -1, 2, 3, -1, 4, 5, -1, 6, -1, 7, 8, 9, 10, -1, 11};
+	static const ei_color_t		bg_col			= {0xbd, 0xb1, 0xa3, 0xcc};
+	static const ei_color_t		bd_col			= {0xa9, 0x99, 0x8c, 0xcc};
+	static const ei_color_t		tile_colors[12]		= {
+		{0x00, 0x00, 0x00, 0xff}, {0xf1, 0xe8, 0xdb, 0xff}, {0xf0, 0xe3, 0xca, 0xff}, {0xf5, 0xb7, 0x81, 0xff},
+		{0xf8, 0x9c, 0x6f, 0xff}, {0xf8, 0x87, 0x6e, 0xff}, {0xf7, 0x6d, 0x4f, 0xff}, {0xef, 0xd2, 0x7d, 0xff},
+		{0xf0, 0xcf, 0x6d, 0xff}, {0xf2, 0xcc, 0x63, 0xff}, {0xf1, 0xc9, 0x58, 0xff}, {0xef, 0xc5, 0x49, 0xff}};
+	ei_widget_t*			toplevel;
+	ei_widget_t*			tile;
+	ei_size_t			toplevel_size;
+	ei_size_t			size			= ei_size(tile_size, tile_size);
+	int				full_size		= tile_size + 2 * tile_bd;
+	int				border			= 0;
+	ei_relief_t			relief			= ei_relief_none;
+	ei_axis_set_t			resizable		= ei_axis_none;
+	char*				title			= "2048";
+	ei_color_t			color;
+	ei_point_t			pos;
+	char*				label;
+	int				x, y;
+
+	toplevel			= ei_widget_create("toplevel", ei_app_root_widget(), NULL, NULL);
+	toplevel_size			= ei_size(4 * full_size + 2 * tile_bd, 4 * full_size + 2 * tile_bd);
+	color				= bd_col;
+	ei_toplevel_configure(toplevel, &toplevel_size, &color, &border, &title, NULL, &resizable, NULL);
+	ei_place(toplevel, NULL, &position.x, &position.y, NULL, NULL, NULL, NULL, NULL, NULL);
+
+	for (y = 0; y < 4; y++) {
+		for (x = 0; x < 4; x++) {
+			pos		= ei_point(2 * tile_bd + x * full_size, 2 * tile_bd + y * full_size);
+			tile		= ei_widget_create("frame", toplevel, NULL, NULL);
+			color		= bg_col;
+			ei_frame_configure(tile, &size, &color, &border, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+			ei_place(tile, NULL, &pos.x, &pos.y, NULL, NULL, NULL, NULL, NULL, NULL);
+			if (values[4 * y + x] < 0)
+				continue;
+			tile		= ei_widget_create("frame", toplevel, NULL, NULL);
+			color		= tile_colors[values[4 * y + x]];
+			label		= g_two048_labels[values[4 * y + x]];
+			ei_frame_configure(tile, &size, &color, &border, &relief, &label, &font, NULL, NULL, NULL,
+					   NULL, NULL);
+			ei_place(tile, NULL, &pos.x, &pos.y, NULL, NULL, NULL, NULL, NULL, NULL);
+		}
+	}
+}
+
+static ei_font_t		g_two048_fonts[2]	= {NULL, NULL};
+
+static void build_two048(void)
+{
+	if (g_two048_fonts[0] == NULL) {
+		g_two048_fonts[0]	= hw_text_font_create(ei_default_font_filename, ei_style_normal, 40);
+		g_two048_fonts[1]	= hw_text_font_create(ei_default_font_filename, ei_style_normal, 50);
+	}
+	build_two048_game(ei_point(20, 20), 80, 4, g_two048_fonts[0]);
+	build_two048_game(ei_point(60, 60), 100, 4, g_two048_fonts[1]);
+}
+
+
+
+/* Liste chaînée de points, dans un tableau de "count" éléments. */
+static ei_linked_point_t* link_points(ei_linked_point_t* points, int count)
+{
+	int				i;
+
+	for (i = 0; i < count; i++)
+		points[i].next		= (i + 1 < count) ? &points[i + 1] : NULL;
+	return points;
+}
+
+/* Polygones : rectangles, étoiles concaves, polygone débordant de la surface, avec et sans clipper. */
+static void draw_polygons(ei_surface_t surface)
+{
+	ei_linked_point_t		points[2 * STAR_BRANCHES];
+	ei_color_t			colors[3]		= {{0xe0, 0x40, 0x30, 0xff}, {0x30, 0xc0, 0x60, 0x80},
+								   {0x20, 0x40, 0xe0, 0xc0}};
+	ei_rect_t			clipper			= ei_rect(ei_point(600, 100), ei_size(300, 500));
+	double				r, angle;
+	int				i, s;
+
+	ei_fill(surface, &g_root_bgcol, NULL);
+	for (s = 0; s < 3; s++) {
+		for (i = 0; i < 2 * STAR_BRANCHES; i++) {
+			r		= (i % 2 == 0) ? 200 - 50 * s : 60;
+			angle		= i * M_PI / STAR_BRANCHES + s * 0.3;
+			points[i].point	= ei_point(250 + 300 * s + (int)(r * cos(angle)), 380 + (int)(r * sin(angle)));
+		}
+		ei_draw_polygon(surface, link_points(points, 2 * STAR_BRANCHES), colors[s], (s == 2) ? &clipper : NULL);
+	}
+
+	points[0].point			= ei_point(-100, 700);
+	points[1].point			= ei_point(1200, 600);
+	points[2].point			= ei_point(1100, 900);
+	ei_draw_polygon(surface, link_points(points, 3), colors[0], NULL);
+}
+
+/* Lignes : toutes les pentes autour d'un centre, puis les mêmes coupées par un clipper. */
+static void draw_polylines(ei_surface_t surface)
+{
+	ei_linked_point_t		points[2];
+	ei_color_t			color			= {0xff, 0xff, 0xff, 0xff};
+	ei_color_t			transparent		= {0xff, 0x80, 0x00, 0x80};
+	ei_rect_t			clipper			= ei_rect(ei_point(620, 200), ei_size(200, 300));
+	double				angle;
+	int				i;
+
+	ei_fill(surface, &g_root_bgcol, NULL);
+	for (i = 0; i < 64; i++) {
+		angle			= i * 2 * M_PI / 64;
+		points[0].point		= ei_point(250, 380);
+		points[1].point		= ei_point(250 + (int)(230 * cos(angle)), 380 + (int)(230 * sin(angle)));
+		ei_draw_polyline(surface, link_points(points, 2), color, NULL);
+		points[0].point		= ei_point(720, 380);
+		points[1].point		= ei_point(720 + (int)(230 * cos(angle)), 380 + (int)(230 * sin(angle)));
+		ei_draw_polyline(surface, link_points(points, 2), transparent, &clipper);
+	}
+}
+
+/* Copies : surface opaque, surface transparente mélangée, et texte. */
+static void draw_copies(ei_surface_t surface)
+{
+	ei_surface_t			source;
+	ei_size_t			source_size		= {256, 256};
+	ei_rect_t			dst_rect;
+	ei_color_t			color;
+	ei_rect_t			band;
+	ei_point_t			where			= {40, 600};
+	int				i;
+
+	ei_fill(surface, &g_root_bgcol, NULL);
+	source				= hw_surface_create(surface, source_size, EI_TRUE);
+	hw_surface_lock(source);
+	for (i = 0; i < 16; i++) {
+		color			= (ei_color_t){(unsigned char)(16 * i), 0x80, (unsigned char)(255 - 16 * i),
+						       (unsigned char)(16 * i + 15)};
+		band			= ei_rect(ei_point(0, 16 * i), ei_size(256, 16));
+		ei_fill(source, &color, &band);
+	}
+	dst_rect			= ei_rect(ei_point(40, 40), source_size);
+	ei_copy_surface(surface, &dst_rect, source, NULL, EI_FALSE);
+	dst_rect			= ei_rect(ei_point(400, 40), source_size);
+	ei_copy_surface(surface, &dst_rect, source, NULL, EI_TRUE);
+	hw_surface_unlock(source);
+	hw_surface_free(source);
+
+	color				= (ei_color_t){0xff, 0xff, 0xff, 0xff};
+	ei_draw_text(surface, &where, "Golden images: the quick brown fox", NULL, color, NULL);
+}
+
+static const golden_scene_t	g_scenes[]		= {
+	{"frame",		build_frame,		NULL},
+	{"button",		build_button,		NULL},
+	{"hello_world",		build_hello_world,	NULL},
+	{"two048",		build_two048,		NULL},
+	{"polygons",		NULL,			draw_polygons},
+	{"polylines",		NULL,			draw_polylines},
+	{"copies",		NULL,			draw_copies}
+};
+
+
+
+/* Vrai si la scène "name" fait partie des scènes demandées (toutes si aucune ne l'est). */
+static ei_bool_t is_selected(const char* name, const char* const* selected, int selected_count)
+{
+	int				i;
+
+	for (i = 0; i < selected_count; i++)
+		if (strcmp(selected[i], name) == 0)
+			return EI_TRUE;
+	return (ei_bool_t)(selected_count == 0);
+}
+
+/* Détruit tous les widgets d'une scène précédente. */
+static void clear_scene(void)
+{
+	ei_widget_t*			root			= ei_app_root_widget();
+	ei_color_t			color			= g_root_bgcol;
+
+	ei_widget_destroy_children(root);
+	ei_frame_configure(root, NULL, &color, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+}
+
+/* Dessine la scène sur la surface racine. */
+static void render_scene(const golden_scene_t* scene)
+{
+	ei_surface_t			root			= ei_app_root_surface();
+
+	if (scene->draw != NULL) {
+		hw_surface_lock(root);
+		scene->draw(root);
+		hw_surface_unlock(root);
+		return;
+	}
+	// Avec une fin demandée avant, ei_app_run dessine toute la fenêtre une fois et rend la main.
+	ei_app_quit_request();
+	ei_app_run();
+}
+
+/* Copie la surface racine en RGB, 3 octets par pixel. */
+static unsigned char* read_root_rgb(ei_size_t* size)
+{
+	ei_surface_t			root			= ei_app_root_surface();
+	unsigned char*			rgb;
+	uint8_t*			pixel;
+	int				ir, ig, ib, ia;
+	int				i;
+
+	*size				= hw_surface_get_size(root);
+	rgb				= malloc((size_t)size->width * size->height * 3);
+	hw_surface_get_channel_indices(root, &ir, &ig, &ib, &ia);
+	hw_surface_lock(root);
+	pixel				= hw_surface_get_buffer(root);
+	for (i = 0; i < size->width * size->height; i++, pixel += 4) {
+		rgb[3 * i]		= pixel[ir];
+		rgb[3 * i + 1]		= pixel[ig];
+		rgb[3 * i + 2]		= pixel[ib];
+	}
+	hw_surface_unlock(root);
+	return rgb;
+}
+
+static int write_ppm(const char* filename, const unsigned char* rgb, ei_size_t size)
+{
+	FILE*				file			= fopen(filename, "wb");
+
+	if (file == NULL)
+		return 0;
+	fprintf(file, "P6\n%d %d\n255\n", size.width, size.height);
+	fwrite(rgb, 3, (size_t)size.width * size.height, file);
+	fclose(file);
+	return 1;
+}
+
+static unsigned char* read_ppm(const char* filename, ei_size_t* size)
+{
+	FILE*				file			= fopen(filename, "rb");
+	unsigned char*			rgb;
+	int				max_value;
+
+	if (file == NULL)
+		return NULL;
+	if (fscanf(file, "P6 %d %d %d", &size->width, &size->height, &max_value) != 3 || max_value != 255
+	    || fgetc(file) == EOF) {
+		fclose(file);
+		return NULL;
+	}
+	rgb				= malloc((size_t)size->width * size->height * 3);
+	if (fread(rgb, 3, (size_t)size->width * size->height, file) != (size_t)size->width * size->height) {
+		free(rgb);
+		rgb			= NULL;
+	}
+	fclose(file);
+	return rgb;
+}
+
+/* Nombre de pixels dont une composante diffère de plus de "tolerance". */
+static long count_differences(const unsigned char* a, const unsigned char* b, ei_size_t size, int tolerance,
+			      int* max_error)
+{
+	long				count			= 0;
+	long				i;
+	int				c, error, pixel_error;
+
+	*max_error			= 0;
+	for (i = 0; i < (long)size.width * size.height; i++) {
+		pixel_error		= 0;
+		for (c = 0; c < 3; c++) {
+			error		= abs(a[3 * i + c] - b[3 * i + c]);
+			if (error > pixel_error)
+				pixel_error	= error;
+		}
+		if (pixel_error > *max_error)
+			*max_error	= pixel_error;
+		if (pixel_error > tolerance)
+			count++;
+	}
+	return count;
+}
+
+
+
+/*
+ * main --
+ *
+ *	Renders, times and checks every scene. Returns EXIT_FAILURE if a scene differs from its
+ *	reference.
+ */
+int main(int argc, char** argv)
+{
+	const char*			refs_dir		= "tests/golden";
+	ei_bool_t			update			= EI_FALSE;
+	int				tolerance		= 2;
+	int				repeat			= 5;
+	int				failures		= 0;
+	const char*			selected[MAX_SELECTED];
+	int				selected_count		= 0;
+	char				filename[512];
+	const golden_scene_t*		scene;
+	unsigned char*			image;
+	unsigned char*			reference;
+	ei_size_t			size, ref_size;
+	double				start, elapsed, best;
+	long				differences;
+	int				max_error;
+	int				i, r;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--update") == 0)
+			update		= EI_TRUE;
+		else if (strcmp(argv[i], "--refs") == 0 && i + 1 < argc)
+			refs_dir	= argv[++i];
+		else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+			tolerance	= atoi(argv[++i]);
+		else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+			repeat		= atoi(argv[++i]);
+		else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc && selected_count < MAX_SELECTED)
+			selected[selected_count++] = argv[++i];
+		else {
+			fprintf(stderr, "usage: %s [--refs dir] [--update] [--tolerance 2] [--repeat 5] [--scene name]...\n",
+				argv[0]);
+			return (EXIT_FAILURE);
+		}
+	}
+	if (repeat < 1)
+		repeat			= 1;
+
+	bench_set_headless();
+	ei_app_create(g_screen_size, EI_FALSE);
+	ei_app_set_max_fps(0);
+
+	printf("%-14s %10s %10s  %s\n", "scene", "best (ms)", "mean (ms)", "result");
+	for (i = 0; i < (int)(sizeof(g_scenes) / sizeof(g_scenes[0])); i++) {
+		scene			= &g_scenes[i];
+		if (!is_selected(scene->name, selected, selected_count))
+			continue;
+		clear_scene();
+		if (scene->build != NULL)
+			scene->build();
+
+		// Le premier rendu (mise en place, caches) n'est pas compté.
+		render_scene(scene);
+		elapsed			= 0;
+		best			= -1;
+		for (r = 0; r < repeat; r++) {
+			start		= hw_now();
+			render_scene(scene);
+			start		= hw_now() - start;
+			elapsed		+= start;
+			if (best < 0 || start < best)
+				best	= start;
+		}
+		printf("%-14s %10.3f %10.3f  ", scene->name, 1000 * best, 1000 * elapsed / repeat);
+
+		image			= read_root_rgb(&size);
+		sprintf(filename, "%s/%s.ppm", refs_dir, scene->name);
+		if (update) {
+			if (write_ppm(filename, image, size)) {
+				printf("updated %s\n", filename);
+			} else {
+				printf("cannot write %s\n", filename);
+				failures++;
+			}
+		} else if ((reference = read_ppm(filename, &ref_size)) == NULL) {
+			printf("FAILED (no reference %s, run with --update)\n", filename);
+			failures++;
+		} else {
+			if (ref_size.width != size.width || ref_size.height != size.height) {
+				printf("FAILED (size %dx%d, reference %dx%d)\n", size.width, size.height,
+				       ref_size.width, ref_size.height);
+				failures++;
+			} else if ((differences = count_differences(image, reference, size, tolerance, &max_error)) > 0) {
+				sprintf(filename, "%s.actual.ppm", scene->name);
+				write_ppm(filename, image, size);
+				printf("FAILED (%ld pixels differ, max error %d, see %s)\n", differences, max_error, filename);
+				failures++;
+			} else {
+				printf("ok (max error %d)\n", max_error);
+			}
+			free(reference);
+		}
+		free(image);
+	}
+	printf("%d failed\n", failures);
+
+	clear_scene();
+	for (i = 0; i < 2; i++)
+		if (g_two048_fonts[i] != NULL)
+			hw_text_font_free(g_two048_fonts[i]);
+	ei_app_free();
+
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -201,7 +201,7 @@ void test_button(ei_surface_t surface, ei_rect_t *clipper) {
         ei_rect_t rect; rect.top_left = pt_rect ; rect.size = taille;
         ei_relief_t relief = ei_relief_sunken;
         draw_button(surface, text, font, text_color, clipper,
-                    rect, inside_color, rayon, relief, EI_FALSE);
+                    rect, inside_color, rayon, relief, NULL, ei_anc_center);
 }
 
 void test_toplevel (ei_surface_t surface, ei_rect_t *clipper) {
@@ -213,7 +213,7 @@ void test_toplevel (ei_surface_t surface, ei_rect_t *clipper) {
         ei_point_t pt_rect; pt_rect.x = 200; pt_rect.y = 400;
         ei_rect_t rect; rect.top_left = pt_rect ; rect.size = taille;
         draw_toplevel(surface, text, font, text_color, clipper,
-                    rect, inside_color, EI_FALSE, 5);
+                    rect, inside_color, 5);
 }
 
 /*
@@ -15,6 +15,8 @@
 #include "ei_widget.h"
 #include "ei_utils.h"
 #include "ei_event.h"
+#include "ei_grid.h"
+#include "ei_image_cache.h"
 
 
 static const int		k_tile_size			= 128;
@@ -40,11 +42,6 @@ typedef struct puzzle_t {
 
 } puzzle_t;
 
-static inline ei_point_t place_coordinates(ei_point_t pos)
-{
-	return ei_point(pos.x*k_tile_size, pos.y*k_tile_size);
-}
-
 static inline ei_bool_t valid(puzzle_t* puzzle, ei_point_t position)
 {
 	return 	(position.x >= 0) &&
@@ -75,7 +72,6 @@ void handle_tile_press(ei_widget_t* widget, ei_event_t* event, void* user_param)
 	ei_point_t	offsets[]	= {{0, -1}, {-1, 0}, {1, 0}, {0, 1}};
 	ei_point_t	current		= tile->current_position;
 	ei_point_t	swap_pos;
-	ei_point_t	swap_coordinates;
 	int		i;
 	
 	for (i = 0; i < 4; i++) {
@@ -84,9 +80,7 @@ void handle_tile_press(ei_widget_t* widget, ei_event_t* event, void* user_param)
 			puzzle->current[index_at(puzzle, current)]	= NULL;
 			puzzle->current[index_at(puzzle, swap_pos)]	= tile;
 			tile->current_position				= swap_pos;
-			swap_coordinates				= place_coordinates(swap_pos);
-			ei_place(tile->button, NULL, &(swap_coordinates.x), &(swap_coordinates.y),
-									NULL, NULL, NULL, NULL, NULL, NULL);
+			ei_grid(tile->button, &(swap_pos.y), &(swap_pos.x), NULL);
 		}
 	}
 }
@@ -102,7 +96,6 @@ void create_puzzle_window(char* image_filename)
 	ei_size_t		image_size;
 	int			x, y;
 	int			border_width		= 2;
-	ei_point_t		place_coords;
 	ei_point_t		current_position;
 	ei_size_t		n;
 	ei_size_t		toplevel_size;
@@ -123,7 +116,7 @@ void create_puzzle_window(char* image_filename)
 	puzzle_t*		puzzle;
 	tile_t*			tile;
 
-	image		= hw_image_load(image_filename, ei_app_root_surface());
+	image		= ei_image_cache_load(image_filename, ei_app_root_surface());
 	image_size	= hw_surface_get_size(image);
 	n		= ei_size(image_size.width / k_tile_size, image_size.height / k_tile_size);
 
@@ -155,8 +148,7 @@ void create_puzzle_window(char* image_filename)
 			tile			= tile_memory_at(puzzle, ei_point(x, y));
 			ei_button_configure(button, &tile_size, &grey, &border_width, &corner_radius, &relief, NULL, NULL, NULL,
 								NULL, &image, &img_rect_ptr, NULL, &callback, (void*)&tile);
-			place_coords		= place_coordinates(current_position);
-			ei_place(button, NULL, &(place_coords.x), &(place_coords.y), NULL, NULL, NULL, NULL, NULL, NULL);
+			ei_grid(button, &y, &x, NULL);
 
 			tile->puzzle		= puzzle;
 			tile->button		= button;
@@ -167,7 +159,7 @@ void create_puzzle_window(char* image_filename)
 		}
 	}
 
-	hw_surface_free(image);
+	ei_image_cache_release(image);
 }
 
 
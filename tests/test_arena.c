@@ -0,0 +1,116 @@
+//
+//  test_arena.c
+//  Checks that a steady-state redraw of the whole window does not call malloc: the temporaries
+//  of the drawing (clippers, points, sides, damaged rectangles) come from the frame arena.
+//
+//  The allocations are counted by the -Wl,--wrap=malloc counter of bench_utils. The scene has
+//  no text (hence no toplevel and its title): text surfaces are created by the hardware layer at
+//  each draw.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_arena.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+
+#include "bench_utils.h"
+
+#define GRID_SIDE	8
+
+
+
+/* Cadres en relief et boutons arrondis, imbriqués. */
+static void build_scene(void)
+{
+	ei_widget_t*			root			= ei_app_root_widget();
+	ei_widget_t*			container;
+	ei_widget_t*			frame;
+	ei_widget_t*			button;
+	ei_color_t			frame_color		= {0x60, 0x80, 0xa0, 0xff};
+	ei_color_t			button_color		= {0xa0, 0x60, 0x40, 0xff};
+	ei_relief_t			raised			= ei_relief_raised;
+	ei_relief_t			sunken			= ei_relief_sunken;
+	int				border			= 3;
+	int				corner			= 8;
+	float				rel_size		= 1.0f / GRID_SIDE;
+	float				rel_x, rel_y;
+	int				x = 20, y = 20, width = 300, height = 200;
+	int				i, j;
+
+	frame				= ei_widget_create("frame", root, NULL, NULL);
+	ei_frame_configure(frame, NULL, &frame_color, &border, &raised, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+	ei_place(frame, NULL, &x, &y, &width, &height, NULL, NULL, NULL, NULL);
+
+	container			= ei_widget_create("frame", root, NULL, NULL);
+	ei_frame_configure(container, NULL, &frame_color, &border, &raised, NULL, NULL, NULL, NULL, NULL, NULL,
+			   NULL);
+	x				= 200;
+	y				= 100;
+	width				= 500;
+	height				= 400;
+	ei_place(container, NULL, &x, &y, &width, &height, NULL, NULL, NULL, NULL);
+
+	for (i = 0; i < GRID_SIDE; i++) {
+		for (j = 0; j < GRID_SIDE; j++) {
+			rel_x			= i * rel_size;
+			rel_y			= j * rel_size;
+			frame			= ei_widget_create("frame", container, NULL, NULL);
+			ei_frame_configure(frame, NULL, &frame_color, &border, &sunken, NULL, NULL, NULL, NULL, NULL,
+					   NULL, NULL);
+			ei_place(frame, NULL, NULL, NULL, NULL, NULL, &rel_x, &rel_y, &rel_size, &rel_size);
+
+			button			= ei_widget_create("button", frame, NULL, NULL);
+			ei_button_configure(button, NULL, &button_color, &border, &corner, &raised, NULL, NULL, NULL,
+					    NULL, NULL, NULL, NULL, NULL, NULL);
+			x			= 4;
+			y			= 4;
+			width			= 40;
+			height			= 30;
+			ei_place(button, NULL, &x, &y, &width, &height, NULL, NULL, NULL, NULL);
+		}
+	}
+}
+
+/* Dessine toute la fenêtre une fois : ei_app_run rend la main après la première frame. */
+static void redraw(void)
+{
+	ei_app_quit_request();
+	ei_app_run();
+}
+
+int main(int argc, char* argv[])
+{
+	long				allocs;
+	size_t				arena_blocks;
+
+	bench_set_headless();
+	ei_app_create(ei_size(800, 600), EI_FALSE);
+	ei_app_set_max_fps(0);
+	if (bench_alloc_count() < 0) {
+		printf("skipped (link with -Wl,--wrap=malloc and define BENCH_WRAP_MALLOC)\n");
+		ei_app_free();
+		return (EXIT_SUCCESS);
+	}
+	build_scene();
+
+	// Première frame : mise en place (arène, pile des clippers, tables)
+	redraw();
+
+	allocs				= bench_alloc_count();
+	arena_blocks			= ei_arena_malloc_count();
+	redraw();
+	allocs				= bench_alloc_count() - allocs;
+	printf("allocations during the second full redraw: %ld (arena blocks: %zu)\n", allocs,
+	       ei_arena_malloc_count() - arena_blocks);
+	assert(allocs == 0);
+	assert(ei_arena_malloc_count() == arena_blocks);
+
+	ei_app_free();
+	return (EXIT_SUCCESS);
+}
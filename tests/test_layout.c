@@ -0,0 +1,183 @@
+//
+//  test_layout.c
+//  Checks the layout stage run at the beginning of each frame (see ei_placer_flush): moving and
+//  resizing a toplevel, as toplevel_handlefunc does, recomputes or translates the
+//  screen_location of its descendants, and invalidates a single rectangle per changed widget,
+//  the union of its old and new locations.
+//
+//  The invalidated rectangles are recorded by wrapping ei_app_invalidate_rect
+//  (-Wl,--wrap=ei_app_invalidate_rect).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_placer.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+
+#include "bench_utils.h"
+
+#define MAX_RECTS	16
+
+static ei_rect_t		g_rects[MAX_RECTS];
+static int			g_rect_count		= 0;
+
+void	__real_ei_app_invalidate_rect	(ei_rect_t* rect);
+
+void __wrap_ei_app_invalidate_rect(ei_rect_t* rect)
+{
+	if (g_rect_count < MAX_RECTS)
+		g_rects[g_rect_count]	= *rect;
+	g_rect_count++;
+	__real_ei_app_invalidate_rect(rect);
+}
+
+
+
+static ei_bool_t same_rect(ei_rect_t a, ei_rect_t b)
+{
+	return (ei_bool_t)(a.top_left.x == b.top_left.x && a.top_left.y == b.top_left.y &&
+			   a.size.width == b.size.width && a.size.height == b.size.height);
+}
+
+static ei_rect_t union_rect(ei_rect_t a, ei_rect_t b)
+{
+	int				x0			= (a.top_left.x < b.top_left.x) ? a.top_left.x : b.top_left.x;
+	int				y0			= (a.top_left.y < b.top_left.y) ? a.top_left.y : b.top_left.y;
+	int				x1			= a.top_left.x + a.size.width;
+	int				y1			= a.top_left.y + a.size.height;
+
+	if (b.top_left.x + b.size.width > x1)
+		x1			= b.top_left.x + b.size.width;
+	if (b.top_left.y + b.size.height > y1)
+		y1			= b.top_left.y + b.size.height;
+	return ei_rect(ei_point(x0, y0), ei_size(x1 - x0, y1 - y0));
+}
+
+/* Vérifie qu'un seul rectangle a été invalidé depuis le dernier appel, et que c'est "expected". */
+static void check_damage(const char* step, ei_rect_t expected)
+{
+	printf("%-16s %d rect(s)", step, g_rect_count);
+	if (g_rect_count > 0)
+		printf(", first (%d, %d) %dx%d", g_rects[0].top_left.x, g_rects[0].top_left.y,
+		       g_rects[0].size.width, g_rects[0].size.height);
+	printf("\n");
+	assert(g_rect_count == 1);
+	assert(same_rect(g_rects[0], expected));
+	g_rect_count			= 0;
+}
+
+/* Vérifie la place d'un enfant : décalage fixe, ou fraction de la zone de contenu du parent. */
+static void check_child(const ei_widget_t* child, ei_rect_t expected)
+{
+	assert(same_rect(child->screen_location, expected));
+}
+
+int main(int argc, char* argv[])
+{
+	ei_widget_t*			root;
+	ei_widget_t*			toplevel;
+	ei_widget_t*			fixed;
+	ei_widget_t*			half;
+	ei_widget_t*			inner;
+	ei_size_t			toplevel_size		= {300, 200};
+	ei_rect_t			content;
+	ei_rect_t			old;
+	ei_rect_t			old_fixed;
+	float				rel_half		= 0.5f;
+	int				x, y, width, height;
+
+	bench_set_headless();
+	ei_app_create(ei_size(800, 600), EI_FALSE);
+	root				= ei_app_root_widget();
+
+	// Un toplevel, un enfant placé en absolu, un enfant placé en relatif et son propre enfant
+	toplevel			= ei_widget_create("toplevel", root, NULL, NULL);
+	ei_toplevel_configure(toplevel, &toplevel_size, NULL, NULL, NULL, NULL, NULL, NULL);
+	x				= 100;
+	y				= 80;
+	ei_place(toplevel, NULL, &x, &y, NULL, NULL, NULL, NULL, NULL, NULL);
+
+	fixed				= ei_widget_create("frame", toplevel, NULL, NULL);
+	x				= 10;
+	y				= 10;
+	width				= 50;
+	height				= 40;
+	ei_place(fixed, NULL, &x, &y, &width, &height, NULL, NULL, NULL, NULL);
+
+	half				= ei_widget_create("frame", toplevel, NULL, NULL);
+	ei_place(half, NULL, NULL, NULL, NULL, NULL, &rel_half, &rel_half, &rel_half, &rel_half);
+
+	inner				= ei_widget_create("frame", half, NULL, NULL);
+	x				= 5;
+	y				= 5;
+	width				= 20;
+	height				= 20;
+	ei_place(inner, NULL, &x, &y, &width, &height, NULL, NULL, NULL, NULL);
+
+	ei_placer_flush();
+	g_rect_count			= 0;
+
+	// Déplacement du toplevel : les enfants sont translatés, un seul rectangle (ancien ∪ nouveau)
+	old				= toplevel->screen_location;
+	x				= 150;
+	y				= 120;
+	ei_place(toplevel, NULL, &x, &y, NULL, NULL, NULL, NULL, NULL, NULL);
+	// Plusieurs ei_place par évènement : une seule mise à jour par frame
+	x				= 160;
+	y				= 130;
+	ei_place(toplevel, NULL, &x, &y, NULL, NULL, NULL, NULL, NULL, NULL);
+	ei_placer_flush();
+	assert(toplevel->screen_location.top_left.x == 160 && toplevel->screen_location.top_left.y == 130);
+	check_damage("move toplevel", union_rect(old, toplevel->screen_location));
+	content				= *toplevel->content_rect;
+	check_child(fixed, ei_rect(ei_point(content.top_left.x + 10, content.top_left.y + 10), ei_size(50, 40)));
+	check_child(half, ei_rect(ei_point(content.top_left.x + content.size.width / 2,
+					   content.top_left.y + content.size.height / 2),
+				  ei_size(content.size.width / 2, content.size.height / 2)));
+	check_child(inner, ei_rect(ei_point(half->content_rect->top_left.x + 5, half->content_rect->top_left.y + 5),
+				   ei_size(20, 20)));
+
+	// Redimensionnement du toplevel : l'enfant relatif est recalculé, l'absolu reste en place
+	old				= toplevel->screen_location;
+	old_fixed			= fixed->screen_location;
+	width				= 400;
+	height				= 300;
+	ei_place(toplevel, NULL, NULL, NULL, &width, &height, NULL, NULL, NULL, NULL);
+	ei_placer_flush();
+	check_damage("resize toplevel", union_rect(old, toplevel->screen_location));
+	content				= *toplevel->content_rect;
+	assert(content.size.width > toplevel_size.width && content.size.height > toplevel_size.height);
+	check_child(fixed, old_fixed);
+	check_child(half, ei_rect(ei_point(content.top_left.x + content.size.width / 2,
+					   content.top_left.y + content.size.height / 2),
+				  ei_size(content.size.width / 2, content.size.height / 2)));
+	check_child(inner, ei_rect(ei_point(half->content_rect->top_left.x + 5, half->content_rect->top_left.y + 5),
+				   ei_size(20, 20)));
+
+	// Déplacement d'un enfant seul : son rectangle, limité au contenu du toplevel
+	old				= fixed->screen_location;
+	x				= 30;
+	y				= 20;
+	ei_place(fixed, NULL, &x, &y, NULL, NULL, NULL, NULL, NULL, NULL);
+	ei_placer_flush();
+	check_damage("move child", union_rect(old, fixed->screen_location));
+	check_child(fixed, ei_rect(ei_point(content.top_left.x + 30, content.top_left.y + 20), ei_size(50, 40)));
+
+	// Sans changement, la passe suivante n'invalide rien
+	ei_placer_flush();
+	assert(g_rect_count == 0);
+
+	// Une frame complète dessine la nouvelle géométrie
+	ei_app_quit_request();
+	ei_app_run();
+
+	ei_app_free();
+	printf("ok\n");
+	return (EXIT_SUCCESS);
+}
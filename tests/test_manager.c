@@ -0,0 +1,164 @@
+//
+//  test_manager.c
+//  Checks the grid and pack geometry managers when a managed widget is destroyed before the
+//  first layout pass, i.e. before the manager has placed it: the manager must forget it, and the
+//  next pass must lay out the remaining widgets only.
+//
+//  The managed widgets are of a class defined here, whose releasefunc does not call the placer
+//  (unlike the frame, button and toplevel classes) and whose widgets are released with free().
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_grid.h"
+#include "ei_pack.h"
+#include "ei_placer.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+#include "ei_widget.h"
+#include "ei_widgetclass.h"
+
+#include "bench_utils.h"
+
+
+
+static ei_widget_t* plain_allocfunc(void)
+{
+	return calloc(1, sizeof(ei_widget_t));
+}
+
+static void plain_releasefunc(ei_widget_t* widget)
+{
+}
+
+static void plain_drawfunc(ei_widget_t* widget, ei_surface_t surface, ei_surface_t pick_surface, ei_rect_t* clipper)
+{
+}
+
+static void plain_setdefaultsfunc(ei_widget_t* widget)
+{
+}
+
+static void plain_geomnotifyfunc(ei_widget_t* widget, ei_rect_t rect)
+{
+}
+
+static ei_bool_t plain_handlefunc(ei_widget_t* widget, struct ei_event_t* event)
+{
+	return EI_FALSE;
+}
+
+/* Classe minimale, libérée par ei_app_free comme les classes de la bibliothèque. */
+static void register_plain_class(void)
+{
+	ei_widgetclass_t*		plain			= calloc(1, sizeof(ei_widgetclass_t));
+
+	strcpy(plain->name, "plain");
+	plain->allocfunc		= &plain_allocfunc;
+	plain->releasefunc		= &plain_releasefunc;
+	plain->drawfunc			= &plain_drawfunc;
+	plain->setdefaultsfunc		= &plain_setdefaultsfunc;
+	plain->geomnotifyfunc		= &plain_geomnotifyfunc;
+	plain->handlefunc		= &plain_handlefunc;
+	ei_widgetclass_register(plain);
+}
+
+/* Crée un widget de la classe "plain", de taille demandée "size", enfant de "parent". */
+static ei_widget_t* create_plain(ei_widget_t* parent, ei_size_t size)
+{
+	ei_widget_t*			widget			= ei_widget_create("plain", parent, NULL, NULL);
+
+	widget->requested_size		= size;
+	return widget;
+}
+
+/* Crée un conteneur placé en absolu dans la racine. */
+static ei_widget_t* create_container(int x, int y)
+{
+	ei_widget_t*			container		= ei_widget_create("frame", ei_app_root_widget(), NULL, NULL);
+	int				width			= 300;
+	int				height			= 300;
+
+	ei_place(container, NULL, &x, &y, &width, &height, NULL, NULL, NULL, NULL);
+	return container;
+}
+
+static void check_location(const ei_widget_t* widget, const ei_widget_t* container, int x, int y, ei_size_t size)
+{
+	ei_point_t			origin			= container->content_rect->top_left;
+
+	assert(widget->placer_params != NULL);
+	assert(widget->screen_location.top_left.x == origin.x + x);
+	assert(widget->screen_location.top_left.y == origin.y + y);
+	assert(widget->screen_location.size.width == size.width);
+	assert(widget->screen_location.size.height == size.height);
+}
+
+static void test_grid(void)
+{
+	ei_widget_t*			container		= create_container(10, 10);
+	ei_widget_t*			cells[3];
+	ei_widget_t*			reused;
+	ei_size_t			size			= {50, 30};
+	int				rows[3]			= {0, 0, 1};
+	int				columns[3]		= {0, 1, 0};
+	int				i;
+
+	for (i = 0; i < 3; i++) {
+		cells[i]		= create_plain(container, size);
+		ei_grid(cells[i], &rows[i], &columns[i], NULL);
+	}
+
+	// Détruit avant d'avoir été placé par la grille, puis mémoire réutilisée par un widget hors grille
+	ei_widget_destroy(cells[1]);
+	reused				= create_plain(ei_app_root_widget(), size);
+	ei_placer_flush();
+
+	assert(reused->placer_params == NULL);
+	check_location(cells[0], container, 0, 0, size);
+	check_location(cells[2], container, 0, 30, size);
+	printf("grid ok\n");
+}
+
+static void test_pack(void)
+{
+	ei_widget_t*			container		= create_container(400, 10);
+	ei_widget_t*			stacked[3];
+	ei_widget_t*			reused;
+	int				heights[3]		= {20, 30, 40};
+	int				i;
+
+	for (i = 0; i < 3; i++) {
+		stacked[i]		= create_plain(container, ei_size(60, heights[i]));
+		ei_pack(stacked[i], NULL);
+	}
+
+	ei_widget_destroy(stacked[1]);
+	reused				= create_plain(ei_app_root_widget(), ei_size(60, 30));
+	ei_placer_flush();
+
+	assert(reused->placer_params == NULL);
+	check_location(stacked[0], container, 0, 0, ei_size(60, 20));
+	check_location(stacked[2], container, 0, 20, ei_size(60, 40));
+	printf("pack ok\n");
+}
+
+int main(int argc, char* argv[])
+{
+	bench_set_headless();
+	ei_app_create(ei_size(800, 600), EI_FALSE);
+	register_plain_class();
+
+	test_grid();
+	test_pack();
+
+	ei_app_quit_request();
+	ei_app_run();
+	ei_app_free();
+	return (EXIT_SUCCESS);
+}
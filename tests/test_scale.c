@@ -0,0 +1,138 @@
+//
+//  test_scale.c
+//  Checks that the SSE2/AVX2 loops of ei_scale give exactly the pixels of the scalar loops, for
+//  the box and bilinear filters and for the halving, at odd sizes (so that the vector loops
+//  leave a remainder to the scalar ones). Also checks that the box filter does not overflow
+//  when a pixel of the result covers a very large block of the source.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "ei_draw.h"
+#include "ei_scale.h"
+#include "ei_types.h"
+#include "ei_utils.h"
+
+#define PADDING		3	// Pixels en fin de ligne : les pas ne sont pas égaux aux largeurs
+
+
+
+/* Pixels pseudo-aléatoires, reproductibles. */
+static uint32_t* random_pixels(ei_size_t size, int stride)
+{
+	uint32_t*			pixels			= malloc((size_t)stride * size.height * sizeof(uint32_t));
+	uint32_t			state			= 0x12345678;
+	int				i;
+
+	for (i = 0; i < stride * size.height; i++) {
+		state			= state * 1664525 + 1013904223;
+		pixels[i]		= state;
+	}
+	return pixels;
+}
+
+/* Compare le résultat des boucles vectorielles et scalaires. Retourne le nombre de pixels différents. */
+static int compare_scale(ei_size_t src_size, ei_size_t dst_size, ei_filter_t filter)
+{
+	int				src_stride		= src_size.width + PADDING;
+	int				dst_stride		= dst_size.width + PADDING;
+	size_t				dst_length		= (size_t)dst_stride * dst_size.height;
+	uint32_t*			src			= random_pixels(src_size, src_stride);
+	uint32_t*			simd			= calloc(dst_length, sizeof(uint32_t));
+	uint32_t*			scalar			= calloc(dst_length, sizeof(uint32_t));
+	int				differences		= 0;
+	int				x, y;
+
+	ei_scale_set_simd(EI_TRUE);
+	ei_scale_pixels(simd, dst_stride, dst_size, src, src_stride, src_size, filter);
+	ei_scale_set_simd(EI_FALSE);
+	ei_scale_pixels(scalar, dst_stride, dst_size, src, src_stride, src_size, filter);
+	ei_scale_set_simd(EI_TRUE);
+
+	for (y = 0; y < dst_size.height; y++)
+		for (x = 0; x < dst_size.width; x++)
+			differences	+= (simd[y * dst_stride + x] != scalar[y * dst_stride + x]);
+	printf("%-8s %4dx%-4d -> %4dx%-4d %s\n", (filter == ei_filter_box) ? "box" : "bilinear",
+	       src_size.width, src_size.height, dst_size.width, dst_size.height, (differences == 0) ? "ok" : "FAILED");
+
+	free(src);
+	free(simd);
+	free(scalar);
+	return differences;
+}
+
+static int compare_halve(ei_size_t src_size)
+{
+	ei_size_t			dst_size		= ei_scale_half_size(src_size);
+	int				src_stride		= src_size.width + PADDING;
+	int				dst_stride		= dst_size.width + PADDING;
+	size_t				dst_length		= (size_t)dst_stride * dst_size.height;
+	uint32_t*			src			= random_pixels(src_size, src_stride);
+	uint32_t*			simd			= calloc(dst_length, sizeof(uint32_t));
+	uint32_t*			scalar			= calloc(dst_length, sizeof(uint32_t));
+	int				differences		= 0;
+	int				x, y;
+
+	ei_scale_set_simd(EI_TRUE);
+	ei_scale_halve(simd, dst_stride, src, src_stride, src_size);
+	ei_scale_set_simd(EI_FALSE);
+	ei_scale_halve(scalar, dst_stride, src, src_stride, src_size);
+	ei_scale_set_simd(EI_TRUE);
+
+	for (y = 0; y < dst_size.height; y++)
+		for (x = 0; x < dst_size.width; x++)
+			differences	+= (simd[y * dst_stride + x] != scalar[y * dst_stride + x]);
+	printf("%-8s %4dx%-4d -> %4dx%-4d %s\n", "halve", src_size.width, src_size.height, dst_size.width,
+	       dst_size.height, (differences == 0) ? "ok" : "FAILED");
+
+	free(src);
+	free(simd);
+	free(scalar);
+	return differences;
+}
+
+int main(int argc, char* argv[])
+{
+	static const int		sizes[][4]		= {
+		{37, 23, 13, 7},	// Réduction
+		{101, 77, 50, 31},
+		{513, 9, 17, 3},
+		{5, 3, 37, 29},		// Agrandissement
+		{3, 5, 1, 1},
+		{1, 1, 9, 7},
+		{255, 129, 129, 255},	// Réduction d'un côté, agrandissement de l'autre
+		{1021, 769, 33, 25}	// Plusieurs moitiés avant le filtre bilinéaire
+	};
+	static const int		halves[][2]		= {{37, 23}, {2, 2}, {3, 1}, {1, 7}, {1023, 5}};
+	int				failures		= 0;
+	int				i;
+	uint32_t			white			= 0xffffffff;
+	uint32_t			result			= 0;
+
+	for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+		failures		+= compare_scale(ei_size(sizes[i][0], sizes[i][1]), ei_size(sizes[i][2], sizes[i][3]),
+							 ei_filter_box);
+		failures		+= compare_scale(ei_size(sizes[i][0], sizes[i][1]), ei_size(sizes[i][2], sizes[i][3]),
+							 ei_filter_bilinear);
+	}
+	for (i = 0; i < (int)(sizeof(halves) / sizeof(halves[0])); i++)
+		failures		+= compare_halve(ei_size(halves[i][0], halves[i][1]));
+	assert(failures == 0);
+
+	// 8192x8192 pixels blancs (une seule ligne répétée : pas de 0) réduits à un pixel
+	{
+		uint32_t*		row			= malloc(8192 * sizeof(uint32_t));
+
+		for (i = 0; i < 8192; i++)
+			row[i]		= white;
+		ei_scale_pixels(&result, 1, ei_size(1, 1), row, 0, ei_size(8192, 8192), ei_filter_box);
+		printf("box      8192x8192 -> 1x1       %08x\n", result);
+		assert(result == white);
+		free(row);
+	}
+
+	return (EXIT_SUCCESS);
+}
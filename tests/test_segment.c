@@ -27,7 +27,7 @@ int main(int argc, char* argv[])
 	p1.next = &p2;
 	p2.next = &p3;
 	const ei_linked_point_t *p = &p1;
-	ei_side_table tc = construct_side_table(main_window, p);
+	ei_side_table tc = construct_side_table(hw_surface_get_size(main_window).height, p);
 	// TODO: vérifier pourquoi ça fait false ici
 	// assert((tc.array[1]->ymax == 3 && tc.array[1]->x_ymin == 9 && tc.array[1]->next->ymax == 5 && tc.array[1]->next->x_ymin == 9));
 	assert((tc.array[2] == NULL));
@@ -92,30 +92,31 @@ int main(int argc, char* argv[])
         point = find_intersection(y, &se5);
         assert((point.x == 3 && point.y == 2 && se5.E == 0));
 
-        // Test widget_dir
-	struct dir* my_dir = get_widget_dir();
+        // Test widget class registry
 
 	ei_widgetclass_t *frame_class = malloc(sizeof(ei_widgetclass_t));
 	*frame_class = ei_init_frame_class();
 	ei_widgetclass_register(frame_class);
-	assert((dir_lookup_num(my_dir, "frame") == frame_class));
+	assert((ei_class_registry_lookup("frame") == frame_class));
 
 	ei_widgetclass_t *button_class = malloc(sizeof(ei_widgetclass_t));
 	*button_class = ei_init_button_class();
 	ei_widgetclass_register(button_class);
-	assert((dir_lookup_num(my_dir, "button") == button_class));
+	assert((ei_class_registry_lookup("button") == button_class));
 
 	ei_widgetclass_t *toplevel_class = malloc(sizeof(ei_widgetclass_t));
 	*toplevel_class = ei_init_toplevel_class();
 	ei_widgetclass_register(toplevel_class);
-	assert((dir_lookup_num(my_dir, "toplevel") == toplevel_class));
+	assert((ei_class_registry_lookup("toplevel") == toplevel_class));
 
-	assert((dir_lookup_num(my_dir, "frame")->next == button_class));
-	assert((dir_lookup_num(my_dir, "button")->next == toplevel_class));
-	assert((dir_lookup_num(my_dir, "toplevel")->next == NULL));
-	assert((dir_lookup_num(my_dir, "bloublibla") == NULL));
+	assert((ei_class_registry_lookup("frame")->next == button_class));
+	assert((ei_class_registry_lookup("button")->next == toplevel_class));
+	assert((ei_class_registry_lookup("toplevel")->next == NULL));
+	assert((ei_class_registry_lookup("bloublibla") == NULL));
 
-	free_widget_dir();
+	assert((ei_widgetclass_get_handle("button") == button_class));
+
+	free_widgetclass_registry();
 	assert((strcmp(frame_class->name, "frame") != 0));
 	assert((strcmp(button_class->name, "button") != 0));
 	assert((strcmp(toplevel_class->name, "toplevel") != 0));